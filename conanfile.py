@@ -2,6 +2,7 @@ from conan import ConanFile
 from conan.tools.microsoft import is_msvc, is_msvc_static_runtime
 from conan.tools.cmake import CMake, CMakeToolchain, CMakeDeps, cmake_layout
 from conan.tools.files import copy
+from conan.errors import ConanInvalidConfiguration
 
 import os
 import io
@@ -14,6 +15,8 @@ class MTConnectAgentConan(ConanFile):
     license = "Apache License 2.0"
     settings = "os", "compiler", "arch", "build_type"
     options = { "without_ipv6": [True, False],
+                "without_hot_path_scopes": [True, False],
+                "with_io_uring": [True, False],
                 "with_ruby": [True, False], 
                  "development" : [True, False],
                  "shared": [True, False],
@@ -32,6 +35,8 @@ class MTConnectAgentConan(ConanFile):
     build_policy = "missing"
     default_options = {
         "without_ipv6": False,
+        "without_hot_path_scopes": False,
+        "with_io_uring": False,
         "with_ruby": True,
         "development": False,
         "shared": False,
@@ -79,6 +84,8 @@ class MTConnectAgentConan(ConanFile):
             raise ConanInvalidConfiguration("Shared can only be built with DLL runtime.")
         if "libcxx" in self.settings.compiler.fields and self.settings.compiler.libcxx == "libstdc++":
             raise ConanInvalidConfiguration("This package is only compatible with libstdc++11, add -s compiler.libcxx=libstdc++11")
+        if self.options.with_io_uring and self.settings.os != "Linux":
+            raise ConanInvalidConfiguration("io_uring is only available on Linux")
 
     def layout(self):
         self.folders.build_folder_vars = ["options.shared", "settings.arch"]
@@ -122,7 +129,11 @@ class MTConnectAgentConan(ConanFile):
         self.requires("rapidjson/cci.20230929", headers=True, libs=False, transitive_headers=True, transitive_libs=False)
         self.requires("mqtt_cpp/13.2.2", headers=True, libs=False, transitive_headers=True, transitive_libs=False)
         self.requires("bzip2/1.0.8", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
+        self.requires("zlib/1.3.1", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
         
+        if self.options.with_io_uring:
+            self.requires("liburing/2.6", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
+
         if self.options.with_ruby:
             self.requires("mruby/3.4.0", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
 
@@ -176,6 +187,8 @@ class MTConnectAgentConan(ConanFile):
         tc.cache_variables['WITH_RUBY'] = self.options.with_ruby.__bool__()
         tc.cache_variables['AGENT_WITH_DOCS'] = self.options.with_docs.__bool__()
         tc.cache_variables['AGENT_WITHOUT_IPV6'] = self.options.without_ipv6.__bool__()
+        tc.cache_variables['AGENT_WITHOUT_HOT_PATH_SCOPES'] = self.options.without_hot_path_scopes.__bool__()
+        tc.cache_variables['AGENT_WITH_IO_URING'] = self.options.with_io_uring.__bool__()
         tc.cache_variables['DEVELOPMENT'] = self.options.development.__bool__()
         if self.options.agent_prefix:
             tc.cache_variables['AGENT_PREFIX'] = self.options.agent_prefix
@@ -219,6 +232,9 @@ class MTConnectAgentConan(ConanFile):
             self.cpp_info.defines.append("WITH_RUBY=1")
         if self.options.without_ipv6:
             self.cpp_info.defines.append("AGENT_WITHOUT_IPV6=1")
+        if self.options.with_io_uring:
+            self.cpp_info.defines.append("BOOST_ASIO_HAS_IO_URING=1")
+            self.cpp_info.defines.append("BOOST_ASIO_DISABLE_EPOLL=1")
         if self.options.shared:
             self.cpp_info.defines.append("SHARED_AGENT_LIB=1")
             self.cpp_info.defines.append("BOOST_ALL_DYN_LINK")
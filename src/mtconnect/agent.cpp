@@ -49,14 +49,17 @@
 #include "mtconnect/asset/fixture.hpp"
 #include "mtconnect/asset/pallet.hpp"
 #include "mtconnect/asset/part.hpp"
+#include "mtconnect/asset/persistent_asset_storage.hpp"
 #include "mtconnect/asset/process.hpp"
 #include "mtconnect/asset/qif_document.hpp"
 #include "mtconnect/asset/raw_material.hpp"
 #include "mtconnect/asset/task.hpp"
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/device_model/agent_device.hpp"
+#include "mtconnect/device_model/path_evaluator.hpp"
 #include "mtconnect/entity/xml_parser.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/observation/observation.hpp"
 #include "mtconnect/printer/json_printer.hpp"
 #include "mtconnect/printer/xml_printer.hpp"
@@ -96,6 +99,8 @@ namespace mtconnect {
   {
     using namespace asset;
 
+    metrics::Registry::setEnabled(IsOptionSet(options, config::EnableMetrics));
+
     CuttingToolArchetype::registerAsset();
     CuttingTool::registerAsset();
     FileArchetypeAsset::registerAsset();
@@ -112,11 +117,33 @@ namespace mtconnect {
     Task::registerAsset();
     TaskArchetype::registerAsset();
 
-    m_assetStorage = make_unique<AssetBuffer>(
-        GetOption<int>(options, mtconnect::configuration::MaxAssets).value_or(1024));
+    auto maxAssets = GetOption<int>(options, mtconnect::configuration::MaxAssets).value_or(1024);
+    auto assetPath = GetOption<string>(options, config::AssetStoragePath);
+    if (assetPath && !assetPath->empty())
+      m_assetStorage = make_unique<PersistentAssetStorage>(*assetPath, maxAssets);
+    else
+      m_assetStorage = make_unique<AssetBuffer>(maxAssets);
     m_versionDeviceXml = IsOptionSet(options, mtconnect::configuration::VersionDeviceXml);
+
+    auto journalPath = GetOption<string>(options, config::JournalPath);
+    if (journalPath && !journalPath->empty())
+    {
+      m_journal = make_shared<buffer::ObservationJournal>(
+          *journalPath, ConvertFileSize(options, config::JournalSegmentSize, 64 * 1024 * 1024),
+          GetOption<Milliseconds>(options, config::JournalSyncInterval).value_or(250ms),
+          m_circularBuffer.getBufferSize());
+    }
     m_createUniqueIds = IsOptionSet(options, config::CreateUniqueIds);
 
+    auto deviceCachePath = GetOption<string>(options, config::DeviceCachePath);
+    if (deviceCachePath && !deviceCachePath->empty())
+    {
+      m_deviceCache = make_unique<parser::DeviceCache>(*deviceCachePath);
+      if (!m_deviceCache->isEnabled())
+        m_deviceCache.reset();
+    }
+    m_loadThreads = size_t(std::max(GetOption<int>(options, config::WorkerThreads).value_or(1), 1));
+
     auto jsonVersion =
         uint32_t(GetOption<int>(options, mtconnect::configuration::JsonVersion).value_or(2));
 
@@ -166,14 +193,16 @@ namespace mtconnect {
     }
 
     // For the DeviceAdded event for each device
-    for (auto device : devices)
-      addDevice(device);
+    addDevices(devices);
 
     if (m_versionDeviceXml && m_createUniqueIds)
       versionDeviceXml();
 
     loadCachedProbe();
 
+    if (m_journal)
+      recoverJournal();
+
     m_initialized = true;
 
     m_afterInitializeHooks.exec(*this);
@@ -297,6 +326,12 @@ namespace mtconnect {
     for (auto sink : m_sinks)
       sink->stop();
 
+    if (m_journal)
+    {
+      LOG(info) << "Writing observation journal";
+      m_journal->stop();
+    }
+
     LOG(info) << "Shutting down completed";
 
     m_started = false;
@@ -363,12 +398,28 @@ namespace mtconnect {
       }
     }
 
-    // Add hash to asset
+    // Add hash to asset and check if the content is the same as the stored asset
+    bool unchanged = false;
     if (m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
+    {
       asset->addHash();
+      if (!asset->isRemoved())
+      {
+        auto existing = m_assetStorage->getAsset(asset->getAssetId());
+        unchanged = existing && !existing->isRemoved() &&
+                    existing->getProperty("hash") == asset->getProperty("hash");
+      }
+    }
 
     auto old = m_assetStorage->addAsset(asset);
 
+    // The stored asset is refreshed, but sinks and observations are not updated
+    if (unchanged)
+    {
+      LOG(debug) << "Asset " << asset->getAssetId() << " has not changed";
+      return;
+    }
+
     for (auto &sink : m_sinks)
       sink->publish(asset);
 
@@ -420,7 +471,7 @@ namespace mtconnect {
     {
       // Load the configuration for the Agent
       auto devices = m_xmlParser->parseFile(
-          deviceFile, dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get()));
+          deviceFile, dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get()), m_loadThreads);
 
       if (m_xmlParser->getSchemaVersion() &&
           IntSchemaVersion(*m_xmlParser->getSchemaVersion()) != m_intSchemaVersion)
@@ -860,17 +911,39 @@ namespace mtconnect {
 
     try
     {
-      // Load the configuration for the Agent
-      auto devices = m_xmlParser->parseFile(
-          configXmlPath, dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get()));
+      auto xmlPrinter = dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get());
+
+      // Warm restarts recreate the devices from the cache if the file has not changed
+      std::optional<parser::DeviceCache::Model> model;
+      if (m_deviceCache)
+        model = m_deviceCache->load(configXmlPath);
 
-      if (!m_schemaVersion && m_xmlParser->getSchemaVersion() &&
-          !m_xmlParser->getSchemaVersion()->empty())
+      if (model)
+      {
+        for (const auto &ns : model->m_namespaces)
+          xmlPrinter->addDevicesNamespace(ns.m_urn, ns.m_location, ns.m_prefix);
+      }
+      else
       {
-        m_schemaVersion = m_xmlParser->getSchemaVersion();
+        // Load the configuration for the Agent
+        model.emplace();
+        model->m_devices = m_xmlParser->parseFile(configXmlPath, xmlPrinter, m_loadThreads);
+        model->m_schemaVersion = m_xmlParser->getSchemaVersion();
+        model->m_namespaces = m_xmlParser->getDevicesNamespaces();
+
+        // The devices are cached before the agent modifies them
+        if (m_deviceCache && !m_deviceCache->save(configXmlPath, *model))
+          LOG(warning) << "Cannot cache the devices from " << configXmlPath;
+      }
+
+      auto &devices = model->m_devices;
+      const auto &schemaVersion = model->m_schemaVersion;
+      if (!m_schemaVersion && schemaVersion && !schemaVersion->empty())
+      {
+        m_schemaVersion = schemaVersion;
         m_intSchemaVersion = IntSchemaVersion(*m_schemaVersion);
       }
-      else if (!m_schemaVersion && !m_xmlParser->getSchemaVersion())
+      else if (!m_schemaVersion && !schemaVersion)
       {
         m_schemaVersion = StrDefaultSchemaVersion();
         m_intSchemaVersion = IntSchemaVersion(*m_schemaVersion);
@@ -1014,10 +1087,45 @@ namespace mtconnect {
   }
 
   // Add the a device from a configuration file
+  void Agent::addDevices(const std::list<DevicePtr> &devices)
+  {
+    NAMED_SCOPE("Agent::addDevices");
+
+    // The devices are independent until they are added, so they are prepared in parallel and
+    // then added in the order of the list.
+    std::vector<DevicePtr> list(devices.begin(), devices.end());
+    std::vector<std::unordered_map<std::string, std::string>> idMaps(list.size());
+    ParallelFor(m_loadThreads, list.size(),
+                [&](size_t i) { idMaps[i] = prepareDevice(list[i]); });
+
+    for (size_t i = 0; i < list.size(); i++)
+      registerDevice(list[i], idMaps[i]);
+  }
+
   void Agent::addDevice(DevicePtr device)
   {
     NAMED_SCOPE("Agent::addDevice");
 
+    auto idMap = prepareDevice(device);
+    registerDevice(device, idMap);
+  }
+
+  std::unordered_map<std::string, std::string> Agent::prepareDevice(DevicePtr device)
+  {
+    // TODO: Redo Resolve Reference  with entity
+    // device->resolveReferences();
+    verifyDevice(device);
+    auto idMap = createDeviceUniqueIds(device);
+
+    if (m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
+      device->addHash();
+
+    return idMap;
+  }
+
+  void Agent::registerDevice(DevicePtr device,
+                             const std::unordered_map<std::string, std::string> &idMap)
+  {
     // Check if device already exists
     string uuid = *device->getUuid();
     auto &idx = m_deviceIndex.get<ByUuid>();
@@ -1033,11 +1141,7 @@ namespace mtconnect {
     else
     {
       m_deviceIndex.push_back(device);
-
-      // TODO: Redo Resolve Reference  with entity
-      // device->resolveReferences();
-      verifyDevice(device);
-      createUniqueIds(device);
+      updateDataItemIds(device, idMap);
 
       if (m_observationsInitialized)
       {
@@ -1060,9 +1164,6 @@ namespace mtconnect {
       }
     }
 
-    if (m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
-      device->addHash();
-
     for (auto &printer : m_printers)
       printer.second->setModelChangeTime(getCurrentTime(GMT_UV_SEC));
   }
@@ -1098,22 +1199,31 @@ namespace mtconnect {
 
   void Agent::createUniqueIds(DevicePtr device)
   {
+    updateDataItemIds(device, createDeviceUniqueIds(device));
+  }
+
+  std::unordered_map<std::string, std::string> Agent::createDeviceUniqueIds(DevicePtr device)
+  {
+    std::unordered_map<std::string, std::string> idMap;
     if (m_createUniqueIds && !dynamic_pointer_cast<AgentDevice>(device))
     {
-      std::unordered_map<std::string, std::string> idMap;
-
       device->createUniqueIds(idMap);
       device->updateReferences(idMap);
+    }
+    return idMap;
+  }
 
-      // Update the data item map.
-      for (auto &id : idMap)
+  void Agent::updateDataItemIds(DevicePtr device,
+                                const std::unordered_map<std::string, std::string> &idMap)
+  {
+    // Update the data item map.
+    for (auto &id : idMap)
+    {
+      auto di = device->getDeviceDataItem(id.second);
+      if (auto it = m_dataItemMap.find(id.first); it != m_dataItemMap.end())
       {
-        auto di = device->getDeviceDataItem(id.second);
-        if (auto it = m_dataItemMap.find(id.first); it != m_dataItemMap.end())
-        {
-          m_dataItemMap.erase(it);
-          m_dataItemMap.emplace(id.second, di);
-        }
+        m_dataItemMap.erase(it);
+        m_dataItemMap.emplace(id.second, di);
       }
     }
   }
@@ -1122,14 +1232,73 @@ namespace mtconnect {
   {
     NAMED_SCOPE("Agent::loadCachedProbe");
 
-    // Reload the document for path resolution
-    auto xmlPrinter = dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get());
-    m_xmlParser->loadDocument(xmlPrinter->printProbe(0, 0, 0, 0, 0, getDevices()));
+    // The document for xpath resolution is only regenerated when a path requires it
+    {
+      std::lock_guard<std::mutex> lock(m_probeDocumentMutex);
+      m_probeDocumentStale = true;
+    }
 
     for (auto &printer : m_printers)
       printer.second->setModelChangeTime(getCurrentTime(GMT_UV_SEC));
   }
 
+  void Agent::getDataItemsForPath(const DevicePtr device, const std::optional<std::string> &path,
+                                  FilterSet &filter,
+                                  const std::optional<std::string> &deviceType) const
+  {
+    NAMED_SCOPE("Agent::getDataItemsForPath");
+
+    string dataPath = devicesAndPath(path, device, deviceType);
+    if (auto evaluator = device_model::PathEvaluator::compile(dataPath))
+    {
+      evaluator->evaluate(getDevices(), filter);
+      return;
+    }
+
+    // Fall back to libxml2 for expressions outside of the supported subset
+    {
+      std::lock_guard<std::mutex> lock(m_probeDocumentMutex);
+      if (m_probeDocumentStale)
+      {
+        auto xmlPrinter = dynamic_cast<printer::XmlPrinter *>(m_printers.at("xml").get());
+        m_xmlParser->loadDocument(xmlPrinter->printProbe(0, 0, 0, 0, 0, getDevices()));
+        m_probeDocumentStale = false;
+      }
+    }
+
+    m_xmlParser->getDataItems(filter, dataPath);
+  }
+
+  void Agent::recoverJournal()
+  {
+    NAMED_SCOPE("Agent::recoverJournal");
+
+    auto recovery = m_journal->recover([this](const std::string &id) -> DataItemPtr {
+      for (const auto &device : m_deviceIndex)
+      {
+        const auto &idx = device->getDeviceDataItems();
+        if (auto it = idx.find(id); it != idx.end())
+          return it->lock();
+      }
+      return nullptr;
+    });
+
+    if (recovery)
+    {
+      m_instanceId = recovery->m_instanceId;
+      m_circularBuffer.restore(*recovery);
+      LOG(info) << "Restored the buffer from " << m_journal->getDirectory()
+                << ", next sequence: " << m_circularBuffer.getSequence();
+    }
+    else
+    {
+      m_instanceId = getCurrentTimeInSec();
+    }
+
+    m_journal->start(*m_instanceId);
+    m_circularBuffer.setJournal(m_journal);
+  }
+
   // ----------------------------------------------------
   // Helper Methods
   // ----------------------------------------------------
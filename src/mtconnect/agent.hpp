@@ -30,6 +30,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -45,6 +46,7 @@
 #include "mtconnect/configuration/service.hpp"
 #include "mtconnect/device_model/agent_device.hpp"
 #include "mtconnect/device_model/device.hpp"
+#include "mtconnect/parser/device_cache.hpp"
 #include "mtconnect/parser/xml_parser.hpp"
 #include "mtconnect/pipeline/pipeline.hpp"
 #include "mtconnect/pipeline/pipeline_contract.hpp"
@@ -168,6 +170,9 @@ namespace mtconnect {
     ///        get latest and historical data.
     /// @return A const reference to the circular buffer
     const auto &getCircularBuffer() const { return m_circularBuffer; }
+    /// @brief Get the instance id restored from the observation journal
+    /// @return The instance id if the agent has an observation journal
+    const auto &getInstanceId() const { return m_instanceId; }
 
     /// @brief Adds an adapter to the agent
     /// @param[in] source: shared pointer to the source being added
@@ -439,6 +444,20 @@ namespace mtconnect {
     std::string devicesAndPath(const std::optional<std::string> &path, const DevicePtr device,
                                const std::optional<std::string> &deviceType = std::nullopt) const;
 
+    /// @brief Find the data items selected by a path
+    ///
+    /// Paths within the subset supported by `device_model::PathEvaluator` are evaluated directly
+    /// against the device model. Other paths are evaluated with libxml2 against the probe
+    /// document, which is regenerated if the device model has changed.
+    ///
+    /// @param[in] device Optional device if one device is specified
+    /// @param[in] path Optional path to prefix
+    /// @param[out] filter the data item ids
+    /// @param[in] deviceType optional Agent or Device selector
+    void getDataItemsForPath(const DevicePtr device, const std::optional<std::string> &path,
+                             FilterSet &filter,
+                             const std::optional<std::string> &deviceType = std::nullopt) const;
+
     /// @brief Creates unique ids for the device model and maps to the originals
     ///
     /// Also updates the agents data item map by adding the new ids. Duplicate original
@@ -457,10 +476,18 @@ namespace mtconnect {
     // Initialization methods
     void createAgentDevice();
     std::list<device_model::DevicePtr> loadXMLDeviceFile(const std::string &config);
+    void addDevices(const std::list<DevicePtr> &devices);
+    std::unordered_map<std::string, std::string> prepareDevice(DevicePtr device);
+    void registerDevice(DevicePtr device,
+                        const std::unordered_map<std::string, std::string> &idMap);
+    std::unordered_map<std::string, std::string> createDeviceUniqueIds(DevicePtr device);
+    void updateDataItemIds(DevicePtr device,
+                           const std::unordered_map<std::string, std::string> &idMap);
     void verifyDevice(DevicePtr device);
     void initializeDataItems(DevicePtr device,
                              std::optional<std::set<std::string>> skip = std::nullopt);
     void loadCachedProbe();
+    void recoverJournal();
     void versionDeviceXml();
 
     // Asset count management
@@ -496,8 +523,16 @@ namespace mtconnect {
     // Pipeline
     pipeline::PipelineContextPtr m_pipelineContext;
 
+    // Optional observation journal for restart continuity
+    std::shared_ptr<buffer::ObservationJournal> m_journal;
+    std::optional<uint64_t> m_instanceId;
+
     // Pointer to the configuration file for node access
     std::unique_ptr<parser::XmlParser> m_xmlParser;
+    std::unique_ptr<parser::DeviceCache> m_deviceCache;
+    size_t m_loadThreads {1};
+    mutable std::mutex m_probeDocumentMutex;
+    mutable bool m_probeDocumentStale {true};
     PrinterMap m_printers;
 
     // Agent Device
@@ -616,6 +651,10 @@ namespace mtconnect {
     {
       return m_agent->getCircularBuffer().checkDuplicate(obs);
     }
+    ObservationPtr getLatest(const std::string &id, uint64_t &sequence) const override
+    {
+      return m_agent->getCircularBuffer().getLatest(id, sequence);
+    }
 
   protected:
     Agent *m_agent;
@@ -663,12 +702,11 @@ namespace mtconnect {
                              FilterSet &filter,
                              const std::optional<std::string> &deviceType) const override
     {
-      std::string dataPath = m_agent->devicesAndPath(path, device, deviceType);
-      const auto &parser = m_agent->getXmlParser();
-      parser->getDataItems(filter, dataPath);
+      m_agent->getDataItemsForPath(device, path, filter, deviceType);
     }
 
     buffer::CircularBuffer &getCircularBuffer() override { return m_agent->getCircularBuffer(); }
+    std::optional<uint64_t> getInstanceId() const override { return m_agent->getInstanceId(); }
 
     configuration::HookManager<Agent> &getHooks(HookType type) override
     {
@@ -79,6 +79,10 @@ namespace mtconnect {
           else
             entity::ConvertValueToType(r, entity::ValueType::BOOL);
         }
+        else if (!hashSkip().contains(key))
+        {
+          m_hash.reset();
+        }
 
         m_properties.insert_or_assign(key, r);
       }
@@ -137,6 +141,19 @@ namespace mtconnect {
           return std::nullopt;
       }
       bool isRemoved() const { return m_removed; }
+
+      /// @brief Compute the hash of the asset and add a `hash` property.
+      ///
+      /// The hash is cached until a property included in the hash is set on the asset. If the
+      /// asset's child entities are modified directly, `invalidateHash()` must be called.
+      void addHash()
+      {
+        if (!m_hash)
+          m_hash = entity::Entity::hash();
+        setProperty("hash", *m_hash);
+      }
+      /// @brief Discard the cached hash
+      void invalidateHash() { m_hash.reset(); }
       /// @brief sets the removed state of the asset
       void setRemoved()
       {
@@ -161,14 +178,21 @@ namespace mtconnect {
       ///
       /// @param[in,out] sha1 The boost sha1 accumulator
       void hash(::boost::uuids::detail::sha1 &sha1) const override
+      {
+        entity::Entity::hash(sha1, hashSkip());
+      }
+
+      /// @brief the properties that are not included in the hash
+      static const ::boost::unordered_set<std::string> &hashSkip()
       {
         static const ::boost::unordered_set<std::string> skip {"hash", "timestamp", "removed"};
-        entity::Entity::hash(sha1, skip);
+        return skip;
       }
 
     protected:
       std::string m_assetId;
       bool m_removed;
+      std::optional<std::string> m_hash;
     };
 
     /// @brief A simple `RAW` asset that just carries the data associated
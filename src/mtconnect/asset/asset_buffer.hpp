@@ -84,8 +84,6 @@ namespace mtconnect::asset {
     using AssetId = std::string;
     using AssetType = std::string;
     using DeviceUuid = std::string;
-    using RemoveCountByType = std::unordered_map<AssetType, size_t>;
-    using RemoveCountByDeviceAndType = std::unordered_map<DeviceUuid, RemoveCountByType>;
 
     /// @brief Index by first in/first out sequence
     struct ByFifo
@@ -117,10 +115,8 @@ namespace mtconnect::asset {
 
     size_t getCount(bool active = true) const override
     {
-      if (active)
-        return m_index.size() - m_removedAssets;
-      else
-        return m_index.size();
+      std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+      return m_counts.getCount(active);
     }
 
     AssetPtr addAsset(AssetPtr asset) override
@@ -144,21 +140,21 @@ namespace mtconnect::asset {
       if (!added.second)
       {
         old = added.first->m_asset;
+        m_counts.erase(added.first->getDeviceUuid(), old->getType(), old->isRemoved());
         m_index.modify(added.first, [&asset](AssetNode &n) { n.m_asset = asset; });
         m_index.relocate(m_index.begin(), added.first);
-        if (asset->isRemoved() && !old->isRemoved())
-          adjustCount(asset, 1);
-        else if (!asset->isRemoved() && old->isRemoved())
-          adjustCount(old, -1);
+        m_counts.add(added.first->getDeviceUuid(), asset->getType(), asset->isRemoved());
       }
-      else if (m_index.size() > m_maxAssets)
+      else
       {
-        // Remove old asset from the end
-        old = m_index.back().m_asset;
-        m_index.pop_back();
-        if (old->isRemoved())
+        m_counts.add(added.first->getDeviceUuid(), asset->getType(), asset->isRemoved());
+        if (m_index.size() > m_maxAssets)
         {
-          adjustCount(old, -1);
+          // Remove old asset from the end
+          auto &back = m_index.back();
+          old = back.m_asset;
+          m_counts.erase(back.getDeviceUuid(), old->getType(), old->isRemoved());
+          m_index.pop_back();
         }
       }
 
@@ -181,7 +177,7 @@ namespace mtconnect::asset {
           asset->setProperty("removed", true);
           Timestamp ts = time ? *time : std::chrono::system_clock::now();
           asset->setProperty("timestamp", ts);
-          adjustCount(asset, 1);
+          m_counts.markRemoved(it->getDeviceUuid(), asset->getType());
         }
       }
 
@@ -248,84 +244,32 @@ namespace mtconnect::asset {
     size_t getCountForDeviceAndType(const std::string &device, const std::string &type,
                                     bool active = true) const override
     {
-      using namespace boost::adaptors;
-
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
-
-      return boost::count_if(
-          m_index.get<ByDeviceAndType>().equal_range(std::make_tuple(device, type)),
-          activePredicate(active));
+      return m_counts.getCountForDeviceAndType(device, type, active);
     }
 
     size_t getCountForType(const std::string &type, bool active = true) const override
     {
-      using namespace boost::adaptors;
-
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
-
-      return boost::count_if(m_index.get<ByType>().equal_range(type), activePredicate(active));
+      return m_counts.getCountForType(type, active);
     }
 
     size_t getCountForDevice(const std::string &device, bool active = true) const override
     {
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
-
-      return boost::count_if(m_index.get<ByDeviceAndType>().equal_range(std::make_tuple(device)),
-                             activePredicate(active));
+      return m_counts.getCountForDevice(device, active);
     }
 
     TypeCount getCountsByType(bool active = true) const override
     {
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
-      TypeCount res;
-      auto &idx = m_index.get<ByType>();
-      auto it = idx.begin();
-      while (it != idx.end())
-      {
-        int delta = 0;
-        auto &type = it->getType();
-        auto rng = idx.equal_range(type);
-        if (active)
-        {
-          auto cit = m_typeRemoveCount.find(type);
-          delta = cit != m_typeRemoveCount.end() ? (int32_t)cit->second : 0;
-        }
-        auto count = distance(rng.first, rng.second) - delta;
-        if (count > 0)
-          res[type] = count;
-        it = rng.second;
-      }
-
-      return res;
+      return m_counts.getCountsByType(active);
     }
 
     TypeCount getCountsByTypeForDevice(const std::string &device, bool active = true) const override
     {
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
-      TypeCount res;
-      auto &idx = m_index.get<ByDeviceAndType>();
-      auto removes = m_deviceRemoveCount.find(device);
-      const auto *ridx {removes == m_deviceRemoveCount.end() ? nullptr : &removes->second};
-
-      auto range = idx.equal_range(std::make_tuple(device));
-      auto it = range.first;
-      while (it != range.second)
-      {
-        int delta = 0;
-        auto &type = it->getType();
-        auto rng = idx.equal_range(std::make_tuple(device, type));
-        if (ridx != nullptr && active)
-        {
-          auto cit = ridx->find(type);
-          delta = cit != ridx->end() ? int32_t(cit->second) : 0;
-        }
-        auto count = distance(rng.first, rng.second) - delta;
-        if (count > 0)
-          res[type] = count;
-        it = rng.second;
-      }
-
-      return res;
+      return m_counts.getCountsByTypeForDevice(device, active);
     }
 
     size_t removeAll(AssetList &list, const std::optional<std::string> device = std::nullopt,
@@ -355,56 +299,7 @@ namespace mtconnect::asset {
     }
 
   protected:
-    void adjustCount(AssetPtr asset, int delta)
-    {
-      const auto &type = asset->getType();
-      const auto &dev = asset->getDeviceUuid();
-      bool found = false;
-
-      if (dev)
-      {
-        auto it = m_deviceRemoveCount.find(*dev);
-        if (it != m_deviceRemoveCount.end())
-        {
-          auto ti = it->second.find(type);
-          if (ti != it->second.end())
-          {
-            ti->second += delta;
-            found = true;
-          }
-        }
-
-        if (!found && delta > 0)
-        {
-          m_deviceRemoveCount[*dev][type] = delta;
-        }
-
-        m_removedAssets += delta;
-      }
-
-      if (auto it = m_typeRemoveCount.find(type); it != m_typeRemoveCount.end())
-      {
-        it->second += delta;
-      }
-      else
-      {
-        m_typeRemoveCount[type] += delta;
-      }
-    }
-
-    std::function<bool(const AssetNode &)> activePredicate(bool active) const
-    {
-      if (active)
-        return [](const AssetNode &a) -> bool { return !a.isRemoved(); };
-      else
-        return [](const AssetNode &a) -> bool { return true; };
-    }
-
-  protected:
-    size_t m_removedAssets {0};
     AssetIndex m_index;
-
-    RemoveCountByDeviceAndType m_deviceRemoveCount;
-    RemoveCountByType m_typeRemoveCount;
+    AssetCounts m_counts;
   };
 }  // namespace mtconnect::asset
@@ -161,5 +161,131 @@ namespace mtconnect {
       mutable std::recursive_mutex m_bufferLock;
       size_t m_maxAssets;
     };
+
+    /// @brief Asset counts by type and by device and type
+    ///
+    /// The counts are maintained as assets are added, replaced, removed, and evicted so the
+    /// count queries do not need to scan the asset indexes. Types without assets are erased so
+    /// the queries are proportional to the number of types.
+    class AGENT_LIB_API AssetCounts
+    {
+    public:
+      /// @brief Total and removed count
+      struct Count
+      {
+        size_t m_total {0};
+        size_t m_removed {0};
+
+        /// @brief get the count
+        /// @param[in] active `true` if removed assets are excluded
+        size_t get(bool active) const { return active ? m_total - m_removed : m_total; }
+      };
+
+      /// @brief count an asset that was added to storage
+      void add(const std::string &device, const std::string &type, bool removed)
+      {
+        adjust(device, type, 1, removed ? 1 : 0);
+      }
+      /// @brief stop counting an asset that was replaced or evicted from storage
+      void erase(const std::string &device, const std::string &type, bool removed)
+      {
+        adjust(device, type, -1, removed ? -1 : 0);
+      }
+      /// @brief count an asset in storage that was marked as removed
+      void markRemoved(const std::string &device, const std::string &type)
+      {
+        adjust(device, type, 0, 1);
+      }
+      /// @brief clear all the counts
+      void clear()
+      {
+        m_all = Count();
+        m_byType.clear();
+        m_byDevice.clear();
+      }
+
+      /// @name Count queries with the same semantics as `AssetStorage`
+      ///@{
+      size_t getCount(bool active) const { return m_all.get(active); }
+      size_t getCountForType(const std::string &type, bool active) const
+      {
+        auto it = m_byType.find(type);
+        return it != m_byType.end() ? it->second.get(active) : 0;
+      }
+      size_t getCountForDevice(const std::string &device, bool active) const
+      {
+        size_t count = 0;
+        if (auto it = m_byDevice.find(device); it != m_byDevice.end())
+        {
+          for (const auto &[type, c] : it->second)
+            count += c.get(active);
+        }
+        return count;
+      }
+      size_t getCountForDeviceAndType(const std::string &device, const std::string &type,
+                                      bool active) const
+      {
+        if (auto it = m_byDevice.find(device); it != m_byDevice.end())
+        {
+          if (auto ti = it->second.find(type); ti != it->second.end())
+            return ti->second.get(active);
+        }
+        return 0;
+      }
+      AssetStorage::TypeCount getCountsByType(bool active) const { return counts(m_byType, active); }
+      AssetStorage::TypeCount getCountsByTypeForDevice(const std::string &device,
+                                                       bool active) const
+      {
+        if (auto it = m_byDevice.find(device); it != m_byDevice.end())
+          return counts(it->second, active);
+        return {};
+      }
+      ///@}
+
+    protected:
+      using CountByType = std::unordered_map<std::string, Count>;
+
+      static void apply(Count &count, int total, int removed)
+      {
+        count.m_total += total;
+        count.m_removed += removed;
+      }
+
+      static AssetStorage::TypeCount counts(const CountByType &types, bool active)
+      {
+        AssetStorage::TypeCount res;
+        for (const auto &[type, c] : types)
+        {
+          if (auto count = c.get(active); count > 0)
+            res[type] = count;
+        }
+        return res;
+      }
+
+      void adjust(const std::string &device, const std::string &type, int total, int removed)
+      {
+        apply(m_all, total, removed);
+
+        auto &byType = m_byType[type];
+        apply(byType, total, removed);
+        if (byType.m_total == 0)
+          m_byType.erase(type);
+
+        auto &types = m_byDevice[device];
+        auto &byDevice = types[type];
+        apply(byDevice, total, removed);
+        if (byDevice.m_total == 0)
+        {
+          types.erase(type);
+          if (types.empty())
+            m_byDevice.erase(device);
+        }
+      }
+
+    protected:
+      Count m_all;
+      CountByType m_byType;
+      std::unordered_map<std::string, CountByType> m_byDevice;
+    };
   }  // namespace asset
 }  // namespace mtconnect
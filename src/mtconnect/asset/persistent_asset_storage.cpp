@@ -0,0 +1,559 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "persistent_asset_storage.hpp"
+
+#include <boost/crc.hpp>
+
+#include <cstring>
+#include <limits>
+
+#include "mtconnect/entity/xml_parser.hpp"
+#include "mtconnect/entity/xml_printer.hpp"
+#include "mtconnect/logging.hpp"
+#include "mtconnect/printer/xml_printer_helper.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mtconnect::asset {
+  namespace {
+    constexpr char Magic[8] = {'M', 'T', 'C', 'A', 'S', 'S', 'T', '1'};
+    constexpr size_t RecordHeaderSize = 2 * sizeof(uint32_t) + sizeof(uint8_t);
+    constexpr uint64_t MinCompactSize = 1024 * 1024;
+    const string LogFile("assets.log");
+
+    /// @brief Asset log record types
+    enum RecordType : uint8_t
+    {
+      ADD = 1,     ///< The XML document of an added or updated asset
+      REMOVE = 2,  ///< The removal time in nanoseconds followed by the asset id
+    };
+
+    inline uint32_t checksum(uint8_t type, const char *data, size_t size)
+    {
+      boost::crc_32_type crc;
+      crc.process_byte(type);
+      crc.process_bytes(data, size);
+      return crc.checksum();
+    }
+
+    inline uint64_t recordSize(uint32_t length) { return RecordHeaderSize + length; }
+
+    string encodeRemove(const string &id, const Timestamp &ts)
+    {
+      int64_t ns = chrono::duration_cast<chrono::nanoseconds>(ts.time_since_epoch()).count();
+      string payload(reinterpret_cast<const char *>(&ns), sizeof(ns));
+      payload.append(id);
+      return payload;
+    }
+
+    inline uint64_t removeSize(const string &id)
+    {
+      return RecordHeaderSize + sizeof(int64_t) + id.size();
+    }
+  }  // namespace
+
+  PersistentAssetStorage::PersistentAssetStorage(const fs::path &directory, size_t max,
+                                                 size_t residentSize)
+    : AssetStorage(max), m_directory(directory), m_residentSize(residentSize)
+  {
+    fs::create_directories(m_directory);
+    m_path = m_directory / LogFile;
+    load();
+    maybeCompact();
+  }
+
+  PersistentAssetStorage::~PersistentAssetStorage()
+  {
+    if (m_log.is_open())
+      m_log.close();
+  }
+
+  void PersistentAssetStorage::open()
+  {
+    m_log.close();
+    m_log.clear();
+    m_log.open(m_path, ios::in | ios::out | ios::binary);
+    if (!m_log.is_open())
+      throw runtime_error("Cannot open asset log: " + m_path.string());
+  }
+
+  void PersistentAssetStorage::load()
+  {
+    if (!fs::exists(m_path))
+    {
+      ofstream create(m_path, ios::binary | ios::trunc);
+      create.write(Magic, sizeof(Magic));
+    }
+
+    open();
+
+    char magic[sizeof(Magic)];
+    if (!m_log.read(magic, sizeof(magic)) || memcmp(magic, Magic, sizeof(Magic)) != 0)
+    {
+      LOG(error) << "PersistentAssetStorage: " << m_path << " is not an asset log, starting over";
+      m_log.close();
+      ofstream create(m_path, ios::binary | ios::trunc);
+      create.write(Magic, sizeof(Magic));
+      create.close();
+      open();
+      m_logSize = sizeof(Magic);
+      return;
+    }
+
+    uint64_t offset = sizeof(Magic);
+    string payload;
+    while (true)
+    {
+      uint32_t length, crc;
+      uint8_t type;
+      if (!m_log.read(reinterpret_cast<char *>(&length), sizeof(length)) ||
+          !m_log.read(reinterpret_cast<char *>(&crc), sizeof(crc)) ||
+          !m_log.read(reinterpret_cast<char *>(&type), sizeof(type)))
+        break;
+
+      payload.resize(length);
+      if (!m_log.read(payload.data(), length) ||
+          checksum(type, payload.data(), payload.size()) != crc)
+        break;
+
+      try
+      {
+        apply(type, payload, offset + RecordHeaderSize);
+      }
+      catch (std::exception &e)
+      {
+        LOG(warning) << "PersistentAssetStorage: skipping record at " << offset << ": "
+                     << e.what();
+      }
+
+      offset += recordSize(length);
+    }
+
+    // Discard a partially written record at the end of the log
+    m_log.clear();
+    m_logSize = offset;
+    if (fs::file_size(m_path) != offset)
+    {
+      LOG(warning) << "PersistentAssetStorage: " << m_path << " is truncated at " << offset;
+      m_log.close();
+      fs::resize_file(m_path, offset);
+      open();
+    }
+
+    LOG(info) << "PersistentAssetStorage: loaded " << m_index.size() << " assets from "
+              << m_path;
+  }
+
+  void PersistentAssetStorage::apply(uint8_t type, const std::string &payload, uint64_t offset)
+  {
+    switch (type)
+    {
+      case ADD:
+      {
+        entity::ErrorList errors;
+        auto entity = entity::XmlParser::parse(Asset::getRoot(), payload, errors);
+        auto asset = dynamic_pointer_cast<Asset>(entity);
+        if (!asset)
+          throw entity::EntityError("Cannot parse asset");
+
+        insert(makeEntry(asset, offset, uint32_t(payload.size())), asset);
+        break;
+      }
+
+      case REMOVE:
+      {
+        if (payload.size() < sizeof(int64_t))
+          throw entity::EntityError("Invalid removal record");
+
+        int64_t ns;
+        memcpy(&ns, payload.data(), sizeof(ns));
+        Timestamp ts {chrono::duration_cast<Timestamp::duration>(chrono::nanoseconds(ns))};
+        string id = payload.substr(sizeof(ns));
+
+        auto &idx = m_index.get<ByAssetId>();
+        auto it = idx.find(id);
+        if (it != idx.end() && !it->m_removed)
+        {
+          idx.modify(it, [&ts](AssetEntry &e) {
+            e.m_removed = true;
+            e.m_removedAt = ts;
+          });
+          if (it->m_asset)
+          {
+            it->m_asset->setProperty("removed", true);
+            it->m_asset->setProperty("timestamp", ts);
+          }
+          m_counts.markRemoved(it->m_deviceUuid, it->m_type);
+          m_liveSize += removeSize(id);
+        }
+        break;
+      }
+
+      default:
+        throw entity::EntityError("Unknown record type " + to_string(type));
+    }
+  }
+
+  PersistentAssetStorage::AssetEntry PersistentAssetStorage::makeEntry(const AssetPtr &asset,
+                                                                       uint64_t offset,
+                                                                       uint32_t length) const
+  {
+    AssetEntry entry;
+    entry.m_assetId = asset->getAssetId();
+    entry.m_type = asset->getType();
+    entry.m_deviceUuid = asset->getDeviceUuid().value_or("UNKNOWN");
+    entry.m_removed = asset->isRemoved();
+    entry.m_offset = offset;
+    entry.m_length = length;
+    return entry;
+  }
+
+  void PersistentAssetStorage::release(const AssetEntry &entry)
+  {
+    m_liveSize -= recordSize(entry.m_length);
+    if (entry.m_removedAt)
+      m_liveSize -= removeSize(entry.m_assetId);
+    m_counts.erase(entry.m_deviceUuid, entry.m_type, entry.m_removed);
+  }
+
+  AssetPtr PersistentAssetStorage::insert(AssetEntry &&entry, AssetPtr asset)
+  {
+    AssetPtr old;
+    if (entry.m_length <= m_residentSize)
+      entry.m_asset = asset;
+    entry.m_cache = asset;
+    m_liveSize += recordSize(entry.m_length);
+    m_counts.add(entry.m_deviceUuid, entry.m_type, entry.m_removed);
+
+    // Is duplicate
+    auto &idx = m_index.get<ByAssetId>();
+    if (auto it = idx.find(entry.m_assetId); it != idx.end())
+    {
+      old = page(*it);
+      release(*it);
+      idx.replace(it, std::move(entry));
+      m_index.relocate(m_index.begin(), m_index.project<ByFifo>(it));
+    }
+    else if (m_index.emplace_front(std::move(entry)); m_index.size() > m_maxAssets)
+    {
+      // Remove old asset from the end
+      old = page(m_index.back());
+      release(m_index.back());
+      m_index.pop_back();
+    }
+
+    return old;
+  }
+
+  AssetPtr PersistentAssetStorage::page(const AssetEntry &entry) const
+  {
+    if (entry.m_asset)
+      return entry.m_asset;
+    if (auto cached = entry.m_cache.lock())
+      return cached;
+
+    entity::ErrorList errors;
+    auto asset = dynamic_pointer_cast<Asset>(
+        entity::XmlParser::parse(Asset::getRoot(), read(entry.m_offset, entry.m_length), errors));
+    if (!asset)
+    {
+      LOG(error) << "PersistentAssetStorage: cannot read asset " << entry.m_assetId;
+      return nullptr;
+    }
+
+    if (entry.m_removedAt && !asset->isRemoved())
+    {
+      asset->setProperty("removed", true);
+      asset->setProperty("timestamp", *entry.m_removedAt);
+    }
+
+    entry.m_cache = asset;
+    return asset;
+  }
+
+  string PersistentAssetStorage::read(uint64_t offset, uint32_t length) const
+  {
+    string document(length, '\0');
+    m_log.clear();
+    m_log.seekg(offset);
+    if (!m_log.read(document.data(), length))
+      throw runtime_error("Cannot read asset log: " + m_path.string());
+    return document;
+  }
+
+  uint64_t PersistentAssetStorage::append(uint8_t type, const std::string &payload)
+  {
+    uint32_t length = uint32_t(payload.size());
+    uint32_t crc = checksum(type, payload.data(), payload.size());
+
+    m_log.clear();
+    m_log.seekp(m_logSize);
+    m_log.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    m_log.write(reinterpret_cast<const char *>(&crc), sizeof(crc));
+    m_log.write(reinterpret_cast<const char *>(&type), sizeof(type));
+    m_log.write(payload.data(), payload.size());
+    m_log.flush();
+    if (!m_log)
+      throw runtime_error("Cannot write asset log: " + m_path.string());
+
+    auto offset = m_logSize + RecordHeaderSize;
+    m_logSize += recordSize(length);
+    return offset;
+  }
+
+  AssetPtr PersistentAssetStorage::addAsset(AssetPtr asset)
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    if (!asset->getTimestamp())
+    {
+      asset->setProperty("timestamp", getCurrentTime(GMT_UV_SEC));
+    }
+
+    if (!asset->hasProperty("assetId"))
+    {
+      throw entity::PropertyError("Asset does not have an asset id");
+    }
+
+    printer::XmlWriter writer(false);
+    entity::XmlPrinter printer(true);
+    printer.print(writer, asset, {});
+    auto document = writer.getContent();
+
+    auto offset = append(ADD, document);
+    auto old = insert(makeEntry(asset, offset, uint32_t(document.size())), asset);
+
+    maybeCompact();
+
+    return old;
+  }
+
+  AssetPtr PersistentAssetStorage::removeAsset(const std::string &id,
+                                               const std::optional<Timestamp> &time)
+  {
+    AssetPtr asset {};
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    auto &idx = m_index.get<ByAssetId>();
+    auto it = idx.find(id);
+    if (it != idx.end())
+    {
+      asset = page(*it);
+      if (!it->m_removed)
+      {
+        Timestamp ts = time ? *time : std::chrono::system_clock::now();
+        append(REMOVE, encodeRemove(id, ts));
+        idx.modify(it, [&ts](AssetEntry &e) {
+          e.m_removed = true;
+          e.m_removedAt = ts;
+        });
+        m_counts.markRemoved(it->m_deviceUuid, it->m_type);
+        m_liveSize += removeSize(id);
+
+        if (asset)
+        {
+          asset->setProperty("removed", true);
+          asset->setProperty("timestamp", ts);
+        }
+      }
+    }
+
+    return asset;
+  }
+
+  size_t PersistentAssetStorage::removeAll(AssetList &list,
+                                           const std::optional<std::string> device,
+                                           const std::optional<std::string> type,
+                                           const std::optional<Timestamp> &time)
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    getAssets(list, std::numeric_limits<size_t>().max(), false, device, type);
+    for (auto &a : list)
+      removeAsset(a->getAssetId(), time);
+
+    return list.size();
+  }
+
+  AssetPtr PersistentAssetStorage::getAsset(const std::string &id) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    const auto &idx = m_index.get<ByAssetId>();
+    auto it = idx.find(id);
+    if (it != idx.end())
+      return page(*it);
+    else
+      return nullptr;
+  }
+
+  size_t PersistentAssetStorage::getAssets(AssetList &list, size_t max, const bool active,
+                                           const std::optional<std::string> device,
+                                           const std::optional<std::string> type) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    auto collect = [&](auto first, auto last) {
+      for (auto it = first; it != last && list.size() < max; it++)
+      {
+        if (!active || !it->m_removed)
+        {
+          if (auto asset = page(*it))
+            list.push_back(asset);
+        }
+      }
+    };
+
+    if (device)
+    {
+      auto &idx = m_index.get<ByDeviceAndType>();
+      auto range = type ? idx.equal_range(std::make_tuple(*device, *type))
+                        : idx.equal_range(std::make_tuple(*device));
+      collect(range.first, range.second);
+    }
+    else if (type)
+    {
+      auto range = m_index.get<ByType>().equal_range(*type);
+      collect(range.first, range.second);
+    }
+    else
+    {
+      auto &idx = m_index.get<ByFifo>();
+      collect(idx.begin(), idx.end());
+    }
+
+    return list.size();
+  }
+
+  size_t PersistentAssetStorage::getAssets(AssetList &list,
+                                           const std::list<std::string> &ids) const
+  {
+    for (auto id : ids)
+    {
+      if (auto asset = PersistentAssetStorage::getAsset(id); asset)
+        list.emplace_back(asset);
+    }
+
+    return list.size();
+  }
+
+  size_t PersistentAssetStorage::getCount(bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCount(active);
+  }
+
+  size_t PersistentAssetStorage::getCountForDeviceAndType(const std::string &device,
+                                                          const std::string &type,
+                                                          bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCountForDeviceAndType(device, type, active);
+  }
+
+  size_t PersistentAssetStorage::getCountForType(const std::string &type, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCountForType(type, active);
+  }
+
+  size_t PersistentAssetStorage::getCountForDevice(const std::string &device, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCountForDevice(device, active);
+  }
+
+  AssetStorage::TypeCount PersistentAssetStorage::getCountsByType(bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCountsByType(active);
+  }
+
+  AssetStorage::TypeCount PersistentAssetStorage::getCountsByTypeForDevice(
+      const std::string &device, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    return m_counts.getCountsByTypeForDevice(device, active);
+  }
+
+  void PersistentAssetStorage::maybeCompact()
+  {
+    if (m_logSize > MinCompactSize && m_logSize > 2 * m_liveSize)
+      compact();
+  }
+
+  void PersistentAssetStorage::compact()
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    auto tmp = m_path;
+    tmp += ".tmp";
+
+    // Write the live records oldest first so replaying the snapshot restores the order
+    vector<pair<string, uint64_t>> offsets;
+    uint64_t size = sizeof(Magic);
+    {
+      ofstream out(tmp, ios::binary | ios::trunc);
+      out.write(Magic, sizeof(Magic));
+
+      auto writeRecord = [&](uint8_t type, const string &payload) {
+        uint32_t length = uint32_t(payload.size());
+        uint32_t crc = checksum(type, payload.data(), payload.size());
+        out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        out.write(reinterpret_cast<const char *>(&crc), sizeof(crc));
+        out.write(reinterpret_cast<const char *>(&type), sizeof(type));
+        out.write(payload.data(), payload.size());
+        auto offset = size + RecordHeaderSize;
+        size += recordSize(length);
+        return offset;
+      };
+
+      auto &fifo = m_index.get<ByFifo>();
+      for (auto it = fifo.rbegin(); it != fifo.rend(); it++)
+      {
+        offsets.emplace_back(it->m_assetId, writeRecord(ADD, read(it->m_offset, it->m_length)));
+        if (it->m_removedAt)
+          writeRecord(REMOVE, encodeRemove(it->m_assetId, *it->m_removedAt));
+      }
+
+      out.flush();
+      if (!out)
+      {
+        LOG(error) << "PersistentAssetStorage: cannot write snapshot " << tmp;
+        out.close();
+        fs::remove(tmp);
+        return;
+      }
+    }
+
+    m_log.close();
+    fs::rename(tmp, m_path);
+    open();
+
+    auto &idx = m_index.get<ByAssetId>();
+    for (auto &[id, offset] : offsets)
+    {
+      auto it = idx.find(id);
+      idx.modify(it, [offset = offset](AssetEntry &e) { e.m_offset = offset; });
+    }
+
+    LOG(debug) << "PersistentAssetStorage: compacted " << m_path << " from " << m_logSize
+               << " to " << size << " bytes";
+    m_logSize = size;
+    m_liveSize = size - sizeof(Magic);
+  }
+}  // namespace mtconnect::asset
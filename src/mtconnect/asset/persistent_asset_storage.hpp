@@ -0,0 +1,158 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/key.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "asset.hpp"
+#include "asset_storage.hpp"
+#include "mtconnect/config.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::asset {
+  namespace mic = boost::multi_index;
+
+  /// @brief Asset storage persisted in an append-only log
+  ///
+  /// Every added asset is appended to the log as an XML document and every removal is appended
+  /// as a small removal record. The indexes only keep the asset id, type, device, and the
+  /// location of the document in the log. Assets whose documents are smaller than the resident
+  /// size are kept in memory; larger assets, such as QIF documents, are parsed from the log when
+  /// they are requested and only cached while they are referenced.
+  ///
+  /// When the log grows to more than twice the size of the live records it is compacted into a
+  /// snapshot containing only the live records that replaces the log. The indexes are rebuilt by
+  /// replaying the log when the storage is created.
+  class AGENT_LIB_API PersistentAssetStorage : public AssetStorage
+  {
+  public:
+    /// @brief The index entry for an asset
+    struct AssetEntry
+    {
+      std::string m_assetId;
+      std::string m_type;
+      std::string m_deviceUuid;
+      bool m_removed {false};
+      std::optional<Timestamp> m_removedAt;  ///< the time of a removal record
+      uint64_t m_offset {0};                 ///< offset of the asset document in the log
+      uint32_t m_length {0};                 ///< length of the asset document
+      mutable AssetPtr m_asset;              ///< resident asset
+      mutable std::weak_ptr<Asset> m_cache;  ///< paged asset if it is still referenced
+
+      const std::string &getType() const { return m_type; }
+      const std::string &getDeviceUuid() const { return m_deviceUuid; }
+      bool isRemoved() const { return m_removed; }
+    };
+
+    /// @brief Index by first in/first out sequence
+    struct ByFifo
+    {};
+    /// @brief Index by assetId
+    struct ByAssetId
+    {};
+    /// @brief Index by Device and Type
+    struct ByDeviceAndType
+    {};
+    /// @brief Index by type
+    struct ByType
+    {};
+
+    /// @brief The Multi-Index Container type
+    using AssetIndex = mic::multi_index_container<
+        AssetEntry,
+        mic::indexed_by<
+            mic::sequenced<mic::tag<ByFifo>>,
+            mic::hashed_unique<mic::tag<ByAssetId>, mic::key<&AssetEntry::m_assetId>>,
+            mic::ordered_non_unique<mic::tag<ByDeviceAndType>,
+                                    mic::key<&AssetEntry::m_deviceUuid, &AssetEntry::m_type>>,
+            mic::hashed_non_unique<mic::tag<ByType>, mic::key<&AssetEntry::m_type>>>>;
+
+    /// @brief Create the storage and replay the log in the directory
+    /// @param[in] directory the directory for the asset log
+    /// @param[in] max the maximum number of assets
+    /// @param[in] residentSize documents up to this size are kept in memory
+    PersistentAssetStorage(const std::filesystem::path &directory, size_t max,
+                           size_t residentSize = 16 * 1024);
+    ~PersistentAssetStorage() override;
+
+    size_t getCount(bool active = true) const override;
+    TypeCount getCountsByType(bool active = true) const override;
+
+    AssetPtr addAsset(AssetPtr asset) override;
+    AssetPtr removeAsset(const std::string &id,
+                         const std::optional<Timestamp> &time = std::nullopt) override;
+    size_t removeAll(AssetList &list, const std::optional<std::string> device = std::nullopt,
+                     const std::optional<std::string> type = std::nullopt,
+                     const std::optional<Timestamp> &time = std::nullopt) override;
+
+    AssetPtr getAsset(const std::string &id) const override;
+    size_t getAssets(AssetList &list, size_t max, const bool active = true,
+                     const std::optional<std::string> device = std::nullopt,
+                     const std::optional<std::string> type = std::nullopt) const override;
+    size_t getAssets(AssetList &list, const std::list<std::string> &ids) const override;
+
+    size_t getCountForDeviceAndType(const std::string &device, const std::string &type,
+                                    bool active = true) const override;
+    size_t getCountForType(const std::string &type, bool active = true) const override;
+    size_t getCountForDevice(const std::string &device, bool active = true) const override;
+    TypeCount getCountsByTypeForDevice(const std::string &device,
+                                       bool active = true) const override;
+
+    /// @brief rewrite the log with only the live records
+    void compact();
+
+    /// @brief get the path of the log file
+    const auto &getPath() const { return m_path; }
+    /// @brief get the size of the log file in bytes
+    auto getLogSize() const { return m_logSize; }
+
+  protected:
+    void load();
+    void open();
+    void apply(uint8_t type, const std::string &payload, uint64_t offset);
+    AssetEntry makeEntry(const AssetPtr &asset, uint64_t offset, uint32_t length) const;
+    AssetPtr insert(AssetEntry &&entry, AssetPtr asset);
+    AssetPtr page(const AssetEntry &entry) const;
+    uint64_t append(uint8_t type, const std::string &payload);
+    std::string read(uint64_t offset, uint32_t length) const;
+    void release(const AssetEntry &entry);
+    void maybeCompact();
+
+  protected:
+    std::filesystem::path m_directory;
+    std::filesystem::path m_path;
+    size_t m_residentSize;
+    AssetIndex m_index;
+    AssetCounts m_counts;
+
+    mutable std::fstream m_log;
+    uint64_t m_logSize {0};
+    uint64_t m_liveSize {0};
+  };
+}  // namespace mtconnect::asset
@@ -43,35 +43,37 @@ namespace mtconnect {
     void Checkpoint::addObservation(ConditionPtr event, ObservationPtr &&old)
     {
       bool assign = true;
-      Condition *cond = dynamic_cast<Condition *>(old.get());
+      auto cond = dynamic_pointer_cast<Condition>(old);
       if (cond->getLevel() != Condition::NORMAL && event->getLevel() != Condition::NORMAL &&
           cond->getLevel() != Condition::UNAVAILABLE && event->getLevel() != Condition::UNAVAILABLE)
       {
-        // Check to see if the native code matches an existing
-        // active condition
-        if (auto e = cond->find(event->getCode()))
-        {
-          // Replace in chain.
-          old = cond->deepCopyAndRemove(e);
-          // Check if this is the only event...
-          // ??
-        }
-
-        // Chain the event
-        if (old)
-          event->appendTo(dynamic_pointer_cast<Condition>(old));
+        // The event replaces an active condition with the same native code, the other
+        // active conditions are shared with the previous state.
+        auto active = cond->getActiveConditions();
+        active.erase(event->getCode());
+        event->setActive(active);
       }
       else if (event->getLevel() == Condition::NORMAL)
       {
         // Check for a normal that clears an active condition by code
         if (!event->getCode().empty())
         {
-          if (auto e = cond->find(event->getCode()))
+          if (cond->find(event->getCode()))
           {
-            // Clear the one condition by removing it from the chain
-            old = cond->deepCopyAndRemove(e);
+            // Clear the one condition by removing it from the active conditions
+            auto active = cond->getActiveConditions();
+            active.erase(event->getCode());
 
-            if (!old)
+            if (auto last = active.last())
+            {
+              // The most recent condition becomes the current one. It is copied since
+              // it is shared with the other states that include it.
+              auto n = make_shared<Condition>(*last);
+              active.erase(last->getCode());
+              n->setActive(active);
+              old = n;
+            }
+            else
             {
               // Need to put a normal event in with no code since this
               // is the last one.
@@ -97,17 +99,17 @@ namespace mtconnect {
     {
       if (!event->isUnavailable() && !old->isUnavailable() && !event->hasProperty("resetTriggered"))
       {
-        // Get the existing data set from the existing event
+        // Get the existing data set from the existing event. The copy shares the entries with
+        // the existing event, so merging only copies the paths to the changed entries.
         DataSet set = old->getValue<DataSet>();
 
         // For data sets merge the maps together
         for (auto &e : event->getValue<DataSet>())
         {
-          const auto &oe = set.find(e);
-          if (oe != set.end())
-            set.erase(oe);
-          if (!e.m_removed)
-            set.insert(e);
+          if (e.m_removed)
+            set.erase(e);
+          else
+            set.insert_or_assign(e);
         }
 
         // Replace the old event with a copy of the new event with sets merged
@@ -178,10 +180,12 @@ namespace mtconnect {
     {
       if (obs->getDataItem()->isCondition())
       {
-        for (auto ev = dynamic_pointer_cast<Condition>(obs); ev; ev = ev->getPrev())
-        {
-          list.push_back(ev);
-        }
+        // The current condition first followed by the other active conditions, newest first
+        auto cond = dynamic_pointer_cast<Condition>(obs);
+        list.push_back(cond);
+        const auto &active = cond->getActive();
+        for (auto it = active.rbegin(); it != active.rend(); it++)
+          list.push_back(it->m_condition);
       }
       else
       {
@@ -241,7 +245,7 @@ namespace mtconnect {
     }
 
     ObservationPtr Checkpoint::dataSetDifference(const ObservationPtr &obs,
-                                                 const ConstObservationPtr &old) const
+                                                 const ConstObservationPtr &old)
     {
       if (obs->isOrphan())
         return nullptr;
@@ -252,20 +256,19 @@ namespace mtconnect {
       {
         auto oldEvent = dynamic_pointer_cast<const DataSetEvent>(old);
         auto &oldSet = oldEvent->getDataSet();
-        DataSet eventSet = setEvent->getDataSet();
+        const auto &incoming = setEvent->getDataSet();
+        DataSet eventSet = incoming;
         bool changed = false;
 
-        for (auto it = eventSet.begin(); it != eventSet.end();)
+        // Remove the unchanged entries from the copy, iterating the incoming set since erasing
+        // invalidates the iterators of the copy
+        for (const auto &e : incoming)
         {
-          const auto v = oldSet.find(*it);
-          if (v == oldSet.end() || !v->same(*it))
-          {
-            it++;
-          }
-          else
+          const auto v = oldSet.find(e);
+          if (v != oldSet.end() && v->same(e))
           {
             changed = true;
-            eventSet.erase(it++);
+            eventSet.erase(e);
           }
         }
 
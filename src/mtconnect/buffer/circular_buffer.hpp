@@ -25,8 +25,10 @@
 
 #include "checkpoint.hpp"
 #include "mtconnect/config.hpp"
+#include "observation_journal.hpp"
 #include "mtconnect/entity/requirement.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/observation/observation.hpp"
 #include "mtconnect/utilities.hpp"
 
@@ -93,6 +95,20 @@ namespace mtconnect::buffer {
         o->updateDataItem(diMap);
       }
 
+      // Carry the latest sequence over to replaced data items so pipeline
+      // local state can still be validated against the buffer
+      for (auto &[id, obs] : m_latest.getObservations())
+      {
+        auto ndi = diMap.find(id);
+        if (ndi == diMap.end())
+          continue;
+
+        auto odi = obs->getDataItem();
+        auto di = ndi->second.lock();
+        if (odi && di && odi != di)
+          di->setLatestSequence(odi->getLatestSequence());
+      }
+
       // checkpoints will remove orphans from its observations
       m_first.updateDataItems(diMap);
       m_latest.updateDataItems(diMap);
@@ -131,28 +147,16 @@ namespace mtconnect::buffer {
       auto seq = m_sequence;
 
       observation->setSequence(seq);
-      m_slidingBuffer.push_back(observation);
-      m_latest.addObservation(observation);
-
-      // Special case for the first event in the series to prime the first checkpoint.
-      if (seq == 1)
-        m_first.addObservation(observation);
-      else if (m_slidingBuffer.full())
-      {
-        observation::ObservationPtr old = m_slidingBuffer.front();
-        m_first.addObservation(old);
-        if (old->getSequence() > 1)
-          m_firstSequence++;
-        // assert(old->getSequence() == m_firstSequence);
-      }
+      store(observation);
 
-      // Checkpoint management
-      if (m_checkpointCount > 0 && (seq % m_checkpointFreq) == 0)
+      if (m_journal)
       {
-        // Copy the checkpoint from the current into the slot
-        m_checkpoints.push_back(std::make_unique<Checkpoint>(m_latest));
+        m_journal->append(observation);
+        if (m_journal->isCheckpointRequested())
+          m_journal->appendCheckpoint(seq, m_latest);
       }
 
+      dataItem->setLatestSequence(seq);
       dataItem->signalObservers(m_sequence);
 
       m_sequence++;
@@ -160,6 +164,56 @@ namespace mtconnect::buffer {
       return seq;
     }
 
+    /// @name Journal methods
+    ///@{
+
+    /// @brief Restore the buffer from the observations recovered from a journal
+    ///
+    /// The checkpoint becomes the first and latest checkpoints and the observations are added
+    /// with their original sequence numbers.
+    ///
+    /// @param[in] recovery the recovered checkpoint and observations
+    void restore(const ObservationJournal::Recovery &recovery)
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+
+      m_slidingBuffer.clear();
+      m_checkpoints.clear();
+      m_latest.clear();
+      for (const auto &obs : recovery.m_checkpoint)
+      {
+        m_latest.addObservation(obs);
+        if (auto di = obs->getDataItem())
+          di->setLatestSequence(obs->getSequence());
+      }
+      m_first.copy(m_latest);
+
+      m_sequence = recovery.m_checkpointSequence + 1;
+      m_firstSequence = m_sequence;
+      for (auto obs : recovery.m_observations)
+      {
+        m_sequence = obs->getSequence();
+        store(obs);
+        if (auto di = obs->getDataItem())
+          di->setLatestSequence(m_sequence);
+        m_sequence++;
+      }
+    }
+
+    /// @brief Write all observations added to the buffer to a journal
+    ///
+    /// Queues a checkpoint of the current state to start the first segment.
+    ///
+    /// @param[in] journal the started journal
+    void setJournal(std::shared_ptr<ObservationJournal> journal)
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+      m_journal = journal;
+      if (m_journal)
+        m_journal->appendCheckpoint(m_sequence - 1, m_latest);
+    }
+    ///@}
+
     /// @name Checkpoint methods
     ///@{
 
@@ -181,6 +235,24 @@ namespace mtconnect::buffer {
       return m_latest.checkDuplicate(obs);
     }
 
+    /// @brief Get the latest observation for a data item
+    /// @param[in] id the data item id
+    /// @param[out] sequence the sequence of the last observation added for the data item
+    /// @return the latest observation or `nullptr` if there is none
+    observation::ObservationPtr getLatest(const std::string &id, SequenceNumber_t &sequence) const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+      auto obs = m_latest.getObservation(id);
+      if (obs)
+      {
+        if (auto di = obs->getDataItem())
+          sequence = di->getLatestSequence();
+        else
+          return nullptr;
+      }
+      return obs;
+    }
+
     /// @brief Get a checkpoint at a sequence number
     /// @param at the sequence number to get the checkpoint at
     /// @param filterSet the filter to apply to the new checkpoint
@@ -314,16 +386,94 @@ namespace mtconnect::buffer {
     ///@{
 
     /// @brief lock the mutex
-    auto lock() { return m_sequenceLock.lock(); }
+    ///
+    /// When metrics are enabled the time waiting for the lock and the time it is held are recorded.
+    void lock()
+    {
+      if (!metrics::Registry::isEnabled())
+      {
+        m_sequenceLock.lock();
+        m_lockDepth++;
+        return;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      m_sequenceLock.lock();
+      if (m_lockDepth++ == 0)
+      {
+        m_lockAcquired = std::chrono::steady_clock::now();
+        if (m_lockWait == nullptr)
+        {
+          auto &registry = metrics::Registry::instance();
+          m_lockWait = &registry.histogram("mtconnect_buffer_lock_wait_seconds");
+          m_lockHold = &registry.histogram("mtconnect_buffer_lock_hold_seconds");
+        }
+        m_lockWait->record(uint64_t(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(m_lockAcquired - start).count()));
+      }
+    }
     /// @brief unlock the mutex
-    auto unlock() { return m_sequenceLock.unlock(); }
+    void unlock()
+    {
+      if (--m_lockDepth == 0 && m_lockHold != nullptr &&
+          m_lockAcquired != std::chrono::steady_clock::time_point())
+      {
+        m_lockHold->record(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - m_lockAcquired)
+                                        .count()));
+        m_lockAcquired = {};
+      }
+      m_sequenceLock.unlock();
+    }
     /// @brief try to lock the mutex
-    auto try_lock() { return m_sequenceLock.try_lock(); }
+    bool try_lock()
+    {
+      if (m_sequenceLock.try_lock())
+      {
+        m_lockDepth++;
+        return true;
+      }
+      return false;
+    }
     ///@}
 
+  protected:
+    /// @brief Store an observation with its sequence number in the sliding buffer and update the
+    /// checkpoints
+    /// @param observation the observation
+    void store(const observation::ObservationPtr &observation)
+    {
+      auto seq = observation->getSequence();
+      m_slidingBuffer.push_back(observation);
+      m_latest.addObservation(observation);
+
+      // Special case for the first event in the series to prime the first checkpoint.
+      if (seq == 1)
+        m_first.addObservation(observation);
+      else if (m_slidingBuffer.full())
+      {
+        observation::ObservationPtr old = m_slidingBuffer.front();
+        m_first.addObservation(old);
+        if (old->getSequence() > 1)
+          m_firstSequence++;
+        // assert(old->getSequence() == m_firstSequence);
+      }
+
+      // Checkpoint management
+      if (m_checkpointCount > 0 && (seq % m_checkpointFreq) == 0)
+      {
+        // Copy the checkpoint from the current into the slot
+        m_checkpoints.push_back(std::make_unique<Checkpoint>(m_latest));
+      }
+    }
+
   protected:
     // Access control to the buffer
     mutable std::recursive_mutex m_sequenceLock;
+    int m_lockDepth {0};
+    std::chrono::steady_clock::time_point m_lockAcquired;
+    metrics::Histogram *m_lockWait {nullptr};
+    metrics::Histogram *m_lockHold {nullptr};
 
     // Sequence number
     SequenceNumber_t m_sequence;
@@ -340,5 +490,8 @@ namespace mtconnect::buffer {
     Checkpoint m_latest;
     Checkpoint m_first;
     boost::circular_buffer<std::unique_ptr<Checkpoint>> m_checkpoints;
+
+    // Optional persistent journal
+    std::shared_ptr<ObservationJournal> m_journal;
   };
 }  // namespace mtconnect::buffer
@@ -0,0 +1,567 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "observation_journal.hpp"
+
+#include <boost/crc.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "mtconnect/entity/binary_codec.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+namespace ip = boost::interprocess;
+
+namespace mtconnect::buffer {
+  using namespace observation;
+  using namespace entity;
+
+  namespace {
+    constexpr char Magic[8] = {'M', 'T', 'C', 'J', 'R', 'N', 'L', '\0'};
+    constexpr uint32_t Version = 1;
+    constexpr size_t HeaderSize = 64;
+    constexpr size_t RecordHeaderSize = 2 * sizeof(uint32_t);
+    constexpr uint8_t NoLevel = 0xFF;
+    const string Extension(".mtj");
+
+    /// @brief Journal record types
+    enum RecordType : uint8_t
+    {
+      OBSERVATION = 1,     ///< An observation added to the buffer
+      CHECKPOINT = 2,      ///< An observation in the checkpoint at the start of a segment
+      CHECKPOINT_END = 3,  ///< The checkpoint is complete
+    };
+
+    struct SegmentHeader
+    {
+      char m_magic[8];
+      uint32_t m_version;
+      uint32_t m_headerSize;
+      uint64_t m_instanceId;
+      uint64_t m_start;
+    };
+    static_assert(sizeof(SegmentHeader) <= HeaderSize);
+
+    inline uint32_t checksum(const char *data, size_t size)
+    {
+      boost::crc_32_type crc;
+      crc.process_bytes(data, size);
+      return crc.checksum();
+    }
+
+    /// @brief Binary encoding of observation records in host byte order
+    class Encoder : public BinaryEncoder
+    {
+    public:
+      using BinaryEncoder::BinaryEncoder;
+
+      void putObservation(RecordType type, const ObservationPtr &obs)
+      {
+        auto di = obs->getDataItem();
+        const auto &skip = di->getObservationProperties();
+
+        put<uint8_t>(type);
+        put<uint64_t>(obs->getSequence());
+        putString(di->getId());
+        put<int64_t>(obs->getTimestamp().time_since_epoch().count());
+        put<uint8_t>(obs->isUnavailable() ? uint8_t(1) : uint8_t(0));
+
+        uint8_t level = NoLevel;
+        if (auto cond = dynamic_pointer_cast<Condition>(obs))
+          level = uint8_t(cond->getLevel());
+        put<uint8_t>(level);
+
+        // The data item properties, timestamp, and sequence are restored when the observation
+        // is recreated
+        const auto &props = obs->getProperties();
+        auto countPos = m_out.size();
+        put<uint32_t>(0);
+        uint32_t count = 0;
+        for (const auto &[key, value] : props)
+        {
+          if (key == "timestamp" || key == "sequence" || skip.count(key) > 0 ||
+              holds_alternative<EntityPtr>(value) || holds_alternative<EntityList>(value))
+            continue;
+          putString(key);
+          putValue(value);
+          count++;
+        }
+        memcpy(m_out.data() + countPos, &count, sizeof(count));
+      }
+    };
+
+    using Decoder = BinaryDecoder;
+
+    /// @brief Recreate an observation from a record. Observations for data items that no longer
+    /// exist are kept as orphans so the sequence numbers remain contiguous.
+    ObservationPtr decodeObservation(Decoder &decoder,
+                                     const ObservationJournal::DataItemLookup &lookup)
+    {
+      auto sequence = decoder.get<uint64_t>();
+      auto id = decoder.getString();
+      Timestamp timestamp(Timestamp::duration(decoder.get<int64_t>()));
+      bool unavailable = decoder.get<uint8_t>() != 0;
+      auto level = decoder.get<uint8_t>();
+
+      Properties props;
+      auto count = decoder.get<uint32_t>();
+      for (uint32_t i = 0; i < count; i++)
+      {
+        auto key = decoder.getString();
+        props.insert_or_assign(key, decoder.getValue());
+      }
+
+      ObservationPtr obs;
+      if (auto di = lookup(id))
+      {
+        if (di->isCondition() && !unavailable && level != NoLevel)
+        {
+          static const string levels[] = {"NORMAL", "WARNING", "FAULT"};
+          if (level < 3)
+            props.insert_or_assign("level", levels[level]);
+        }
+
+        try
+        {
+          ErrorList errors;
+          obs = Observation::make(di, props, timestamp, errors);
+        }
+        catch (EntityError &e)
+        {
+          LOG(warning) << "ObservationJournal: cannot restore observation for " << id << ": "
+                       << e.what();
+        }
+      }
+
+      if (!obs)
+        obs = make_shared<Observation>();
+      obs->setSequence(sequence);
+      return obs;
+    }
+
+    fs::path segmentPath(const fs::path &directory, SequenceNumber_t start)
+    {
+      char name[32];
+      snprintf(name, sizeof(name), "%020llu", (unsigned long long)start);
+      return directory / (string(name) + Extension);
+    }
+  }  // namespace
+
+  ObservationJournal::ObservationJournal(const fs::path &directory, size_t segmentSize,
+                                         std::chrono::milliseconds syncInterval, size_t retain)
+    : m_directory(directory),
+      m_segmentSize(std::max(segmentSize, size_t(64 * 1024))),
+      m_syncInterval(syncInterval),
+      m_retain(retain)
+  {
+    fs::create_directories(m_directory);
+  }
+
+  ObservationJournal::~ObservationJournal() { stop(); }
+
+  optional<ObservationJournal::Recovery> ObservationJournal::recover(const DataItemLookup &lookup)
+  {
+    NAMED_SCOPE("ObservationJournal::recover");
+
+    // Find the segments and order them by their starting sequence
+    vector<pair<SequenceNumber_t, fs::path>> files;
+    for (const auto &entry : fs::directory_iterator(m_directory))
+    {
+      if (!entry.is_regular_file())
+        continue;
+
+      const auto &path = entry.path();
+      if (path.extension() == ".tmp")
+      {
+        // A segment whose checkpoint was never completed
+        fs::remove(path);
+      }
+      else if (path.extension() == Extension)
+      {
+        try
+        {
+          files.emplace_back(stoull(path.stem().string()), path);
+        }
+        catch (std::logic_error &)
+        {
+          LOG(warning) << "ObservationJournal: ignoring file " << path;
+        }
+      }
+    }
+    sort(files.begin(), files.end());
+
+    optional<Recovery> recovery;
+    SequenceNumber_t last = 0;
+    for (const auto &[start, path] : files)
+    {
+      bool complete = true;
+      try
+      {
+        ip::file_mapping mapping(path.string().c_str(), ip::read_only);
+        ip::mapped_region region(mapping, ip::read_only);
+        const char *data = static_cast<const char *>(region.get_address());
+        size_t size = region.get_size();
+
+        SegmentHeader header;
+        if (size < HeaderSize)
+          throw out_of_range("Segment header truncated");
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.m_magic, Magic, sizeof(Magic)) != 0 || header.m_version != Version)
+        {
+          LOG(warning) << "ObservationJournal: " << path << " is not a journal segment";
+          continue;
+        }
+
+        // A segment can only continue the previous segments if there is no gap, otherwise it
+        // becomes the new base checkpoint.
+        bool base = !recovery || header.m_start != last;
+        Recovery segment;
+        segment.m_instanceId = header.m_instanceId;
+        segment.m_checkpointSequence = header.m_start;
+        bool checkpointComplete = false;
+        SequenceNumber_t next = base ? header.m_start : last;
+
+        size_t offset = header.m_headerSize;
+        while (offset + RecordHeaderSize <= size)
+        {
+          uint32_t length, crc;
+          memcpy(&length, data + offset, sizeof(length));
+          memcpy(&crc, data + offset + sizeof(length), sizeof(crc));
+          if (length == 0)
+            break;
+          if (offset + RecordHeaderSize + length > size ||
+              checksum(data + offset + RecordHeaderSize, length) != crc)
+          {
+            LOG(warning) << "ObservationJournal: " << path << " is truncated at " << offset;
+            complete = false;
+            break;
+          }
+
+          Decoder decoder(data + offset + RecordHeaderSize, length);
+          offset += RecordHeaderSize + length;
+
+          auto type = decoder.get<uint8_t>();
+          if (type == CHECKPOINT_END)
+          {
+            checkpointComplete = true;
+          }
+          else if (type == CHECKPOINT)
+          {
+            if (base)
+              segment.m_checkpoint.emplace_back(decodeObservation(decoder, lookup));
+          }
+          else if (type == OBSERVATION && checkpointComplete)
+          {
+            auto obs = decodeObservation(decoder, lookup);
+            auto seq = obs->getSequence();
+            if (seq <= next)
+              continue;
+
+            // Fill any gap left by records that could not be written
+            auto &list = base ? segment.m_observations : recovery->m_observations;
+            for (++next; next < seq; ++next)
+            {
+              auto orphan = make_shared<Observation>();
+              orphan->setSequence(next);
+              list.emplace_back(orphan);
+            }
+            list.emplace_back(obs);
+          }
+        }
+
+        if (!checkpointComplete)
+        {
+          LOG(warning) << "ObservationJournal: " << path << " has an incomplete checkpoint";
+          continue;
+        }
+
+        if (base)
+          recovery = std::move(segment);
+        else
+          recovery->m_instanceId = segment.m_instanceId;
+        last = next;
+
+        m_segments.push_back({path, header.m_start});
+      }
+      catch (std::exception &e)
+      {
+        LOG(warning) << "ObservationJournal: cannot read " << path << ": " << e.what();
+        complete = false;
+      }
+
+      // Records after a damaged record cannot be trusted to be contiguous
+      if (!complete)
+        break;
+    }
+
+    if (recovery)
+    {
+      LOG(info) << "ObservationJournal: recovered " << recovery->m_observations.size()
+                << " observations from " << m_directory << " ending at sequence " << last;
+    }
+
+    return recovery;
+  }
+
+  void ObservationJournal::start(uint64_t instanceId)
+  {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (m_running)
+      return;
+
+    m_instanceId = instanceId;
+    m_running = true;
+    m_writer = std::thread([this]() { run(); });
+  }
+
+  void ObservationJournal::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_queueMutex);
+      if (!m_running)
+        return;
+      m_running = false;
+    }
+
+    m_queueCondition.notify_one();
+    if (m_writer.joinable())
+      m_writer.join();
+  }
+
+  void ObservationJournal::appendCheckpoint(SequenceNumber_t sequence, const Checkpoint &latest)
+  {
+    auto list = make_unique<ObservationList>();
+    for (const auto &[id, obs] : latest.getObservations())
+    {
+      if (obs->isOrphan())
+        continue;
+
+      // Active conditions are written oldest first so they are restored in activation order
+      if (auto cond = dynamic_pointer_cast<Condition>(obs))
+      {
+        ConditionList conditions;
+        cond->getConditionList(conditions);
+        for (auto &c : conditions)
+          list->emplace_back(c);
+      }
+      else
+      {
+        list->emplace_back(obs);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (!m_running)
+      return;
+    m_queue.push_back({nullptr, std::move(list), sequence});
+    m_checkpointRequested.store(false, std::memory_order_relaxed);
+    m_queueCondition.notify_one();
+  }
+
+  void ObservationJournal::run()
+  {
+    NAMED_SCOPE("ObservationJournal::run");
+
+    vector<Entry> entries;
+    auto next = std::chrono::steady_clock::now() + m_syncInterval;
+    bool running = true;
+    while (running)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_queueCondition.wait_until(lock, next,
+                                    [this]() { return !m_running || m_queue.size() >= BatchSize; });
+        entries.swap(m_queue);
+        running = m_running;
+      }
+
+      try
+      {
+        for (auto &entry : entries)
+          write(entry);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next || !running)
+        {
+          sync();
+          removeSegments();
+          next = now + m_syncInterval;
+        }
+      }
+      catch (std::exception &e)
+      {
+        LOG(error) << "ObservationJournal: write failed: " << e.what();
+      }
+      entries.clear();
+    }
+
+    closeSegment();
+  }
+
+  void ObservationJournal::write(Entry &entry)
+  {
+    if (entry.m_checkpoint)
+    {
+      openSegment(entry.m_sequence, *entry.m_checkpoint);
+    }
+    else if (m_region)
+    {
+      if (entry.m_observation->isOrphan())
+        return;
+
+      m_encoded.clear();
+      Encoder encoder(m_encoded);
+      encoder.putObservation(OBSERVATION, entry.m_observation);
+      writeRecord(OBSERVATION, m_encoded);
+      m_lastSequence = entry.m_sequence;
+
+      // Ask for a checkpoint to start the next segment. The segment grows until it arrives.
+      if (m_offset >= m_segmentSize && !m_checkpointRequested.load(std::memory_order_relaxed))
+        m_checkpointRequested.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void ObservationJournal::writeRecord(uint8_t type, const string &payload)
+  {
+    auto needed = RecordHeaderSize + payload.size();
+    if (m_offset + needed + RecordHeaderSize > m_size)
+      grow(needed + RecordHeaderSize);
+
+    // The length is written last so a partial record reads as the end of the segment
+    char *dest = static_cast<char *>(m_region->get_address()) + m_offset;
+    uint32_t length = uint32_t(payload.size());
+    uint32_t crc = checksum(payload.data(), payload.size());
+    memcpy(dest + RecordHeaderSize, payload.data(), payload.size());
+    memcpy(dest + sizeof(length), &crc, sizeof(crc));
+    memcpy(dest, &length, sizeof(length));
+    m_offset += needed;
+  }
+
+  void ObservationJournal::openSegment(SequenceNumber_t start, const ObservationList &checkpoint)
+  {
+    NAMED_SCOPE("ObservationJournal::openSegment");
+
+    closeSegment();
+
+    // The segment is written to a temporary file until the checkpoint is complete
+    auto path = segmentPath(m_directory, start);
+    auto temp = path;
+    temp += ".tmp";
+    {
+      std::ofstream file(temp, ios::binary | ios::trunc);
+    }
+    fs::resize_file(temp, m_segmentSize);
+    map(temp);
+
+    SegmentHeader header {};
+    memcpy(header.m_magic, Magic, sizeof(Magic));
+    header.m_version = Version;
+    header.m_headerSize = HeaderSize;
+    header.m_instanceId = m_instanceId;
+    header.m_start = start;
+    memcpy(m_region->get_address(), &header, sizeof(header));
+    m_offset = HeaderSize;
+    m_synced = 0;
+
+    for (const auto &obs : checkpoint)
+    {
+      if (obs->isOrphan())
+        continue;
+      m_encoded.clear();
+      Encoder encoder(m_encoded);
+      encoder.putObservation(CHECKPOINT, obs);
+      writeRecord(CHECKPOINT, m_encoded);
+    }
+    m_encoded.assign(1, char(CHECKPOINT_END));
+    writeRecord(CHECKPOINT_END, m_encoded);
+    sync();
+
+    // Remap under the final name. Replaces a segment starting at the same sequence.
+    m_region.reset();
+    m_mapping.reset();
+    fs::rename(temp, path);
+    map(path);
+
+    m_segments.erase(remove_if(m_segments.begin(), m_segments.end(),
+                               [&path](const Segment &s) { return s.m_path == path; }),
+                     m_segments.end());
+    m_segments.push_back({path, start});
+    m_lastSequence = start;
+
+    removeSegments();
+  }
+
+  void ObservationJournal::closeSegment()
+  {
+    if (m_region)
+    {
+      sync();
+      m_region.reset();
+      m_mapping.reset();
+    }
+  }
+
+  void ObservationJournal::map(const fs::path &path)
+  {
+    m_path = path;
+    m_size = fs::file_size(path);
+    m_mapping = make_unique<ip::file_mapping>(path.string().c_str(), ip::read_write);
+    m_region = make_unique<ip::mapped_region>(*m_mapping, ip::read_write);
+  }
+
+  void ObservationJournal::grow(size_t needed)
+  {
+    sync();
+    m_region.reset();
+    m_mapping.reset();
+
+    auto size = m_size + std::max(m_segmentSize, needed);
+    fs::resize_file(m_path, size);
+    map(m_path);
+  }
+
+  void ObservationJournal::sync()
+  {
+    if (m_region && m_offset > m_synced)
+    {
+      m_region->flush(m_synced, m_offset - m_synced, false);
+      m_synced = m_offset;
+    }
+  }
+
+  void ObservationJournal::removeSegments()
+  {
+    // A segment is no longer needed once the next segment starts before the sliding window
+    while (m_segments.size() > 1 && m_segments[1].m_start + m_retain <= m_lastSequence)
+    {
+      std::error_code ec;
+      fs::remove(m_segments.front().m_path, ec);
+      if (ec)
+        LOG(warning) << "ObservationJournal: cannot remove " << m_segments.front().m_path << ": "
+                     << ec.message();
+      m_segments.pop_front();
+    }
+  }
+}  // namespace mtconnect::buffer
@@ -0,0 +1,170 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "checkpoint.hpp"
+#include "mtconnect/config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace boost::interprocess {
+  class file_mapping;
+  class mapped_region;
+}  // namespace boost::interprocess
+
+namespace mtconnect::buffer {
+  /// @brief Append-only memory mapped journal of the observations added to the circular buffer
+  ///
+  /// The journal is a directory of segment files. Each segment begins with a checkpoint of the
+  /// latest observations followed by every observation added after the checkpoint in sequence
+  /// order. When a segment reaches its target size the journal asks the buffer for a new
+  /// checkpoint and starts the next segment. Segments are removed once the following segments
+  /// cover the whole sliding window.
+  ///
+  /// Observations are queued by the buffer and encoded, written, and synced by a writer thread at
+  /// the sync interval so several observations are committed together. Every record carries a
+  /// CRC so a torn write at the end of the journal is discarded when it is recovered.
+  class AGENT_LIB_API ObservationJournal
+  {
+  public:
+    /// @brief Function to resolve data item ids when recovering observations
+    using DataItemLookup = std::function<DataItemPtr(const std::string &id)>;
+
+    /// @brief The state recovered from the journal
+    struct Recovery
+    {
+      uint64_t m_instanceId {0};                     ///< Instance id of the agent that wrote it
+      SequenceNumber_t m_checkpointSequence {0};     ///< Sequence of the base checkpoint
+      observation::ObservationList m_checkpoint;     ///< Latest observations at the checkpoint
+      observation::ObservationList m_observations;   ///< Observations after the checkpoint
+    };
+
+    /// @brief Create a journal
+    /// @param[in] directory the directory for the segment files
+    /// @param[in] segmentSize the target size of a segment in bytes
+    /// @param[in] syncInterval how often written records are synced to disk
+    /// @param[in] retain number of observations that must be recoverable, the buffer size
+    ObservationJournal(const std::filesystem::path &directory, size_t segmentSize,
+                       std::chrono::milliseconds syncInterval, size_t retain);
+    ~ObservationJournal();
+
+    /// @brief Read the existing segments
+    /// @param[in] lookup function to find the data items by id
+    /// @return the recovered state if there is a valid journal
+    std::optional<Recovery> recover(const DataItemLookup &lookup);
+
+    /// @brief start the writer thread
+    /// @param[in] instanceId the instance id written to new segments
+    void start(uint64_t instanceId);
+    /// @brief write all queued observations, sync, and stop the writer thread
+    void stop();
+
+    /// @brief Queue an observation to be written. Called with the buffer locked.
+    /// @param[in] observation the observation with its sequence number set
+    void append(const observation::ObservationPtr &observation)
+    {
+      std::lock_guard<std::mutex> lock(m_queueMutex);
+      if (!m_running)
+        return;
+      m_queue.push_back({observation, nullptr, observation->getSequence()});
+      if (m_queue.size() == BatchSize)
+        m_queueCondition.notify_one();
+    }
+
+    /// @brief Queue a checkpoint to start a new segment. Called with the buffer locked.
+    /// @param[in] sequence the sequence number of the last observation in the checkpoint
+    /// @param[in] latest the latest checkpoint of the buffer
+    void appendCheckpoint(SequenceNumber_t sequence, const Checkpoint &latest);
+
+    /// @brief check if the writer needs a checkpoint to start a new segment
+    /// @return `true` if the buffer should call `appendCheckpoint()`
+    bool isCheckpointRequested() const
+    {
+      return m_checkpointRequested.load(std::memory_order_relaxed);
+    }
+
+    /// @brief get the directory of the journal
+    const auto &getDirectory() const { return m_directory; }
+
+    /// @brief Number of queued observations that wakes the writer before the sync interval
+    static constexpr size_t BatchSize {4096};
+
+  protected:
+    struct Entry
+    {
+      observation::ObservationPtr m_observation;
+      std::unique_ptr<observation::ObservationList> m_checkpoint;
+      SequenceNumber_t m_sequence;
+    };
+
+    struct Segment
+    {
+      std::filesystem::path m_path;
+      SequenceNumber_t m_start;
+    };
+
+    void run();
+    void write(Entry &entry);
+    void writeRecord(uint8_t type, const std::string &payload);
+    void openSegment(SequenceNumber_t start, const observation::ObservationList &checkpoint);
+    void closeSegment();
+    void map(const std::filesystem::path &path);
+    void grow(size_t needed);
+    void sync();
+    void removeSegments();
+
+  protected:
+    std::filesystem::path m_directory;
+    size_t m_segmentSize;
+    std::chrono::milliseconds m_syncInterval;
+    size_t m_retain;
+    uint64_t m_instanceId {0};
+
+    // Queue shared with the buffer
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::vector<Entry> m_queue;
+    bool m_running {false};
+    std::atomic_bool m_checkpointRequested {false};
+    std::thread m_writer;
+
+    // Writer thread state
+    std::deque<Segment> m_segments;
+    std::unique_ptr<boost::interprocess::file_mapping> m_mapping;
+    std::unique_ptr<boost::interprocess::mapped_region> m_region;
+    std::filesystem::path m_path;
+    size_t m_size {0};
+    size_t m_offset {0};
+    size_t m_synced {0};
+    SequenceNumber_t m_lastSequence {0};
+    std::string m_encoded;
+  };
+}  // namespace mtconnect::buffer
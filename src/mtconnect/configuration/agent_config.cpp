@@ -435,6 +435,7 @@ namespace mtconnect::configuration {
   {
     for (auto &[channelName, logChannel] : m_logChannels)
       logChannel.m_logLevel = level;
+    logging::MinimumLevel = level;
   }
 
   static logr::trivial::severity_level StringToLogLevel(const std::string &level)
@@ -535,12 +536,32 @@ namespace mtconnect::configuration {
                          {"file_name", defaultFileName},
                          {"archive_pattern", defaultArchivePattern}});
     AddOptions(logger, options,
-               {{"output", string()}, {"level", string()}, {"logging_level", string()}});
+               {{"output", string()},
+                {"level", string()},
+                {"logging_level", string()},
+                {"hot_path_scopes", true},
+                {"trace_sampling", 0}});
 
     auto output = GetOption<string>(options, "output");
     auto level = StringToLogLevel(
         GetOption<string>(options, "level")
             .value_or(GetOption<string>(options, "logging_level").value_or("info"s)));
+    if (m_isDebug && level >= severity_level::debug)
+      level = severity_level::debug;
+
+    // The LOG macros check the agent channel level before a record is created. When trace
+    // sampling is on the sink lets everything through and the sampled statements are the only
+    // ones below the level that reach it.
+    auto sinkLevel = level;
+    if (channelName == "agent")
+    {
+      auto sampling = GetOption<int>(options, "trace_sampling").value_or(0);
+      logging::MinimumLevel = level;
+      logging::HotPathScopes = GetOption<bool>(options, "hot_path_scopes").value_or(true);
+      logging::SampleInterval = uint32_t(std::max(sampling, 0));
+      if (sampling > 0)
+        sinkLevel = severity_level::trace;
+    }
 
     if (m_isDebug || (output && (*output == "cout" || *output == "cerr")))
     {
@@ -550,9 +571,6 @@ namespace mtconnect::configuration {
       else
         out = &std::cout;
 
-      if (m_isDebug && level >= severity_level::debug)
-        level = severity_level::debug;
-
       auto sink = boost::make_shared<console_sink>();
       logChannel.m_logSink = sink;
       logChannel.m_logLevel = level;
@@ -564,7 +582,7 @@ namespace mtconnect::configuration {
 
       sink->set_formatter(formatter.value());
       sink->set_filter(expr::attr<std::string>("Channel") == logChannel.m_channelName &&
-                       severity >= logChannel.m_logLevel);
+                       severity >= sinkLevel);
 
       logr::core::get()->add_sink(sink);
       return;
@@ -687,7 +705,7 @@ namespace mtconnect::configuration {
 
     sink->set_formatter(formatter.value());
     sink->set_filter(expr::attr<std::string>("Channel") == logChannel.m_channelName &&
-                     severity >= logChannel.m_logLevel);
+                     severity >= sinkLevel);
 
     // Formatter for the logger
     logr::core::get()->add_sink(sink);
@@ -820,12 +838,19 @@ namespace mtconnect::configuration {
                 {configuration::ConfigPath, StringList()},
                 {configuration::ServerIp, "0.0.0.0"s},
                 {configuration::Devices, "Devices.xml"s},
+                {configuration::DeviceCachePath, ""s},
                 {configuration::BufferSize, int(DEFAULT_SLIDING_BUFFER_EXP)},
                 {configuration::MaxAssets, int(DEFAULT_MAX_ASSETS)},
+                {configuration::AssetStoragePath, ""s},
                 {configuration::CheckpointFrequency, 1000},
+                {configuration::EnableMetrics, false},
+                {configuration::JournalPath, ""s},
+                {configuration::JournalSegmentSize, "64M"s},
+                {configuration::JournalSyncInterval, 250ms},
                 {configuration::LegacyTimeout, 600s},
                 {configuration::CreateUniqueIds, false},
                 {configuration::ReconnectInterval, 10000ms},
+                {configuration::ReceiveBufferSize, "1M"s},
                 {configuration::IgnoreTimestamps, false},
                 {configuration::ConversionRequired, true},
                 {configuration::JsonVersion, 2},
@@ -1029,6 +1054,7 @@ namespace mtconnect::configuration {
                     {configuration::Host, string()},
                     {configuration::Port, int32_t()},
                     {configuration::Heartbeat, std::chrono::milliseconds()},
+                    {configuration::CaptureFile, string()},
                     {configuration::Uuid, string()}});
 
         if (HasOption(adapterOptions, configuration::Uuid) &&
@@ -1158,7 +1184,8 @@ namespace mtconnect::configuration {
                  {{"Module", string()},
                   {"Initialization", string()},
                   {"module", string()},
-                  {"initialization", string()}});
+                  {"initialization", string()},
+                  {"VirtualMachines", 1}});
     }
     m_ruby = make_unique<ruby::Embedded>(this, rubyOptions);
   }
@@ -46,11 +46,17 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(DisableAgentDevice);
     DECLARE_CONFIGURATION(AllowPut);
     DECLARE_CONFIGURATION(AllowPutFrom);
+    DECLARE_CONFIGURATION(AssetStoragePath);
     DECLARE_CONFIGURATION(BufferSize);
     DECLARE_CONFIGURATION(CheckpointFrequency);
+    DECLARE_CONFIGURATION(DeviceCachePath);
     DECLARE_CONFIGURATION(Devices);
+    DECLARE_CONFIGURATION(EnableMetrics);
     DECLARE_CONFIGURATION(HttpHeaders);
     DECLARE_CONFIGURATION(JsonVersion);
+    DECLARE_CONFIGURATION(JournalPath);
+    DECLARE_CONFIGURATION(JournalSegmentSize);
+    DECLARE_CONFIGURATION(JournalSyncInterval);
     DECLARE_CONFIGURATION(LogStreams);
     DECLARE_CONFIGURATION(MaxAssets);
     DECLARE_CONFIGURATION(MaxCachedFileSize);
@@ -89,6 +95,7 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(CurrentTopic);
     DECLARE_CONFIGURATION(SampleTopic);
     DECLARE_CONFIGURATION(MqttCurrentInterval);
+    DECLARE_CONFIGURATION(MqttCurrentDelta);
     DECLARE_CONFIGURATION(MqttSampleInterval);
     DECLARE_CONFIGURATION(MqttSampleCount);
     DECLARE_CONFIGURATION(MqttCaCert);
@@ -105,6 +112,7 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(MqttUserName);
     DECLARE_CONFIGURATION(MqttPassword);
     DECLARE_CONFIGURATION(MqttMaxTopicDepth);
+    DECLARE_CONFIGURATION(MqttMaxQueuedMessages);
     DECLARE_CONFIGURATION(MqttLastWillTopic);
     DECLARE_CONFIGURATION(MqttXPath);
     DECLARE_CONFIGURATION(ObservationTopicPrefix);
@@ -117,9 +125,11 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(AdapterIdentity);
     DECLARE_CONFIGURATION(AdditionalDevices);
     DECLARE_CONFIGURATION(AutoAvailable);
+    DECLARE_CONFIGURATION(CaptureFile);
     DECLARE_CONFIGURATION(ConversionRequired);
     DECLARE_CONFIGURATION(Count);
     DECLARE_CONFIGURATION(Device);
+    DECLARE_CONFIGURATION(EnableCompression);
     DECLARE_CONFIGURATION(FilterDuplicates);
     DECLARE_CONFIGURATION(Heartbeat);
     DECLARE_CONFIGURATION(Host);
@@ -131,6 +141,7 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(PreserveUUID);
     DECLARE_CONFIGURATION(Protocol);
     DECLARE_CONFIGURATION(RealTime);
+    DECLARE_CONFIGURATION(ReceiveBufferSize);
     DECLARE_CONFIGURATION(ReconnectInterval);
     DECLARE_CONFIGURATION(RelativeTime);
     DECLARE_CONFIGURATION(SerialNumber);
@@ -143,6 +154,7 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(Uuid);
     DECLARE_CONFIGURATION(UpcaseDataItemValue);
     DECLARE_CONFIGURATION(Url);
+    DECLARE_CONFIGURATION(UseJson);
     DECLARE_CONFIGURATION(UsePolling);
     ///@}
 
@@ -153,6 +153,9 @@ namespace mtconnect {
           m_specialClass = ASSET_CHANGED_CLS;
         else if (type == "ASSET_ADDED")
           m_specialClass = ASSET_ADDED_CLS;
+
+        // Resolve the vocabulary once instead of for every observation
+        m_vocabulary = validation::observations::FindVocabulary(m_observationName);
       }
       else if (category == "CONDITION")
       {
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 
 #include "constraints.hpp"
@@ -26,6 +27,7 @@
 #include "mtconnect/device_model/component.hpp"
 #include "mtconnect/observation/change_observer.hpp"
 #include "mtconnect/utilities.hpp"
+#include "mtconnect/validation/observations.hpp"
 #include "relationships.hpp"
 #include "source.hpp"
 #include "unit_conversion.hpp"
@@ -130,6 +132,9 @@ namespace mtconnect {
         /// @brief get the pascalized name for the data item when represented as a observation
         /// @return observation name
         const auto &getObservationName() const { return m_observationName; }
+        /// @brief get the controlled vocabulary for the event observations
+        /// @return the vocabulary or `nullptr` if the event is not known or not an event
+        const auto *getControlledVocabulary() const { return m_vocabulary; }
         /// @brief get the properties to build an observation
         /// @return observation properties
         const auto &getObservationProperties() const { return m_observatonProperties; }
@@ -150,6 +155,23 @@ namespace mtconnect {
         SpecialClass getSpecialClass() const { return m_specialClass; }
 
         const auto &getConstantValue() const { return m_constantValue; }
+
+        /// @brief get the sequence number of the latest observation added to the buffer
+        ///
+        /// Can be read without holding the buffer lock to check if pipeline local state is
+        /// still current.
+        ///
+        /// @return the sequence number, `0` if no observation has been added
+        SequenceNumber_t getLatestSequence() const
+        {
+          return m_latestSequence.load(std::memory_order_acquire);
+        }
+        /// @brief set the sequence of the latest observation. Only called by the buffer.
+        /// @param[in] seq the sequence number
+        void setLatestSequence(SequenceNumber_t seq)
+        {
+          m_latestSequence.store(seq, std::memory_order_release);
+        }
         ///@}
 
         /// @brief make this data item a constant
@@ -300,6 +322,7 @@ namespace mtconnect {
         // Type for observation
         entity::QName m_observationName;
         entity::Properties m_observatonProperties;
+        const validation::observations::Vocabulary *m_vocabulary {nullptr};
 
         // Representation of data item
         Representation m_representation {VALUE};
@@ -309,6 +332,9 @@ namespace mtconnect {
         // The reset trigger;
         std::string m_resetTrigger;
 
+        // Sequence of the latest observation in the buffer
+        std::atomic<SequenceNumber_t> m_latestSequence {0};
+
         // Component that data item is associated with
         std::weak_ptr<Component> m_component;
         std::weak_ptr<Composition> m_composition;
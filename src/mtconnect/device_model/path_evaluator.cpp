@@ -0,0 +1,660 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "path_evaluator.hpp"
+
+#include <cctype>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+
+#include "mtconnect/entity/entity.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect {
+  using namespace entity;
+  namespace device_model {
+    namespace {
+      /// @brief Recursive descent parser for the supported XPath subset
+      class PathParser
+      {
+      public:
+        PathParser(string_view text) : m_text(text) {}
+
+        bool parse(vector<PathEvaluator::LocationPath> &paths)
+        {
+          do
+          {
+            PathEvaluator::LocationPath path;
+            if (!parsePath(path))
+              return false;
+            paths.emplace_back(std::move(path));
+          } while (consume('|'));
+
+          skip();
+          return m_pos == m_text.size();
+        }
+
+      protected:
+        void skip()
+        {
+          while (m_pos < m_text.size() && isspace(m_text[m_pos]))
+            m_pos++;
+        }
+
+        bool atEnd()
+        {
+          skip();
+          return m_pos >= m_text.size();
+        }
+
+        char peek()
+        {
+          skip();
+          return m_pos < m_text.size() ? m_text[m_pos] : '\0';
+        }
+
+        bool consume(string_view token)
+        {
+          skip();
+          if (m_text.substr(m_pos, token.size()) == token)
+          {
+            m_pos += token.size();
+            return true;
+          }
+          return false;
+        }
+
+        bool consume(char c)
+        {
+          if (peek() == c)
+          {
+            m_pos++;
+            return true;
+          }
+          return false;
+        }
+
+        static bool isNameStart(char c) { return isalpha(c) || c == '_'; }
+        static bool isNameChar(char c) { return isalnum(c) || c == '_' || c == '-' || c == '.'; }
+
+        optional<string> name()
+        {
+          skip();
+          if (m_pos >= m_text.size() || !isNameStart(m_text[m_pos]))
+            return nullopt;
+          auto start = m_pos;
+          while (m_pos < m_text.size() && isNameChar(m_text[m_pos]))
+            m_pos++;
+          return string(m_text.substr(start, m_pos - start));
+        }
+
+        bool keyword(string_view word)
+        {
+          skip();
+          auto end = m_pos + word.size();
+          if (m_text.substr(m_pos, word.size()) == word &&
+              (end >= m_text.size() || !isNameChar(m_text[end])))
+          {
+            m_pos = end;
+            return true;
+          }
+          return false;
+        }
+
+        bool parsePath(PathEvaluator::LocationPath &path)
+        {
+          bool descendant = false;
+          if (consume("//"))
+          {
+            path.m_absolute = true;
+            descendant = true;
+          }
+          else if (consume('/'))
+          {
+            path.m_absolute = true;
+            // A lone slash selects the document
+            if (atEnd() || peek() == '|')
+              return true;
+          }
+
+          while (true)
+          {
+            PathEvaluator::Step step;
+            if (!parseStep(step, descendant))
+              return false;
+            path.m_steps.emplace_back(std::move(step));
+
+            if (consume("//"))
+              descendant = true;
+            else if (consume('/'))
+              descendant = false;
+            else
+              return true;
+          }
+        }
+
+        bool parseStep(PathEvaluator::Step &step, bool descendant)
+        {
+          step.m_descendant = descendant;
+
+          if (consume(".."))
+            return false;
+          if (consume('.'))
+          {
+            step.m_axis = PathEvaluator::Axis::SELF;
+            step.m_anyNode = true;
+            return true;
+          }
+
+          if (!parseNameTest(step))
+            return false;
+
+          while (consume('['))
+          {
+            PathEvaluator::Predicate pred;
+            if (!parseOr(pred) || !consume(']'))
+              return false;
+            step.m_predicates.emplace_back(std::move(pred));
+          }
+
+          return true;
+        }
+
+        bool parseNameTest(PathEvaluator::Step &step)
+        {
+          if (consume('*'))
+            return true;
+
+          auto first = name();
+          if (!first)
+            return false;
+
+          if (consume("::"))
+          {
+            using Axis = PathEvaluator::Axis;
+            if (*first == "child")
+              step.m_axis = Axis::CHILD;
+            else if (*first == "descendant")
+              step.m_axis = Axis::DESCENDANT;
+            else if (*first == "descendant-or-self")
+              step.m_axis = Axis::DESCENDANT_OR_SELF;
+            else if (*first == "self")
+              step.m_axis = Axis::SELF;
+            else
+              return false;
+
+            if (consume('*'))
+              return true;
+            first = name();
+            if (!first)
+              return false;
+          }
+
+          // The MTConnect namespace is the only prefix that can be resolved without the document
+          if (m_pos < m_text.size() && m_text[m_pos] == ':')
+          {
+            if (*first != "m")
+              return false;
+            m_pos++;
+            if (m_pos < m_text.size() && m_text[m_pos] == '*')
+            {
+              m_pos++;
+              return true;
+            }
+            first = name();
+            if (!first)
+              return false;
+          }
+
+          // Node tests and functions are not supported
+          if (peek() == '(')
+            return false;
+
+          step.m_name = std::move(first);
+          return true;
+        }
+
+        bool parseOr(PathEvaluator::Predicate &pred)
+        {
+          using Predicate = PathEvaluator::Predicate;
+          Predicate left;
+          if (!parseAnd(left))
+            return false;
+          if (!keyword("or"))
+          {
+            pred = std::move(left);
+            return true;
+          }
+
+          pred.m_op = Predicate::OR;
+          pred.m_operands.emplace_back(std::move(left));
+          do
+          {
+            Predicate right;
+            if (!parseAnd(right))
+              return false;
+            pred.m_operands.emplace_back(std::move(right));
+          } while (keyword("or"));
+
+          return true;
+        }
+
+        bool parseAnd(PathEvaluator::Predicate &pred)
+        {
+          using Predicate = PathEvaluator::Predicate;
+          Predicate left;
+          if (!parsePrimary(left))
+            return false;
+          if (!keyword("and"))
+          {
+            pred = std::move(left);
+            return true;
+          }
+
+          pred.m_op = Predicate::AND;
+          pred.m_operands.emplace_back(std::move(left));
+          do
+          {
+            Predicate right;
+            if (!parsePrimary(right))
+              return false;
+            pred.m_operands.emplace_back(std::move(right));
+          } while (keyword("and"));
+
+          return true;
+        }
+
+        bool parsePrimary(PathEvaluator::Predicate &pred)
+        {
+          using Predicate = PathEvaluator::Predicate;
+          if (consume('('))
+            return parseOr(pred) && consume(')');
+
+          if (!consume('@'))
+            return false;
+          auto attr = name();
+          if (!attr || (m_pos < m_text.size() && m_text[m_pos] == ':'))
+            return false;
+          pred.m_attribute = std::move(*attr);
+
+          if (consume("!="))
+            pred.m_op = Predicate::NOT_EQUAL;
+          else if (consume('='))
+            pred.m_op = Predicate::EQUAL;
+          else
+          {
+            pred.m_op = Predicate::EXISTS;
+            return true;
+          }
+
+          auto quote = peek();
+          if (quote != '\'' && quote != '"')
+            return false;
+          auto end = m_text.find(quote, m_pos + 1);
+          if (end == string_view::npos)
+            return false;
+          pred.m_value = string(m_text.substr(m_pos + 1, end - m_pos - 1));
+          m_pos = end + 1;
+
+          return true;
+        }
+
+      protected:
+        string_view m_text;
+        size_t m_pos {0};
+      };
+
+      /// @brief A node in the document the XML printer would generate for the devices
+      struct Node
+      {
+        enum Kind
+        {
+          DOCUMENT,
+          ROOT,
+          HEADER,
+          DEVICES,
+          ENTITY,
+          LEAF
+        };
+
+        Kind m_kind;
+        const Entity *m_entity {nullptr};
+        const PropertyKey *m_key {nullptr};
+
+        const void *identity() const
+        {
+          static const char kinds[4] {};
+          if (m_kind == ENTITY)
+            return m_entity;
+          else if (m_kind == LEAF)
+            return m_key;
+          else
+            return &kinds[m_kind];
+        }
+
+        bool is(const char *name) const
+        {
+          return m_kind == ENTITY && !m_entity->getName().hasNs() && m_entity->getName() == name;
+        }
+      };
+
+      using NodeFunction = function<void(const Node &)>;
+
+      /// @brief Walks the device model using the element structure of the XML printer
+      class DocumentWalker
+      {
+      public:
+        DocumentWalker(const list<DevicePtr> &devices) : m_devices(devices) {}
+
+        void children(const Node &node, const NodeFunction &fun) const
+        {
+          switch (node.m_kind)
+          {
+            case Node::DOCUMENT:
+              fun(Node {Node::ROOT});
+              break;
+
+            case Node::ROOT:
+              fun(Node {Node::HEADER});
+              fun(Node {Node::DEVICES});
+              break;
+
+            case Node::DEVICES:
+              for (const auto &device : m_devices)
+                fun(Node {Node::ENTITY, device.get()});
+              break;
+
+            case Node::ENTITY:
+            {
+              const auto *entity = node.m_entity;
+              const auto &attrs = entity->getAttributes();
+              for (const auto &[key, value] : entity->getProperties())
+              {
+                if (entity->isHidden(key) || islower(key.getName()[0]) || attrs.count(key) > 0 ||
+                    key == "VALUE" || key == "RAW")
+                  continue;
+
+                visit(overloaded {[&fun](const EntityPtr &child) {
+                                    fun(Node {Node::ENTITY, child.get()});
+                                  },
+                                  [&fun](const EntityList &list) {
+                                    for (const auto &child : list)
+                                      fun(Node {Node::ENTITY, child.get()});
+                                  },
+                                  [&fun, &key](const auto &) {
+                                    fun(Node {Node::LEAF, nullptr, &key});
+                                  }},
+                      value);
+              }
+              break;
+            }
+
+            case Node::HEADER:
+            case Node::LEAF:
+              break;
+          }
+        }
+
+        void descendants(const Node &node, const NodeFunction &fun) const
+        {
+          children(node, [this, &fun](const Node &child) {
+            fun(child);
+            descendants(child, fun);
+          });
+        }
+
+        optional<string> attribute(const Node &node, const string &name) const
+        {
+          if (node.m_kind != Node::ENTITY)
+            return nullopt;
+
+          const auto *entity = node.m_entity;
+          const auto &properties = entity->getProperties();
+          auto it = properties.find(name);
+          if (it == properties.end() || entity->isHidden(it->first) ||
+              !(islower(it->first.getName()[0]) || entity->getAttributes().count(it->first) > 0))
+            return nullopt;
+
+          if (holds_alternative<string>(it->second))
+            return get<string>(it->second);
+
+          Value conv = it->second;
+          ConvertValueToType(conv, ValueType::STRING);
+          return get<string>(conv);
+        }
+
+        bool matches(const Node &node, const PathEvaluator::Step &step) const
+        {
+          if (step.m_anyNode)
+            return true;
+          if (node.m_kind == Node::DOCUMENT)
+            return false;
+          if (!step.m_name)
+            return true;
+
+          const auto &name = *step.m_name;
+          switch (node.m_kind)
+          {
+            case Node::ROOT:
+              return name == "MTConnectDevices";
+
+            case Node::HEADER:
+              return name == "Header";
+
+            case Node::DEVICES:
+              return name == "Devices";
+
+            case Node::ENTITY:
+              // Elements in other namespaces can only be selected with a prefix
+              return !node.m_entity->getName().hasNs() && node.m_entity->getName() == name;
+
+            case Node::LEAF:
+              return !node.m_key->hasNs() && *node.m_key == name;
+
+            default:
+              return false;
+          }
+        }
+
+        bool test(const Node &node, const PathEvaluator::Predicate &pred) const
+        {
+          using Predicate = PathEvaluator::Predicate;
+          switch (pred.m_op)
+          {
+            case Predicate::EXISTS:
+              return attribute(node, pred.m_attribute).has_value();
+
+            case Predicate::EQUAL:
+            {
+              auto value = attribute(node, pred.m_attribute);
+              return value && *value == pred.m_value;
+            }
+
+            case Predicate::NOT_EQUAL:
+            {
+              auto value = attribute(node, pred.m_attribute);
+              return value && *value != pred.m_value;
+            }
+
+            case Predicate::AND:
+              for (const auto &operand : pred.m_operands)
+                if (!test(node, operand))
+                  return false;
+              return true;
+
+            case Predicate::OR:
+              for (const auto &operand : pred.m_operands)
+                if (test(node, operand))
+                  return true;
+              return false;
+          }
+
+          return false;
+        }
+
+        vector<Node> step(const vector<Node> &context, const PathEvaluator::Step &step) const
+        {
+          using Axis = PathEvaluator::Axis;
+
+          // `//` expands the context with descendant-or-self::node()
+          const vector<Node> *input = &context;
+          vector<Node> expanded;
+          if (step.m_descendant)
+          {
+            for (const auto &node : context)
+            {
+              expanded.emplace_back(node);
+              descendants(node, [&expanded](const Node &n) { expanded.emplace_back(n); });
+            }
+            input = &expanded;
+          }
+
+          vector<Node> result;
+          unordered_set<const void *> seen;
+          auto add = [this, &step, &result, &seen](const Node &node) {
+            if (matches(node, step))
+            {
+              for (const auto &pred : step.m_predicates)
+                if (!test(node, pred))
+                  return;
+              if (seen.insert(node.identity()).second)
+                result.emplace_back(node);
+            }
+          };
+
+          for (const auto &node : *input)
+          {
+            switch (step.m_axis)
+            {
+              case Axis::CHILD:
+                children(node, add);
+                break;
+
+              case Axis::DESCENDANT:
+                descendants(node, add);
+                break;
+
+              case Axis::DESCENDANT_OR_SELF:
+                add(node);
+                descendants(node, add);
+                break;
+
+              case Axis::SELF:
+                add(node);
+                break;
+            }
+          }
+
+          return result;
+        }
+
+        /// @brief map a selected node to data item ids the same way as `XmlParser::getDataItems()`
+        void collect(const Node &node, FilterSet &filter, unordered_set<string> &visited) const
+        {
+          if (node.is("DataItem"))
+          {
+            if (auto id = attribute(node, "id"))
+              filter.insert(*id);
+          }
+          else if (node.is("DataItems"))
+          {
+            children(node, [this, &filter](const Node &child) {
+              if (child.is("DataItem"))
+                if (auto id = attribute(child, "id"))
+                  filter.insert(*id);
+            });
+          }
+          else if (node.is("Reference"))
+          {
+            if (auto id = attribute(node, "dataItemId"); id && !id->empty())
+              filter.insert(*id);
+          }
+          else if (node.is("DataItemRef"))
+          {
+            if (auto id = attribute(node, "idRef"); id && !id->empty())
+              filter.insert(*id);
+          }
+          else if (node.is("ComponentRef"))
+          {
+            auto id = attribute(node, "idRef");
+            if (id && visited.insert(*id).second)
+            {
+              descendants(Node {Node::DOCUMENT},
+                          [this, &id, &filter, &visited](const Node &target) {
+                            if (attribute(target, "id") == id)
+                              collect(target, filter, visited);
+                          });
+            }
+          }
+          else
+          {
+            // Find all the data items and references below the children of this node
+            children(node, [this, &filter, &visited](const Node &child) {
+              descendants(child, [this, &filter, &visited](const Node &n) {
+                if (n.is("DataItem") || n.is("Reference") || n.is("DataItemRef") ||
+                    n.is("ComponentRef"))
+                  collect(n, filter, visited);
+              });
+            });
+          }
+        }
+
+      protected:
+        const list<DevicePtr> &m_devices;
+      };
+    }  // namespace
+
+    optional<PathEvaluator> PathEvaluator::compile(const string &path)
+    {
+      PathEvaluator evaluator;
+      PathParser parser(path);
+      if (!parser.parse(evaluator.m_paths))
+      {
+        LOG(trace) << "PathEvaluator: path is not supported, will use xpath: " << path;
+        return nullopt;
+      }
+
+      return evaluator;
+    }
+
+    void PathEvaluator::evaluate(const list<DevicePtr> &devices, FilterSet &filter) const
+    {
+      NAMED_SCOPE("PathEvaluator::evaluate");
+
+      DocumentWalker walker(devices);
+      unordered_set<string> visited;
+
+      for (const auto &path : m_paths)
+      {
+        // Relative paths are evaluated from the root element
+        vector<Node> nodes {Node {path.m_absolute ? Node::DOCUMENT : Node::ROOT}};
+        for (const auto &step : path.m_steps)
+        {
+          nodes = walker.step(nodes, step);
+          if (nodes.empty())
+            break;
+        }
+
+        for (const auto &node : nodes)
+          walker.collect(node, filter, visited);
+      }
+    }
+  }  // namespace device_model
+}  // namespace mtconnect
@@ -0,0 +1,106 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::device_model {
+  /// @brief Evaluates the subset of XPath used to filter data items directly against the device
+  /// model.
+  ///
+  /// The devices are walked as if they were the `MTConnectDevices` document produced by the XML
+  /// printer, so the results match `XmlParser::getDataItems()` for the supported expressions:
+  /// unions (`|`), absolute and relative location paths with `/` and `//`, the `child`,
+  /// `descendant`, `descendant-or-self`, and `self` axes, `.`, name tests with `*` or an optional
+  /// `m:` prefix, and attribute predicates (`[@a]`, `[@a='v']`, `[@a!='v']`) combined with `and`,
+  /// `or`, and parentheses.
+  ///
+  /// Anything else, such as other namespace prefixes, positional predicates, or functions, fails
+  /// to compile and the caller must fall back to the libxml2 evaluator.
+  class AGENT_LIB_API PathEvaluator
+  {
+  public:
+    /// @brief The supported axes
+    enum class Axis
+    {
+      CHILD,
+      DESCENDANT,
+      DESCENDANT_OR_SELF,
+      SELF
+    };
+
+    /// @brief An attribute predicate expression
+    struct Predicate
+    {
+      enum Op
+      {
+        EXISTS,
+        EQUAL,
+        NOT_EQUAL,
+        AND,
+        OR
+      };
+
+      Op m_op {EXISTS};
+      std::string m_attribute;
+      std::string m_value;
+      std::vector<Predicate> m_operands;
+    };
+
+    /// @brief One step in a location path
+    struct Step
+    {
+      Axis m_axis {Axis::CHILD};
+      bool m_descendant {false};          ///< the step was preceded by `//`
+      bool m_anyNode {false};             ///< `.`, matches any node including the document
+      std::optional<std::string> m_name;  ///< `nullopt` matches any element
+      std::vector<Predicate> m_predicates;
+    };
+
+    /// @brief A location path of a union
+    struct LocationPath
+    {
+      bool m_absolute {false};
+      std::vector<Step> m_steps;
+    };
+
+    /// @brief compile an expression
+    /// @param[in] path the XPath expression
+    /// @return the evaluator or `nullopt` if the expression is not in the supported subset
+    static std::optional<PathEvaluator> compile(const std::string &path);
+
+    /// @brief find the data items selected by the expression
+    /// @param[in] devices the devices in the order they are in the probe document
+    /// @param[out] filter the data item ids are added to the filter set
+    void evaluate(const std::list<DevicePtr> &devices, FilterSet &filter) const;
+
+    /// @brief get the compiled location paths
+    /// @return the location paths of the union
+    const auto &getPaths() const { return m_paths; }
+
+  protected:
+    std::vector<LocationPath> m_paths;
+  };
+}  // namespace mtconnect::device_model
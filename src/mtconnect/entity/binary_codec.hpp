@@ -0,0 +1,280 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "mtconnect/entity/data_set.hpp"
+#include "mtconnect/entity/entity.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::entity {
+  /// @brief Binary encoding of entity values in host byte order
+  ///
+  /// The encoding is only meant to be read back by the same build of the agent, for example for
+  /// journals and caches. Entity values are not encoded by `putValue()` and are written as empty.
+  class BinaryEncoder
+  {
+  public:
+    /// @brief Create an encoder that appends to a string
+    /// @param[in,out] out the buffer to append to
+    BinaryEncoder(std::string &out) : m_out(out) {}
+
+    /// @brief append a trivially copyable value
+    template <typename T>
+    void put(T v)
+    {
+      m_out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+    }
+
+    /// @brief append a string prefixed by its length
+    void putString(const std::string &s)
+    {
+      put<uint32_t>(uint32_t(s.size()));
+      m_out.append(s);
+    }
+
+    /// @brief append a data set or table cell value prefixed by its variant index
+    template <typename V>
+    void putCell(const V &value)
+    {
+      put<uint8_t>(uint8_t(value.index()));
+      std::visit(overloaded {[this](const std::string &s) { putString(s); },
+                             [this](const int64_t &i) { put(i); },
+                             [this](const double &d) { put(d); }, [](const auto &) {}},
+                 value);
+    }
+
+    /// @brief append a value prefixed by its `ValueType`
+    void putValue(const Value &value)
+    {
+      std::visit(overloaded {[this](const std::string &s) {
+                               put<uint8_t>(uint8_t(ValueType::STRING));
+                               putString(s);
+                             },
+                             [this](const int64_t &i) {
+                               put<uint8_t>(uint8_t(ValueType::INTEGER));
+                               put(i);
+                             },
+                             [this](const double &d) {
+                               put<uint8_t>(uint8_t(ValueType::DOUBLE));
+                               put(d);
+                             },
+                             [this](const bool &b) {
+                               put<uint8_t>(uint8_t(ValueType::BOOL));
+                               put<uint8_t>(b);
+                             },
+                             [this](const Vector &v) {
+                               put<uint8_t>(uint8_t(ValueType::VECTOR));
+                               put<uint32_t>(uint32_t(v.size()));
+                               for (auto d : v)
+                                 put(d);
+                             },
+                             [this](const DataSet &set) {
+                               put<uint8_t>(uint8_t(ValueType::DATA_SET));
+                               put<uint32_t>(uint32_t(set.size()));
+                               for (const auto &e : set)
+                               {
+                                 putString(e.m_key);
+                                 put<uint8_t>(e.m_removed);
+                                 if (std::holds_alternative<TableRow>(e.m_value))
+                                 {
+                                   const auto &row = std::get<TableRow>(e.m_value);
+                                   put<uint8_t>(uint8_t(DataSetValueType::TABLE_ROW));
+                                   put<uint32_t>(uint32_t(row.size()));
+                                   for (const auto &c : row)
+                                   {
+                                     putString(c.m_key);
+                                     put<uint8_t>(c.m_removed);
+                                     putCell(c.m_value);
+                                   }
+                                 }
+                                 else
+                                 {
+                                   putCell(e.m_value);
+                                 }
+                               }
+                             },
+                             [this](const Timestamp &ts) {
+                               put<uint8_t>(uint8_t(ValueType::TIMESTAMP));
+                               put<int64_t>(ts.time_since_epoch().count());
+                             },
+                             [this](const auto &) { put<uint8_t>(uint8_t(ValueType::EMPTY)); }},
+                 value);
+    }
+
+  protected:
+    std::string &m_out;
+  };
+
+  /// @brief Decoder for values written by the `BinaryEncoder`. Throws `std::out_of_range` if the
+  /// data is truncated.
+  class BinaryDecoder
+  {
+  public:
+    /// @brief Create a decoder for a buffer
+    /// @param[in] data the start of the encoded data
+    /// @param[in] size the size of the encoded data
+    BinaryDecoder(const char *data, size_t size) : m_data(data), m_size(size) {}
+
+    /// @brief read a trivially copyable value
+    template <typename T>
+    T get()
+    {
+      check(sizeof(T));
+      T v;
+      memcpy(&v, m_data + m_pos, sizeof(T));
+      m_pos += sizeof(T);
+      return v;
+    }
+
+    /// @brief read an element count and check it against the remaining data
+    /// @param[in] elementSize the smallest encoded size of one element
+    /// @return the count
+    uint32_t getCount(size_t elementSize = 1)
+    {
+      auto count = get<uint32_t>();
+      check(size_t(count) * elementSize);
+      return count;
+    }
+
+    /// @brief read a string written by `putString()`
+    std::string getString()
+    {
+      auto len = get<uint32_t>();
+      check(len);
+      std::string s(m_data + m_pos, len);
+      m_pos += len;
+      return s;
+    }
+
+    /// @brief read a cell value given its variant index
+    template <typename V>
+    V getCell(uint8_t index)
+    {
+      switch (index)
+      {
+        case 1:
+          return V(getString());
+        case 2:
+          return V(get<int64_t>());
+        case 3:
+          return V(get<double>());
+        default:
+          return V();
+      }
+    }
+
+    /// @brief read a value written by `putValue()`
+    Value getValue()
+    {
+      switch (ValueType(get<uint8_t>()))
+      {
+        case ValueType::STRING:
+          return getString();
+
+        case ValueType::INTEGER:
+          return get<int64_t>();
+
+        case ValueType::DOUBLE:
+          return get<double>();
+
+        case ValueType::BOOL:
+          return bool(get<uint8_t>());
+
+        case ValueType::VECTOR:
+        {
+          Vector v(getCount(sizeof(double)));
+          for (auto &d : v)
+            d = get<double>();
+          return v;
+        }
+
+        case ValueType::DATA_SET:
+        {
+          DataSet set;
+          auto count = getCount();
+          for (uint32_t i = 0; i < count; i++)
+          {
+            auto key = getString();
+            bool removed = get<uint8_t>();
+            auto type = DataSetValueType(get<uint8_t>());
+            if (type == DataSetValueType::TABLE_ROW)
+            {
+              TableRow row;
+              auto cells = getCount();
+              for (uint32_t j = 0; j < cells; j++)
+              {
+                auto ck = getString();
+                bool cr = get<uint8_t>();
+                // Table cell variant indexes are one less than data set value indexes
+                auto cv = getCell<TableCellValue>(get<uint8_t>());
+                row.emplace(ck, std::move(cv), cr);
+              }
+              set.emplace(key, DataSetValue(std::move(row)), removed);
+            }
+            else
+            {
+              DataSetValue dv;
+              switch (type)
+              {
+                case DataSetValueType::STRING:
+                  dv = getString();
+                  break;
+                case DataSetValueType::INTEGER:
+                  dv = get<int64_t>();
+                  break;
+                case DataSetValueType::DOUBLE:
+                  dv = get<double>();
+                  break;
+                default:
+                  break;
+              }
+              set.emplace(key, std::move(dv), removed);
+            }
+          }
+          return set;
+        }
+
+        case ValueType::TIMESTAMP:
+          return Timestamp(Timestamp::duration(get<int64_t>()));
+
+        default:
+          return Value();
+      }
+    }
+
+    /// @brief `true` if all the data has been read
+    bool atEnd() const { return m_pos == m_size; }
+
+  protected:
+    void check(size_t size)
+    {
+      if (m_pos + size > m_size)
+        throw std::out_of_range("Encoded data truncated");
+    }
+
+  protected:
+    const char *m_data;
+    size_t m_size;
+    size_t m_pos {0};
+  };
+}  // namespace mtconnect::entity
@@ -28,6 +28,7 @@
 #include "mtconnect/config.hpp"
 #include "mtconnect/logging.hpp"
 #include "mtconnect/utilities.hpp"
+#include "persistent_set.hpp"
 
 namespace mtconnect::entity {
 
@@ -131,11 +132,12 @@ namespace mtconnect::entity {
 
     /// @brief A set of data set entries
     /// @tparam ET the entry type for the set, must have < operator.
-    template <typename ET>
-    class Set : public std::set<ET>
+    /// @tparam Base the ordered set implementation
+    template <typename ET, typename Base = std::set<ET>>
+    class Set : public Base
     {
     public:
-      using base = std::set<ET>;
+      using base = Base;
       using base::base;
 
       /// @brief Get a entry for a key
@@ -230,10 +232,14 @@ namespace mtconnect::entity {
   using DataSetEntry = data_set::Entry<DataSetValue>;
 
   /// @brief A set of data set entries
-  class AGENT_LIB_API DataSet : public data_set::Set<DataSetEntry>
+  ///
+  /// The entries are held in a persistent set so copies of a data set share their unchanged
+  /// entries. The checkpoint merges changes into large data sets and tables without copying them.
+  class AGENT_LIB_API DataSet
+    : public data_set::Set<DataSetEntry, data_set::PersistentSet<DataSetEntry>>
   {
   public:
-    using base = data_set::Set<DataSetEntry>;
+    using base = data_set::Set<DataSetEntry, data_set::PersistentSet<DataSetEntry>>;
     using base::base;
 
     /// @brief Split the data set entries by space delimiters and account for the
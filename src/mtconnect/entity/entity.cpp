@@ -190,9 +190,9 @@ namespace mtconnect::entity {
       if (!origId)
       {
         oldId = std::get<std::string>(it->second);
-        m_properties.emplace("originalId", oldId);
         newId = makeUniqueId(sha1, oldId);
         it->second = newId;
+        m_properties.emplace("originalId", oldId);
       }
       else
       {
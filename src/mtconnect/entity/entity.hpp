@@ -25,6 +25,7 @@
 #include <unordered_map>
 
 #include "data_set.hpp"
+#include "flat_map.hpp"
 #include "mtconnect/config.hpp"
 #include "qname.hpp"
 #include "requirement.hpp"
@@ -39,10 +40,14 @@ namespace mtconnect {
     {
       using QName::QName;
       PropertyKey(const PropertyKey &s) : QName(s) {}
+      PropertyKey(PropertyKey &&s) noexcept = default;
       PropertyKey(const std::string &s) : QName(s) {}
       PropertyKey(const std::string &&s) : QName(s) {}
       PropertyKey(const char *s) : QName(s) {}
 
+      PropertyKey &operator=(const PropertyKey &) = default;
+      PropertyKey &operator=(PropertyKey &&) noexcept = default;
+
       /// @brief clears marks for this property
       void clearMark() const { const_cast<PropertyKey *>(this)->m_mark = false; }
       /// @brief sets the mark for this property
@@ -52,8 +57,8 @@ namespace mtconnect {
       bool m_mark {false};
     };
 
-    /// @brief properties are a map of PropertyKey to Value
-    using Properties = std::map<PropertyKey, Value>;
+    /// @brief properties are a map of PropertyKey to Value kept sorted in a single vector
+    using Properties = FlatMap<PropertyKey, Value>;
     using OrderList = std::list<std::string>;
     using OrderMap = std::unordered_map<std::string, int>;
     using OrderMapPtr = std::shared_ptr<OrderMap>;
@@ -105,7 +105,7 @@ namespace mtconnect {
 
     bool Factory::isSufficient(Properties &properties, ErrorList &errors) const
     {
-      NAMED_SCOPE("EntityFactory");
+      HOT_NAMED_SCOPE("EntityFactory");
       bool success {true};
       for (auto &p : properties)
         p.first.clearMark();
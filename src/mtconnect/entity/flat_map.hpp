@@ -0,0 +1,268 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mtconnect::entity {
+  /// @brief A map kept as a vector of key/value pairs sorted by key
+  ///
+  /// The entries are stored in a single allocation, so copying the map is one allocation and an
+  /// element-wise copy instead of a node per entry. The iteration order is the same as a
+  /// `std::map` with the same keys. Lookups accept any type that can be compared to the key, so a
+  /// string literal does not create a temporary key.
+  ///
+  /// Unlike `std::map`, inserting or erasing invalidates iterators and references to the entries.
+  ///
+  /// @tparam Key the key, must be ordered with `operator<`
+  /// @tparam T the mapped value
+  template <typename Key, typename T>
+  class FlatMap
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using container_type = std::vector<value_type>;
+    using size_type = typename container_type::size_type;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+    FlatMap() = default;
+    FlatMap(const FlatMap &) = default;
+    FlatMap(FlatMap &&) noexcept = default;
+    /// @brief create a map from a list of entries, the first entry for a key is kept
+    /// @param[in] init the entries
+    FlatMap(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+    /// @brief create a map from a range of entries, the first entry for a key is kept
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last)
+    {
+      insert(first, last);
+    }
+
+    FlatMap &operator=(const FlatMap &) = default;
+    FlatMap &operator=(FlatMap &&) noexcept = default;
+
+    auto begin() { return m_values.begin(); }
+    auto end() { return m_values.end(); }
+    auto begin() const { return m_values.begin(); }
+    auto end() const { return m_values.end(); }
+    auto cbegin() const { return m_values.cbegin(); }
+    auto cend() const { return m_values.cend(); }
+    auto rbegin() { return m_values.rbegin(); }
+    auto rend() { return m_values.rend(); }
+    auto rbegin() const { return m_values.rbegin(); }
+    auto rend() const { return m_values.rend(); }
+
+    /// @brief `true` if there are no entries
+    bool empty() const { return m_values.empty(); }
+    /// @brief the number of entries
+    size_type size() const { return m_values.size(); }
+    /// @brief reserve space for entries so they are added without reallocating
+    /// @param[in] size the number of entries
+    void reserve(size_type size) { m_values.reserve(size); }
+    /// @brief remove all the entries
+    void clear() { m_values.clear(); }
+    /// @brief swap the entries with another map
+    void swap(FlatMap &other) noexcept { m_values.swap(other.m_values); }
+
+    /// @brief find the entry for a key
+    /// @param[in] key anything that can be compared to the key
+    /// @return an iterator to the entry or `end()`
+    template <typename K>
+    iterator find(const K &key)
+    {
+      auto it = lowerBound(m_values, key);
+      return matches(it, key) ? it : end();
+    }
+    /// @brief find the entry for a key
+    /// @param[in] key anything that can be compared to the key
+    /// @return an iterator to the entry or `end()`
+    template <typename K>
+    const_iterator find(const K &key) const
+    {
+      auto it = lowerBound(m_values, key);
+      return matches(it, key) ? it : end();
+    }
+    /// @brief check if there is an entry for a key
+    template <typename K>
+    bool contains(const K &key) const
+    {
+      return find(key) != end();
+    }
+    /// @brief the number of entries for a key, `0` or `1`
+    template <typename K>
+    size_type count(const K &key) const
+    {
+      return contains(key) ? 1 : 0;
+    }
+
+    /// @brief get the value for a key
+    /// @throws std::out_of_range if there is no entry for the key
+    template <typename K>
+    T &at(const K &key)
+    {
+      auto it = find(key);
+      if (it == end())
+        throw std::out_of_range("FlatMap::at: key not found");
+      return it->second;
+    }
+    /// @brief get the value for a key
+    /// @throws std::out_of_range if there is no entry for the key
+    template <typename K>
+    const T &at(const K &key) const
+    {
+      auto it = find(key);
+      if (it == end())
+        throw std::out_of_range("FlatMap::at: key not found");
+      return it->second;
+    }
+
+    /// @brief get the value for a key, adding a default value if there is no entry
+    template <typename K>
+    T &operator[](K &&key)
+    {
+      return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    /// @brief add an entry constructed from the arguments if there is no entry for the key
+    /// @param[in] key the key
+    /// @param[in] args the arguments for the value, only used if the entry is added
+    /// @return an iterator to the entry and `true` if it was added
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+      auto it = lowerBound(m_values, key);
+      if (matches(it, key))
+        return {it, false};
+
+      it = m_values.emplace(it, std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+      return {it, true};
+    }
+
+    /// @brief add an entry or replace the value of the existing entry
+    /// @param[in] key the key
+    /// @param[in] value the value
+    /// @return an iterator to the entry and `true` if it was added
+    template <typename K, typename M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&value)
+    {
+      auto it = lowerBound(m_values, key);
+      if (matches(it, key))
+      {
+        it->second = std::forward<M>(value);
+        return {it, false};
+      }
+
+      it = m_values.emplace(it, std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<M>(value)));
+      return {it, true};
+    }
+
+    /// @brief add an entry if there is no entry for the key
+    /// @return an iterator to the entry and `true` if it was added
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+      return try_emplace(value.first, value.second);
+    }
+    /// @brief add an entry if there is no entry for the key
+    /// @return an iterator to the entry and `true` if it was added
+    std::pair<iterator, bool> insert(value_type &&value)
+    {
+      return try_emplace(std::move(value.first), std::move(value.second));
+    }
+    /// @brief add the entries for keys that are not in the map
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+      if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                      typename std::iterator_traits<InputIt>::iterator_category>)
+        m_values.reserve(m_values.size() + std::distance(first, last));
+      for (; first != last; ++first)
+        insert(*first);
+    }
+    /// @brief add the entries for keys that are not in the map
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+    /// @brief construct an entry and add it if there is no entry for the key
+    /// @return an iterator to the entry and `true` if it was added
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+      value_type value(std::forward<Args>(args)...);
+      return insert(std::move(value));
+    }
+
+    /// @brief remove an entry
+    /// @return an iterator to the entry after the removed entry
+    iterator erase(iterator pos) { return m_values.erase(pos); }
+    /// @brief remove an entry
+    /// @return an iterator to the entry after the removed entry
+    iterator erase(const_iterator pos) { return m_values.erase(pos); }
+    /// @brief remove a range of entries
+    /// @return an iterator to the entry after the removed entries
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      return m_values.erase(first, last);
+    }
+    /// @brief remove the entry for a key
+    /// @param[in] key anything that can be compared to the key
+    /// @return the number of entries removed, `0` or `1`
+    template <typename K>
+      requires(!std::is_convertible_v<const K &, const_iterator>)
+    size_type erase(const K &key)
+    {
+      auto it = find(key);
+      if (it == end())
+        return 0;
+      m_values.erase(it);
+      return 1;
+    }
+
+    bool operator==(const FlatMap &other) const { return m_values == other.m_values; }
+
+  protected:
+    template <typename Values, typename K>
+    static auto lowerBound(Values &values, const K &key)
+    {
+      return std::lower_bound(values.begin(), values.end(), key,
+                              [](const value_type &entry, const K &k) { return entry.first < k; });
+    }
+
+    template <typename It, typename K>
+    bool matches(It it, const K &key) const
+    {
+      return it != m_values.end() && !(key < it->first);
+    }
+
+  protected:
+    container_type m_values;
+  };
+}  // namespace mtconnect::entity
@@ -34,11 +34,12 @@ namespace mtconnect {
       if (ef)
       {
         Properties properties;
-        EntityList* l {nullptr};
+        // The list is added after the other properties since adding properties may move it
+        std::optional<EntityList> list;
 
         if (ef->isList() && jNode.size() > 0)
         {
-          l = &properties["LIST"].emplace<EntityList>();
+          list.emplace();
         }
 
         for (auto& [key, value] : jNode.items())
@@ -100,9 +101,9 @@ namespace mtconnect {
               auto ent = parseJson(ef, it.key(), it.value(), errors);
               if (ent)
               {
-                if (l != nullptr)
+                if (list)
                 {
-                  l->emplace_back(ent);
+                  list->emplace_back(ent);
                 }
               }
               else
@@ -114,6 +115,11 @@ namespace mtconnect {
             }
           }
         }
+        if (list)
+        {
+          properties.insert_or_assign("LIST", std::move(*list));
+        }
+
         try
         {
           auto entity = ef->make(entity_name, properties, errors);
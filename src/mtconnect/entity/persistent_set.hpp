@@ -0,0 +1,463 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace mtconnect::entity::data_set {
+  /// @brief An ordered set with the interface of `std::set` whose nodes are immutable and shared
+  /// between copies
+  ///
+  /// The set is a balanced (AVL) binary tree. Copying the set only copies the root, and inserting
+  /// or erasing copies the nodes on the path to the changed element, leaving the rest of the tree
+  /// shared with the copies. Merging a few changes into a large set costs O(changes · log n)
+  /// allocations instead of copying the whole set.
+  ///
+  /// Elements are immutable, and unlike `std::set`, inserting or erasing invalidates the
+  /// iterators of the set that was modified. Use the iterator returned by `erase` to continue an
+  /// iteration.
+  ///
+  /// @tparam ET the element type, must have the `<` operator
+  template <typename ET>
+  class PersistentSet
+  {
+  protected:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    using ValuePtr = std::shared_ptr<const ET>;
+
+    struct Node
+    {
+      Node(ValuePtr value, NodePtr left, NodePtr right)
+        : m_value(std::move(value)),
+          m_left(std::move(left)),
+          m_right(std::move(right)),
+          m_height(uint8_t(1 + std::max(height(m_left), height(m_right))))
+      {}
+
+      ValuePtr m_value;  ///< shared so rebuilding the path does not copy the values
+      NodePtr m_left;
+      NodePtr m_right;
+      uint8_t m_height;
+    };
+
+    /// @brief Maximum height of the tree, an AVL tree of height 48 has over 2^32 nodes
+    static constexpr size_t MaxHeight = 48;
+
+  public:
+    using key_type = ET;
+    using value_type = ET;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const ET &;
+    using const_reference = const ET &;
+    using pointer = const ET *;
+    using const_pointer = const ET *;
+
+    /// @brief Bidirectional iterator holding the path from the root to the current node
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = ET;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ET *;
+      using reference = const ET &;
+
+      const_iterator() = default;
+
+      reference operator*() const { return *node()->m_value; }
+      pointer operator->() const { return node()->m_value.get(); }
+
+      const_iterator &operator++()
+      {
+        auto current = node();
+        if (current->m_right)
+        {
+          leftmost(current->m_right.get());
+        }
+        else
+        {
+          // Go up until we come from a left child
+          const Node *child;
+          do
+          {
+            child = m_path[--m_depth];
+          } while (m_depth > 0 && m_path[m_depth - 1]->m_right.get() == child);
+        }
+        return *this;
+      }
+
+      const_iterator operator++(int)
+      {
+        auto it = *this;
+        ++*this;
+        return it;
+      }
+
+      const_iterator &operator--()
+      {
+        auto current = node();
+        if (current == nullptr)
+        {
+          rightmost(m_root);
+        }
+        else if (current->m_left)
+        {
+          rightmost(current->m_left.get());
+        }
+        else
+        {
+          // Go up until we come from a right child
+          const Node *child;
+          do
+          {
+            child = m_path[--m_depth];
+          } while (m_depth > 0 && m_path[m_depth - 1]->m_left.get() == child);
+        }
+        return *this;
+      }
+
+      const_iterator operator--(int)
+      {
+        auto it = *this;
+        --*this;
+        return it;
+      }
+
+      bool operator==(const const_iterator &other) const { return node() == other.node(); }
+      bool operator!=(const const_iterator &other) const { return node() != other.node(); }
+
+    protected:
+      friend class PersistentSet;
+
+      const_iterator(const Node *root) : m_root(root) {}
+
+      const Node *node() const { return m_depth == 0 ? nullptr : m_path[m_depth - 1]; }
+      void push(const Node *node) { m_path[m_depth++] = node; }
+      void leftmost(const Node *node)
+      {
+        for (; node != nullptr; node = node->m_left.get())
+          push(node);
+      }
+      void rightmost(const Node *node)
+      {
+        for (; node != nullptr; node = node->m_right.get())
+          push(node);
+      }
+
+    protected:
+      const Node *m_root {nullptr};
+      std::array<const Node *, MaxHeight> m_path;
+      uint8_t m_depth {0};
+    };
+
+    using iterator = const_iterator;
+    using reverse_iterator = std::reverse_iterator<const_iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    PersistentSet() = default;
+    PersistentSet(const PersistentSet &other) = default;
+    PersistentSet(PersistentSet &&other) noexcept
+      : m_root(std::move(other.m_root)), m_size(std::exchange(other.m_size, 0))
+    {}
+    PersistentSet(std::initializer_list<ET> list) { insert(list.begin(), list.end()); }
+    template <typename InputIt>
+    PersistentSet(InputIt first, InputIt last)
+    {
+      insert(first, last);
+    }
+
+    PersistentSet &operator=(const PersistentSet &other) = default;
+    PersistentSet &operator=(PersistentSet &&other) noexcept
+    {
+      m_root = std::move(other.m_root);
+      m_size = std::exchange(other.m_size, 0);
+      return *this;
+    }
+
+    /// @name Iterators
+    ///@{
+    const_iterator begin() const
+    {
+      const_iterator it(m_root.get());
+      it.leftmost(m_root.get());
+      return it;
+    }
+    const_iterator end() const { return const_iterator(m_root.get()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    ///@}
+
+    /// @name Capacity
+    ///@{
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    ///@}
+
+    /// @name Lookup
+    ///@{
+    const_iterator find(const ET &key) const
+    {
+      const_iterator it(m_root.get());
+      for (auto node = m_root.get(); node != nullptr;)
+      {
+        it.push(node);
+        if (key < *node->m_value)
+          node = node->m_left.get();
+        else if (*node->m_value < key)
+          node = node->m_right.get();
+        else
+          return it;
+      }
+      return end();
+    }
+
+    const_iterator lower_bound(const ET &key) const { return bound(key, false); }
+    const_iterator upper_bound(const ET &key) const { return bound(key, true); }
+    size_type count(const ET &key) const { return find(key) == end() ? 0 : 1; }
+    bool contains(const ET &key) const { return count(key) == 1; }
+    ///@}
+
+    /// @name Modifiers
+    ///@{
+    /// @brief Insert a value if there is no equivalent value in the set
+    /// @return the iterator to the value in the set and `true` if it was inserted
+    std::pair<iterator, bool> insert(const ET &value)
+    {
+      return insertValue(std::make_shared<const ET>(value), false);
+    }
+    std::pair<iterator, bool> insert(ET &&value)
+    {
+      return insertValue(std::make_shared<const ET>(std::move(value)), false);
+    }
+    iterator insert(const_iterator, const ET &value) { return insert(value).first; }
+    iterator insert(const_iterator, ET &&value) { return insert(std::move(value)).first; }
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+      for (; first != last; first++)
+        insert(*first);
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+      return insertValue(std::make_shared<const ET>(std::forward<Args>(args)...), false);
+    }
+
+    /// @brief Insert a value replacing an equivalent value in the set
+    /// @return the iterator to the value in the set and `true` if it was inserted
+    std::pair<iterator, bool> insert_or_assign(const ET &value)
+    {
+      return insertValue(std::make_shared<const ET>(value), true);
+    }
+
+    /// @brief Erase the value at a position
+    /// @return the iterator following the erased value
+    iterator erase(const_iterator pos)
+    {
+      // Keep the value alive while the tree is rebuilt
+      ValuePtr value = pos.node()->m_value;
+      erase(*value);
+      return upper_bound(*value);
+    }
+
+    /// @brief Erase the value equivalent to key
+    /// @return the number of values erased
+    size_type erase(const ET &key)
+    {
+      bool removed = false;
+      m_root = erase(m_root, key, removed);
+      if (removed)
+        m_size--;
+      return removed ? 1 : 0;
+    }
+
+    void clear()
+    {
+      m_root.reset();
+      m_size = 0;
+    }
+
+    void swap(PersistentSet &other) noexcept
+    {
+      std::swap(m_root, other.m_root);
+      std::swap(m_size, other.m_size);
+    }
+    ///@}
+
+    /// @brief compares the values with `==` in order, like `std::set`
+    bool operator==(const PersistentSet &other) const
+    {
+      return m_size == other.m_size &&
+             (m_root == other.m_root || std::equal(begin(), end(), other.begin()));
+    }
+
+    /// @brief `true` if the sets share the same tree
+    bool shares(const PersistentSet &other) const { return m_root == other.m_root; }
+
+  protected:
+    static int height(const NodePtr &node) { return node ? node->m_height : 0; }
+
+    static NodePtr make(const ValuePtr &value, NodePtr left, NodePtr right)
+    {
+      return std::make_shared<const Node>(value, std::move(left), std::move(right));
+    }
+
+    static NodePtr balance(const ValuePtr &value, NodePtr left, NodePtr right)
+    {
+      auto hl = height(left), hr = height(right);
+      if (hl > hr + 1)
+      {
+        if (height(left->m_left) >= height(left->m_right))
+          return make(left->m_value, left->m_left, make(value, left->m_right, std::move(right)));
+
+        const auto &lr = left->m_right;
+        return make(lr->m_value, make(left->m_value, left->m_left, lr->m_left),
+                    make(value, lr->m_right, std::move(right)));
+      }
+      else if (hr > hl + 1)
+      {
+        if (height(right->m_right) >= height(right->m_left))
+          return make(right->m_value, make(value, std::move(left), right->m_left), right->m_right);
+
+        const auto &rl = right->m_left;
+        return make(rl->m_value, make(value, std::move(left), rl->m_left),
+                    make(right->m_value, rl->m_right, right->m_right));
+      }
+
+      return make(value, std::move(left), std::move(right));
+    }
+
+    static NodePtr insert(const NodePtr &node, const ValuePtr &value, bool assign, bool &added)
+    {
+      if (!node)
+      {
+        added = true;
+        return make(value, nullptr, nullptr);
+      }
+
+      if (*value < *node->m_value)
+      {
+        auto left = insert(node->m_left, value, assign, added);
+        if (left == node->m_left)
+          return node;
+        return balance(node->m_value, std::move(left), node->m_right);
+      }
+      else if (*node->m_value < *value)
+      {
+        auto right = insert(node->m_right, value, assign, added);
+        if (right == node->m_right)
+          return node;
+        return balance(node->m_value, node->m_left, std::move(right));
+      }
+      else if (assign)
+      {
+        return make(value, node->m_left, node->m_right);
+      }
+      else
+      {
+        return node;
+      }
+    }
+
+    static NodePtr eraseMin(const NodePtr &node, ValuePtr &min)
+    {
+      if (!node->m_left)
+      {
+        min = node->m_value;
+        return node->m_right;
+      }
+
+      auto left = eraseMin(node->m_left, min);
+      return balance(node->m_value, std::move(left), node->m_right);
+    }
+
+    static NodePtr erase(const NodePtr &node, const ET &key, bool &removed)
+    {
+      if (!node)
+        return node;
+
+      if (key < *node->m_value)
+      {
+        auto left = erase(node->m_left, key, removed);
+        if (!removed)
+          return node;
+        return balance(node->m_value, std::move(left), node->m_right);
+      }
+      else if (*node->m_value < key)
+      {
+        auto right = erase(node->m_right, key, removed);
+        if (!removed)
+          return node;
+        return balance(node->m_value, node->m_left, std::move(right));
+      }
+
+      removed = true;
+      if (!node->m_left)
+        return node->m_right;
+      if (!node->m_right)
+        return node->m_left;
+
+      ValuePtr min;
+      auto right = eraseMin(node->m_right, min);
+      return balance(min, node->m_left, std::move(right));
+    }
+
+    std::pair<iterator, bool> insertValue(ValuePtr &&value, bool assign)
+    {
+      bool added = false;
+      m_root = insert(m_root, value, assign, added);
+      if (added)
+        m_size++;
+      return {find(*value), added};
+    }
+
+    const_iterator bound(const ET &key, bool upper) const
+    {
+      // Track the path to the last node where we went left, it is the bound
+      const_iterator it(m_root.get()), result(m_root.get());
+      for (auto node = m_root.get(); node != nullptr;)
+      {
+        it.push(node);
+        if (upper ? key < *node->m_value : !(*node->m_value < key))
+        {
+          result = it;
+          node = node->m_left.get();
+        }
+        else
+        {
+          node = node->m_right.get();
+        }
+      }
+      return result;
+    }
+
+  protected:
+    NodePtr m_root;
+    size_type m_size {0};
+  };
+}  // namespace mtconnect::entity::data_set
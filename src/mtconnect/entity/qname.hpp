@@ -74,8 +74,12 @@ namespace mtconnect {
       /// @brief copy constructor
       /// @param other the source
       QName(const QName &other) = default;
+      QName(QName &&other) noexcept = default;
       ~QName() = default;
 
+      QName &operator=(const QName &other) = default;
+      QName &operator=(QName &&other) noexcept = default;
+
       /// @brief operator =
       /// @param name the source
       /// @return this qname
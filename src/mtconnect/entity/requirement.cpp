@@ -20,6 +20,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <cctype>
+#include <charconv>
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
@@ -155,11 +156,36 @@ namespace mtconnect {
       return true;
     }
 
+    /// @brief Parse a double starting at `cp` using `from_chars` with a `strtod` fallback.
+    ///
+    /// `from_chars` is used for the common case. If it cannot parse the value or stops on a
+    /// character that is not a valid terminator, `strtod` is used so the accepted syntax (leading
+    /// `+`, hex floats, out of range values) matches `strtod`.
+    ///
+    /// @param[in] cp the start of the number
+    /// @param[in] end the end of the buffer
+    /// @param[out] v the parsed value
+    /// @param[in] delimited `true` if the number must be followed by whitespace or the end
+    /// @return pointer to the first character after the number, `cp` if nothing was parsed
+    inline static const char *parseDouble(const char *cp, const char *end, double &v,
+                                          bool delimited)
+    {
+      auto [ptr, ec] = std::from_chars(cp, end, v);
+      if (ec == std::errc() && (ptr == end || (delimited && isspace(*ptr))))
+        return ptr;
+
+      char *np = nullptr;
+      v = strtod(cp, &np);
+      return np;
+    }
+
     /// @brief Internal visitor to convert a value from one type to another.
     /// @throws PropertyError if the value cannot be converted
     struct ValueConverter
     {
-      ValueConverter(ValueType type, bool table) : m_type(type), m_table(table) {}
+      ValueConverter(ValueType type, bool table, size_t capacity)
+        : m_type(type), m_table(table), m_capacity(capacity)
+      {}
 
       // ------------ Strings ----------------
       void operator()(const string &arg, DataSet &t) { t.parse(arg, m_table); }
@@ -173,10 +199,8 @@ namespace mtconnect {
       }
       void operator()(const string &arg, double &r)
       {
-        char *ep = nullptr;
         const char *sp = arg.c_str();
-        r = strtod(sp, &ep);
-        if (ep == sp)
+        if (parseDouble(sp, sp + arg.size(), r, false) == sp)
           throw PropertyError("cannot convert string '" + arg + "' to double");
       }
       void operator()(const string &arg, Timestamp &ts)
@@ -200,10 +224,14 @@ namespace mtconnect {
         if (arg.empty())
           return;
 
-        char *np(nullptr);
+        // Each value requires at least one character and a separator
+        if (m_capacity > 0)
+          r.reserve(std::min(m_capacity, arg.size() / 2 + 1));
+
         const char *cp = arg.c_str();
+        const char *end = cp + arg.size();
 
-        while (cp && *cp != '\0')
+        while (cp < end && *cp != '\0')
         {
           if (isspace(*cp))
           {
@@ -211,7 +239,8 @@ namespace mtconnect {
           }
           else
           {
-            double v = strtod(cp, &np);
+            double v;
+            auto np = parseDouble(cp, end, v, true);
             if (cp == np)
             {
               throw PropertyError("cannot convert string '" + arg + "' to vector");
@@ -332,9 +361,10 @@ namespace mtconnect {
 
       ValueType m_type;
       bool m_table;
+      size_t m_capacity;
     };
 
-    bool ConvertValueToType(Value &value, ValueType type, bool table)
+    bool ConvertValueToType(Value &value, ValueType type, bool table, size_t capacity)
     {
       if (ValueType(value.index()) == type)
         return false;
@@ -384,9 +414,9 @@ namespace mtconnect {
           throw PropertyError("Cannot convert non-scaler types");
       }
 
-      ValueConverter vc(type, table);
+      ValueConverter vc(type, table, capacity);
       visit(vc, value, out);
-      value = out;
+      value = std::move(out);
 
       return true;
     }
@@ -92,8 +92,10 @@ namespace mtconnect::entity {
   /// @param value The value to convert
   /// @param type the target type
   /// @param table special treatment if a table (data sets of data set)
+  /// @param capacity expected number of entries when converting to a `Vector`, 0 if unknown
   /// @return `true` if conversion was successful
-  bool AGENT_LIB_API ConvertValueToType(Value &value, ValueType type, bool table = false);
+  bool AGENT_LIB_API ConvertValueToType(Value &value, ValueType type, bool table = false,
+                                        size_t capacity = 0);
 
   /// @brief Error class when an error occurred
   class AGENT_LIB_API EntityError : public std::logic_error
@@ -330,12 +332,15 @@ namespace mtconnect::entity {
     /// @brief convert a given value to the requirement type
     /// @param v the value
     /// @param table if this is a table conversion
+    /// @param capacity expected number of vector entries, defaults to the requirement size
     /// @return `true` if it is successful
-    bool convertType(Value &v, bool table = false) const
+    bool convertType(Value &v, bool table = false, size_t capacity = 0) const
     {
       try
       {
-        return ConvertValueToType(v, m_type, table);
+        if (capacity == 0 && m_size)
+          capacity = size_t(*m_size);
+        return ConvertValueToType(v, m_type, table, capacity);
       }
       catch (PropertyError &e)
       {
@@ -184,11 +184,10 @@ namespace mtconnect::entity {
       }
 
       Properties properties;
-      EntityList *l {nullptr};
+      // The list is added after the other properties since adding properties may move it
+      std::optional<EntityList> list;
       if (ef->isList())
-      {
-        l = &properties["LIST"].emplace<EntityList>();
-      }
+        list.emplace();
 
       for (xmlAttrPtr attr = node->properties; attr; attr = attr->next)
       {
@@ -271,9 +270,9 @@ namespace mtconnect::entity {
               auto ent = parseXmlNode(ef, child, errors);
               if (ent)
               {
-                if (l != nullptr)
+                if (list)
                 {
-                  l->emplace_back(ent);
+                  list->emplace_back(ent);
                 }
                 else if (ef->isPropertySet(ent->getName()))
                 {
@@ -305,9 +304,9 @@ namespace mtconnect::entity {
 
       try
       {
-        if (ef->isAny() && l && l->empty())
+        if (list && !(ef->isAny() && list->empty()))
         {
-          properties.erase("LIST");
+          properties.insert_or_assign("LIST", std::move(*list));
         }
 
         auto entity = ef->make(qname, properties, errors);
@@ -0,0 +1,26 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "mtconnect/logging.hpp"
+
+namespace mtconnect::logging {
+  // Everything is passed to the sinks until the logger is configured
+  std::atomic<boost::log::trivial::severity_level> MinimumLevel {
+      boost::log::trivial::severity_level::trace};
+  std::atomic<bool> HotPathScopes {true};
+  std::atomic<uint32_t> SampleInterval {0};
+}  // namespace mtconnect::logging
@@ -24,6 +24,12 @@
 #include <boost/log/sources/global_logger_storage.hpp>
 #include <boost/log/sources/severity_channel_logger.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/log/utility/string_literal.hpp>
+#include <boost/log/utility/unique_identifier_name.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
 
 #include "mtconnect/config.hpp"
 
@@ -41,9 +47,92 @@ typedef boost::log::sources::severity_channel_logger_mt<
 
 CHANNEL_LOGGER_INIT(agent_logger, "agent")
 
-#define LOG(lvl) BOOST_LOG_SEV(agent_logger::get(), ::boost::log::trivial::lvl)
+namespace mtconnect::logging {
+  /// @brief The lowest severity logged by the agent channel
+  ///
+  /// Checked before a record is opened so a disabled statement costs a single branch and the
+  /// stream expression is never evaluated.
+  AGENT_LIB_API extern std::atomic<boost::log::trivial::severity_level> MinimumLevel;
+  /// @brief Tracks the named scopes on the hot paths when `true`
+  AGENT_LIB_API extern std::atomic<bool> HotPathScopes;
+  /// @brief Log one in this many sampled statements below the `MinimumLevel`, `0` disables
+  /// sampling
+  AGENT_LIB_API extern std::atomic<uint32_t> SampleInterval;
+
+  /// @brief check if a severity is logged
+  /// @param[in] level the severity
+  /// @return `true` if the severity is at or above the `MinimumLevel`
+  inline bool Enabled(boost::log::trivial::severity_level level)
+  {
+    return level >= MinimumLevel.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Counts the statements at a call site to log one in every `SampleInterval`
+  class Sampler
+  {
+  public:
+    /// @brief check if this statement is logged
+    /// @param[in] level the severity
+    /// @return `true` if the severity is enabled or this statement is sampled
+    bool operator()(boost::log::trivial::severity_level level)
+    {
+      if (Enabled(level))
+        return true;
+      auto interval = SampleInterval.load(std::memory_order_relaxed);
+      return interval > 0 && m_count.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+    }
+
+  protected:
+    std::atomic<uint32_t> m_count {0};
+  };
+
+  /// @brief Named scope that is only pushed when `HotPathScopes` is enabled
+  class HotPathScope
+  {
+  public:
+    HotPathScope(boost::log::string_literal const &name, boost::log::string_literal const &file,
+                 unsigned int line)
+    {
+      if (HotPathScopes.load(std::memory_order_relaxed))
+        m_sentry.emplace(name, file, line);
+    }
+    HotPathScope(const HotPathScope &) = delete;
+    HotPathScope &operator=(const HotPathScope &) = delete;
+
+  protected:
+    std::optional<boost::log::attributes::named_scope::sentry> m_sentry;
+  };
+}  // namespace mtconnect::logging
+
+// The loops avoid the ambiguous else of an if statement when the macros are used in one
+#define LOG(lvl)                                                                       \
+  for (bool _logEnabled = ::mtconnect::logging::Enabled(LOG_LEVEL(lvl)); _logEnabled; \
+       _logEnabled = false)                                                            \
+  BOOST_LOG_SEV(agent_logger::get(), LOG_LEVEL(lvl))
+
+/// @brief log one in every `SampleInterval` statements at this call site when the severity is
+/// not enabled
+#define LOG_SAMPLED(lvl)                                      \
+  for (bool _logEnabled = []() {                              \
+         static ::mtconnect::logging::Sampler sampler;        \
+         return sampler(LOG_LEVEL(lvl));                      \
+       }();                                                   \
+       _logEnabled; _logEnabled = false)                      \
+  BOOST_LOG_SEV(agent_logger::get(), LOG_LEVEL(lvl))
 
 /// @brief synonym for `BOOST_LOG_NAMED_SCOPE`
 #define NAMED_SCOPE BOOST_LOG_NAMED_SCOPE
 
+/// @brief named scope for functions called for every line or observation
+///
+/// Compiled out when `AGENT_WITHOUT_HOT_PATH_SCOPES` is defined and skipped at runtime when
+/// `HotPathScopes` is `false`.
+#ifdef AGENT_WITHOUT_HOT_PATH_SCOPES
+#define HOT_NAMED_SCOPE(name) ((void)0)
+#else
+#define HOT_NAMED_SCOPE(name)                                                 \
+  ::mtconnect::logging::HotPathScope BOOST_LOG_UNIQUE_IDENTIFIER_NAME(_hotScope_)( \
+      name, __FILE__, __LINE__)
+#endif
+
 #define LOG_LEVEL(lvl) ::boost::log::trivial::lvl
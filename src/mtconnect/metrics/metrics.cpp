@@ -0,0 +1,202 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "metrics.hpp"
+
+#include <functional>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace mtconnect::metrics {
+  std::atomic_bool Registry::s_enabled {false};
+
+  size_t shardIndex()
+  {
+    static thread_local size_t index = hash<thread::id>()(this_thread::get_id()) % Shards;
+    return index;
+  }
+
+  uint64_t &ExclusiveTimer::nestedTime()
+  {
+    static thread_local uint64_t nested {0};
+    return nested;
+  }
+
+  Histogram::Snapshot Histogram::snapshot() const
+  {
+    Snapshot snap;
+    snap.m_buckets.resize(Buckets, 0);
+    for (const auto &shard : m_shards)
+    {
+      for (size_t i = 0; i < Buckets; i++)
+        snap.m_buckets[i] += shard.m_buckets[i].load(memory_order_relaxed);
+      snap.m_sum += shard.m_sum.load(memory_order_relaxed);
+      snap.m_max = max(snap.m_max, shard.m_max.load(memory_order_relaxed));
+    }
+
+    // Count from the buckets so the quantiles are consistent with the count
+    for (auto c : snap.m_buckets)
+      snap.m_count += c;
+
+    return snap;
+  }
+
+  uint64_t Histogram::Snapshot::quantile(double q) const
+  {
+    if (m_count == 0)
+      return 0;
+
+    auto rank = uint64_t(q * double(m_count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_buckets.size(); i++)
+    {
+      seen += m_buckets[i];
+      if (seen >= rank)
+        return min(bucketUpperBound(i), m_max);
+    }
+
+    return m_max;
+  }
+
+  Registry &Registry::instance()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  Counter &Registry::counter(const std::string &name, const Labels &labels)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto &metric = m_counters[name].m_metrics[labels];
+    if (!metric)
+      metric = make_unique<Counter>();
+    return *metric;
+  }
+
+  Gauge &Registry::gauge(const std::string &name, const Labels &labels)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto &metric = m_gauges[name].m_metrics[labels];
+    if (!metric)
+      metric = make_unique<Gauge>();
+    return *metric;
+  }
+
+  Histogram &Registry::histogram(const std::string &name, const Labels &labels, double scale)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto &metric = m_histograms[name].m_metrics[labels];
+    if (!metric)
+      metric = make_unique<Histogram>(scale);
+    return *metric;
+  }
+
+  namespace {
+    void printLabels(ostream &out, const Labels &labels, const char *extra = nullptr)
+    {
+      if (labels.empty() && extra == nullptr)
+        return;
+
+      out << '{';
+      bool first = true;
+      for (const auto &[key, value] : labels)
+      {
+        if (!first)
+          out << ',';
+        first = false;
+        out << key << "=\"";
+        for (auto c : value)
+        {
+          if (c == '"' || c == '\\')
+            out << '\\';
+          if (c == '\n')
+            out << "\\n";
+          else
+            out << c;
+        }
+        out << '"';
+      }
+      if (extra != nullptr)
+      {
+        if (!first)
+          out << ',';
+        out << extra;
+      }
+      out << '}';
+    }
+  }  // namespace
+
+  std::string Registry::print() const
+  {
+    lock_guard<mutex> lock(m_mutex);
+    stringstream out;
+    out.precision(9);
+
+    for (const auto &[name, family] : m_counters)
+    {
+      out << "# TYPE " << name << " counter\n";
+      for (const auto &[labels, metric] : family.m_metrics)
+      {
+        out << name;
+        printLabels(out, labels);
+        out << ' ' << metric->value() << '\n';
+      }
+    }
+
+    for (const auto &[name, family] : m_gauges)
+    {
+      out << "# TYPE " << name << " gauge\n";
+      for (const auto &[labels, metric] : family.m_metrics)
+      {
+        out << name;
+        printLabels(out, labels);
+        out << ' ' << metric->value() << '\n';
+      }
+    }
+
+    static const pair<double, const char *> quantiles[] = {{0.5, "quantile=\"0.5\""},
+                                                           {0.9, "quantile=\"0.9\""},
+                                                           {0.99, "quantile=\"0.99\""},
+                                                           {0.999, "quantile=\"0.999\""},
+                                                           {1.0, "quantile=\"1\""}};
+    for (const auto &[name, family] : m_histograms)
+    {
+      out << "# TYPE " << name << " summary\n";
+      for (const auto &[labels, metric] : family.m_metrics)
+      {
+        auto snap = metric->snapshot();
+        auto scale = metric->getScale();
+        for (const auto &[q, label] : quantiles)
+        {
+          out << name;
+          printLabels(out, labels, label);
+          out << ' ' << double(snap.quantile(q)) * scale << '\n';
+        }
+        out << name << "_sum";
+        printLabels(out, labels);
+        out << ' ' << double(snap.m_sum) * scale << '\n';
+        out << name << "_count";
+        printLabels(out, labels);
+        out << ' ' << snap.m_count << '\n';
+      }
+    }
+
+    return out.str();
+  }
+}  // namespace mtconnect::metrics
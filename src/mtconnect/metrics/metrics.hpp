@@ -0,0 +1,284 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+
+/// @brief Low overhead performance telemetry
+namespace mtconnect::metrics {
+  /// @brief Number of shards used to spread updates from different threads
+  constexpr size_t Shards = 4;
+
+  /// @brief get the shard for the current thread
+  /// @return the shard index
+  AGENT_LIB_API size_t shardIndex();
+
+  /// @brief A monotonic counter sharded by thread
+  class AGENT_LIB_API Counter
+  {
+  public:
+    /// @brief increment the counter
+    /// @param[in] v the amount to add
+    void add(uint64_t v = 1)
+    {
+      m_shards[shardIndex()].m_value.fetch_add(v, std::memory_order_relaxed);
+    }
+    /// @brief get the sum of all the shards
+    uint64_t value() const
+    {
+      uint64_t sum = 0;
+      for (const auto &s : m_shards)
+        sum += s.m_value.load(std::memory_order_relaxed);
+      return sum;
+    }
+
+  protected:
+    struct alignas(64) Shard
+    {
+      std::atomic<uint64_t> m_value {0};
+    };
+    std::array<Shard, Shards> m_shards;
+  };
+
+  /// @brief A value that can go up and down
+  class AGENT_LIB_API Gauge
+  {
+  public:
+    void set(int64_t v) { m_value.store(v, std::memory_order_relaxed); }
+    void add(int64_t v) { m_value.fetch_add(v, std::memory_order_relaxed); }
+    int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+  protected:
+    std::atomic<int64_t> m_value {0};
+  };
+
+  /// @brief A log-linear histogram in the style of HDR histograms
+  ///
+  /// Values are bucketed by their highest bit with `SubBuckets` linear sub-buckets for each power
+  /// of two, giving a relative error of at most 1/`SubBuckets` over the full range of `uint64_t`.
+  /// Recording is a few relaxed atomic increments on a shard owned by the calling thread.
+  class AGENT_LIB_API Histogram
+  {
+  public:
+    static constexpr unsigned SubBucketBits = 3;
+    static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+    static constexpr size_t Buckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+    /// @brief A consistent copy of the histogram
+    struct Snapshot
+    {
+      uint64_t m_count {0};
+      uint64_t m_sum {0};
+      uint64_t m_max {0};
+      std::vector<uint64_t> m_buckets;
+
+      /// @brief get the value at a quantile
+      /// @param[in] q the quantile between 0 and 1
+      /// @return the upper bound of the bucket containing the quantile
+      uint64_t quantile(double q) const;
+    };
+
+    /// @brief create a histogram
+    /// @param[in] scale the factor to convert recorded values to the reported unit
+    Histogram(double scale = 1.0) : m_scale(scale) {}
+
+    /// @brief record a value
+    /// @param[in] value the value
+    void record(uint64_t value)
+    {
+      auto &shard = m_shards[shardIndex()];
+      shard.m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+      shard.m_count.fetch_add(1, std::memory_order_relaxed);
+      shard.m_sum.fetch_add(value, std::memory_order_relaxed);
+      auto max = shard.m_max.load(std::memory_order_relaxed);
+      while (value > max &&
+             !shard.m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        ;
+    }
+
+    /// @brief sum the shards
+    Snapshot snapshot() const;
+    /// @brief get the scale of the reported values
+    double getScale() const { return m_scale; }
+
+    /// @brief get the bucket for a value
+    static constexpr size_t bucketIndex(uint64_t value)
+    {
+      if (value < SubBuckets)
+        return size_t(value);
+      unsigned shift = unsigned(63 - std::countl_zero(value)) - SubBucketBits;
+      return (shift + 1) * SubBuckets + size_t((value >> shift) & (SubBuckets - 1));
+    }
+    /// @brief get the largest value in a bucket
+    static constexpr uint64_t bucketUpperBound(size_t index)
+    {
+      if (index < SubBuckets)
+        return index;
+      unsigned shift = unsigned(index / SubBuckets) - 1;
+      uint64_t lower = (SubBuckets + (index % SubBuckets)) << shift;
+      return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+  protected:
+    struct alignas(64) Shard
+    {
+      std::array<std::atomic<uint64_t>, Buckets> m_buckets {};
+      std::atomic<uint64_t> m_count {0};
+      std::atomic<uint64_t> m_sum {0};
+      std::atomic<uint64_t> m_max {0};
+    };
+
+    double m_scale;
+    std::array<Shard, Shards> m_shards;
+  };
+
+  /// @brief Labels of a metric, such as the transform or document type
+  using Labels = std::map<std::string, std::string>;
+
+  /// @brief Registry of all the metrics in the agent
+  ///
+  /// The registry is disabled by default. When it is disabled the timers do not read the clock and
+  /// instrumented code does not create metrics. Metrics are never removed, so references returned
+  /// by the registry can be cached for the life of the process.
+  class AGENT_LIB_API Registry
+  {
+  public:
+    /// @brief get the registry for the process
+    static Registry &instance();
+
+    /// @brief check if metrics are being collected
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    /// @brief turn metric collection on or off
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+    /// @brief get or create a counter
+    Counter &counter(const std::string &name, const Labels &labels = {});
+    /// @brief get or create a gauge
+    Gauge &gauge(const std::string &name, const Labels &labels = {});
+    /// @brief get or create a histogram
+    /// @param[in] name the metric name
+    /// @param[in] labels the labels
+    /// @param[in] scale the factor to convert the recorded values, defaults to nanoseconds to
+    /// seconds
+    Histogram &histogram(const std::string &name, const Labels &labels = {},
+                         double scale = 1e-9);
+
+    /// @brief print all the metrics in the Prometheus text exposition format
+    /// @return the text document
+    std::string print() const;
+
+  protected:
+    template <typename T>
+    struct Family
+    {
+      std::map<Labels, std::unique_ptr<T>> m_metrics;
+    };
+
+    static std::atomic_bool s_enabled;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Family<Counter>> m_counters;
+    std::map<std::string, Family<Gauge>> m_gauges;
+    std::map<std::string, Family<Histogram>> m_histograms;
+  };
+
+  /// @brief Records the elapsed time in nanoseconds to a histogram when it goes out of scope
+  class AGENT_LIB_API ScopedTimer
+  {
+  public:
+    /// @brief time a scope with a histogram
+    /// @param[in] histogram the histogram, `nullptr` if the scope is not timed
+    ScopedTimer(Histogram *histogram)
+      : m_histogram(Registry::isEnabled() ? histogram : nullptr)
+    {
+      if (m_histogram)
+        m_start = std::chrono::steady_clock::now();
+    }
+    /// @brief time a scope with a histogram looked up by name when metrics are enabled
+    /// @param[in] name the metric name
+    /// @param[in] labels the labels
+    ScopedTimer(const std::string &name, const Labels &labels)
+      : m_histogram(Registry::isEnabled() ? &Registry::instance().histogram(name, labels)
+                                          : nullptr)
+    {
+      if (m_histogram)
+        m_start = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer()
+    {
+      if (m_histogram)
+        m_histogram->record(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - m_start)
+                                         .count()));
+    }
+
+  protected:
+    Histogram *m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  /// @brief Records the time spent in a scope excluding the time of nested `ExclusiveTimer`s
+  ///
+  /// Used for pipeline transforms where each transform calls the next transform, so the time
+  /// recorded for a transform does not include the transforms that follow it.
+  class AGENT_LIB_API ExclusiveTimer
+  {
+  public:
+    ExclusiveTimer(Histogram *histogram)
+      : m_histogram(Registry::isEnabled() ? histogram : nullptr)
+    {
+      if (m_histogram)
+      {
+        auto &nested = nestedTime();
+        m_saved = nested;
+        nested = 0;
+        m_start = std::chrono::steady_clock::now();
+      }
+    }
+    ~ExclusiveTimer()
+    {
+      if (m_histogram)
+      {
+        auto elapsed = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - m_start)
+                                    .count());
+        auto &nested = nestedTime();
+        m_histogram->record(elapsed > nested ? elapsed - nested : 0);
+        nested = m_saved + elapsed;
+      }
+    }
+
+  protected:
+    /// @brief the time recorded by nested timers on this thread
+    static uint64_t &nestedTime();
+
+    Histogram *m_histogram;
+    uint64_t m_saved {0};
+    std::chrono::steady_clock::time_point m_start;
+  };
+}  // namespace mtconnect::metrics
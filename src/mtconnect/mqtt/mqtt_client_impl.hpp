@@ -29,6 +29,7 @@
 
 #include "mqtt_client.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/source/adapter/adapter.hpp"
 #include "mtconnect/source/adapter/mqtt/mqtt_adapter.hpp"
 
@@ -227,6 +228,8 @@ namespace mtconnect {
         if (m_running)
         {
           m_running = false;
+          // The close handler is removed when the disconnect completes
+          m_connected = false;
 
           m_reconnectTimer.cancel();
           auto client = derived().getClient();
@@ -311,9 +314,26 @@ namespace mtconnect {
         else
           mretain = mqtt::retain::no;
 
+        // Time from the request until the publish completes, for QoS 1 and 2 this includes the
+        // broker acknowledgement
+        metrics::Histogram *latency = nullptr;
+        std::chrono::steady_clock::time_point start;
+        if (metrics::Registry::isEnabled())
+        {
+          static auto &histogram =
+              metrics::Registry::instance().histogram("mtconnect_mqtt_publish_latency_seconds");
+          latency = &histogram;
+          start = std::chrono::steady_clock::now();
+        }
+
         m_packetId = derived().getClient()->acquire_unique_packet_id();
         derived().getClient()->async_publish(
-            m_packetId, topic, payload, mqos | mretain, [topic](mqtt::error_code ec) {
+            m_packetId, topic, payload, mqos | mretain,
+            [topic, latency, start](mqtt::error_code ec) {
+              if (latency != nullptr)
+                latency->record(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - start)
+                                             .count()));
               if (ec)
               {
                 LOG(error) << "MqttClientImpl::publish: Publish failed to topic " << topic << ": "
@@ -16,22 +16,22 @@
 //
 
 #include <boost/log/trivial.hpp>
-#include <boost/multi_index/composite_key.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
 #include <boost/uuid/name_generator_sha1.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <inttypes.h>
+#include <mutex>
 #include <mqtt/async_client.hpp>
-#include <mqtt/broker/topic_filter.hpp>
 #include <mqtt/setup_log.hpp>
 #include <mqtt_server_cpp.hpp>
 
 #include "mqtt_server.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/source/adapter/adapter.hpp"
 #include "mtconnect/source/adapter/mqtt/mqtt_adapter.hpp"
+#include "topic_trie.hpp"
 
 using namespace std;
 namespace asio = boost::asio;
@@ -41,41 +41,27 @@ namespace mtconnect {
   using namespace entity;
   using namespace pipeline;
   using namespace source::adapter;
-  namespace mi = boost::multi_index;
 
   namespace mqtt_server {
 
     using con_t = MQTT_NS::server_tls_ws<>::endpoint_t;
     using con_sp_t = std::shared_ptr<con_t>;
 
-    struct sub_con
+    /// @brief A message waiting to be sent to a subscriber
+    struct OutboundMessage
     {
-      sub_con(MQTT_NS::buffer topic, con_sp_t con, MQTT_NS::qos qos_value)
-        : topic(std::move(topic)), con(std::move(con)), qos_value(qos_value)
-      {}
-      MQTT_NS::buffer topic;
-      con_sp_t con;
-      MQTT_NS::qos qos_value;
+      MQTT_NS::buffer m_topic;
+      MQTT_NS::buffer m_contents;  ///< shared by every subscriber the message is sent to
+      MQTT_NS::qos m_qos;
     };
 
-    struct tag_topic
-    {};
-    struct tag_con
-    {};
-    struct tag_con_topic
-    {};
-
-    using mi_sub_con = mi::multi_index_container<
-        sub_con,
-        mi::indexed_by<
-            mi::ordered_unique<
-                mi::tag<tag_con_topic>,
-                mi::composite_key<sub_con, BOOST_MULTI_INDEX_MEMBER(sub_con, con_sp_t, con),
-                                  BOOST_MULTI_INDEX_MEMBER(sub_con, MQTT_NS::buffer, topic)>>,
-            mi::ordered_non_unique<mi::tag<tag_topic>,
-                                   BOOST_MULTI_INDEX_MEMBER(sub_con, MQTT_NS::buffer, topic)>,
-            mi::ordered_non_unique<mi::tag<tag_con>,
-                                   BOOST_MULTI_INDEX_MEMBER(sub_con, con_sp_t, con)>>>;
+    /// @brief The messages waiting for a connection. Only one write is outstanding at a time so
+    /// a slow subscriber backs up its own queue and not the publisher.
+    struct Outbound
+    {
+      std::deque<OutboundMessage> m_queue;
+      bool m_writing {false};
+    };
 
     template <typename Derived>
     class MqttServerImpl : public MqttServer
@@ -87,11 +73,22 @@ namespace mtconnect {
       /// - Port, defaults to 0/1883
       /// - MqttTls, defaults to false
       /// - ServerIp, defaults to 127.0.0.1/LocalHost
+      /// - MqttMaxQueuedMessages, defaults to 1000, at least 1
       MqttServerImpl(boost::asio::io_context &ioContext, const ConfigOptions &options)
         : MqttServer(ioContext),
           m_options(options),
           m_host(*GetOption<std::string>(options, configuration::ServerIp))
       {
+        auto maxQueued =
+            GetOption<int>(options, configuration::MqttMaxQueuedMessages).value_or(1000);
+        if (maxQueued < 1)
+        {
+          LOG(warning) << "MqttMaxQueuedMessages set to " << maxQueued
+                       << ", limiting it to 1 message";
+          maxQueued = 1;
+        }
+        m_maxQueued = size_t(maxQueued);
+
         std::stringstream url;
         url << "mqtt://" << m_host << ':' << m_port;
         m_url = url.str();
@@ -144,6 +141,7 @@ namespace mtconnect {
             }
             if (will)
               m_will = will;
+            std::lock_guard<std::mutex> lock(m_mutex);
             m_connections.insert(sp);
             sp->connack(false, MQTT_NS::connect_return_code::accepted);
             return true;
@@ -158,10 +156,7 @@ namespace mtconnect {
               LOG(error) << "Server Endpoint has been deleted";
               return false;
             }
-            m_connections.erase(con);
-            auto &idx = m_subs.get<tag_con>();
-            auto r = idx.equal_range(con);
-            idx.erase(r.first, r.second);
+            removeConnection(con);
 
             return true;
           });
@@ -174,10 +169,7 @@ namespace mtconnect {
               LOG(error) << "Server Endpoint has been deleted";
               return false;
             }
-            m_connections.erase(con);
-            auto &idx = m_subs.get<tag_con>();
-            auto r = idx.equal_range(con);
-            idx.erase(r.first, r.second);
+            removeConnection(con);
 
             return true;
           });
@@ -194,37 +186,53 @@ namespace mtconnect {
                   LOG(error) << "Server Endpoint has been deleted";
                   return false;
                 }
-                for (auto const &e : entries)
                 {
-                  LOG(debug) << "Server: topic_filter: " << e.topic_filter
-                             << " qos: " << e.subopts.get_qos() << std::endl;
-                  res.emplace_back(MQTT_NS::qos_to_suback_return_code(e.subopts.get_qos()));
-                  m_subs.emplace(std::move(e.topic_filter), sp, e.subopts.get_qos());
+                  std::lock_guard<std::mutex> lock(m_mutex);
+                  for (auto const &e : entries)
+                  {
+                    LOG(debug) << "Server: topic_filter: " << e.topic_filter
+                               << " qos: " << e.subopts.get_qos() << std::endl;
+                    if (TopicTrie<con_sp_t, MQTT_NS::qos>::isValidFilter(e.topic_filter))
+                    {
+                      res.emplace_back(MQTT_NS::qos_to_suback_return_code(e.subopts.get_qos()));
+                      m_subscriptions.insert(e.topic_filter, sp, e.subopts.get_qos());
+                    }
+                    else
+                    {
+                      LOG(warning) << "Server: invalid topic filter: " << e.topic_filter;
+                      res.emplace_back(MQTT_NS::suback_return_code::failure);
+                    }
+                  }
                 }
                 sp->suback(packet_id, res);
                 return true;
               });
 
+          ep.set_unsubscribe_handler(
+              [this, wp](packet_id_t packet_id, std::vector<MQTT_NS::unsubscribe_entry> entries) {
+                LOG(debug) << "Server: Unsubscribe received. packet_id: " << packet_id;
+                auto sp = wp.lock();
+                if (!sp)
+                {
+                  LOG(error) << "Server Endpoint has been deleted";
+                  return false;
+                }
+                {
+                  std::lock_guard<std::mutex> lock(m_mutex);
+                  for (auto const &e : entries)
+                    m_subscriptions.erase(e.topic_filter, sp);
+                }
+                sp->unsuback(packet_id);
+                return true;
+              });
+
           ep.set_publish_handler([this](mqtt::optional<std::uint16_t> packet_id,
                                         mqtt::publish_options pubopts, mqtt::buffer topic_name,
                                         mqtt::buffer contents) {
-            LOG(debug) << "Server: publish received."
-                       << " dup: " << pubopts.get_dup() << " qos: " << pubopts.get_qos()
-                       << " retain: " << pubopts.get_retain() << std::endl;
+            LOG(trace) << "Server: publish received. topic: " << topic_name
+                       << " qos: " << pubopts.get_qos() << " size: " << contents.size();
 
-            if (packet_id)
-              LOG(debug) << "Server packet_id: " << *packet_id;
-
-            LOG(debug) << "Server topic_name: " << topic_name;
-            LOG(debug) << "Server contents: " << contents;
-
-            for (const auto &sub : m_subs)
-            {
-              if (mqtt::broker::compare_topic_filter(sub.topic, topic_name))
-              {
-                sub.con->publish(topic_name, contents, std::min(sub.qos_value, pubopts.get_qos()));
-              }
-            }
+            publish(topic_name, contents, pubopts.get_qos());
 
             return true;
           });
@@ -253,11 +261,135 @@ namespace mtconnect {
         }
       }
 
+    protected:
+      /// @brief Queue a message for every connection with a matching subscription
+      ///
+      /// A connection with overlapping subscriptions receives the message once with the highest
+      /// QoS of its matching subscriptions, limited by the QoS of the publish.
+      void publish(const MQTT_NS::buffer &topic, const MQTT_NS::buffer &contents, MQTT_NS::qos qos)
+      {
+        std::vector<std::pair<con_sp_t, MQTT_NS::qos>> matches;
+        std::vector<std::pair<con_sp_t, OutboundMessage>> writes;
+
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_subscriptions.match(topic, [&matches](const con_sp_t &con, MQTT_NS::qos subQos) {
+            matches.emplace_back(con, subQos);
+          });
+          if (matches.size() > 1)
+          {
+            std::sort(matches.begin(), matches.end(), [](const auto &a, const auto &b) {
+              return a.first != b.first ? a.first < b.first : a.second > b.second;
+            });
+            auto same = [](const auto &a, const auto &b) { return a.first == b.first; };
+            matches.erase(std::unique(matches.begin(), matches.end(), same), matches.end());
+          }
+
+          for (const auto &[con, subQos] : matches)
+          {
+            auto &outbound = m_outbound[con];
+            enqueue(outbound, {topic, contents, std::min(subQos, qos)});
+            if (auto message = take(outbound))
+              writes.emplace_back(con, std::move(*message));
+          }
+        }
+
+        for (auto &[con, message] : writes)
+          write(con, message);
+      }
+
+      /// @brief Add a message to a queue applying back-pressure
+      ///
+      /// When the queue is full the oldest QoS 0 message is dropped to make room. If all the queued
+      /// messages require delivery, the new message is dropped.
+      void enqueue(Outbound &outbound, OutboundMessage &&message)
+      {
+        if (outbound.m_queue.size() >= m_maxQueued)
+        {
+          auto it = std::find_if(outbound.m_queue.begin(), outbound.m_queue.end(), [](auto &m) {
+            return m.m_qos == MQTT_NS::qos::at_most_once;
+          });
+          if (it != outbound.m_queue.end())
+          {
+            dropped(it->m_qos);
+            outbound.m_queue.erase(it);
+          }
+          else
+          {
+            LOG(warning) << "Server: subscriber queue full, dropping message for "
+                         << message.m_topic;
+            dropped(message.m_qos);
+            return;
+          }
+        }
+
+        outbound.m_queue.emplace_back(std::move(message));
+      }
+
+      /// @brief Take the next message to write if no write is outstanding
+      std::optional<OutboundMessage> take(Outbound &outbound)
+      {
+        if (outbound.m_writing || outbound.m_queue.empty())
+          return std::nullopt;
+
+        outbound.m_writing = true;
+        auto message = std::move(outbound.m_queue.front());
+        outbound.m_queue.pop_front();
+        return message;
+      }
+
+      /// @brief Write a message and continue with the connection's queue when it completes
+      void write(const con_sp_t &con, const OutboundMessage &message)
+      {
+        std::weak_ptr<con_t> wp = con;
+        con->async_publish(message.m_topic, message.m_contents, message.m_qos,
+                           [this, wp](MQTT_NS::error_code ec) {
+                             if (ec)
+                               LOG(warning) << "Server: publish failed: " << ec.message();
+
+                             auto con = wp.lock();
+                             if (!con)
+                               return;
+
+                             std::optional<OutboundMessage> next;
+                             {
+                               std::lock_guard<std::mutex> lock(m_mutex);
+                               auto it = m_outbound.find(con);
+                               if (it == m_outbound.end())
+                                 return;
+                               it->second.m_writing = false;
+                               next = take(it->second);
+                             }
+                             if (next)
+                               write(con, *next);
+                           });
+      }
+
+      void removeConnection(const con_sp_t &con)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connections.erase(con);
+        m_subscriptions.erase(con);
+        m_outbound.erase(con);
+      }
+
+      static void dropped(MQTT_NS::qos qos)
+      {
+        if (metrics::Registry::isEnabled())
+          metrics::Registry::instance()
+              .counter("mtconnect_mqtt_server_dropped_total", {{"qos", std::to_string(int(qos))}})
+              .add();
+      }
+
     protected:
       ConfigOptions m_options;
-      std::set<con_sp_t> m_connections;
-      mi_sub_con m_subs;
       std::string m_host;
+      size_t m_maxQueued {1000};
+
+      std::mutex m_mutex;
+      std::set<con_sp_t> m_connections;
+      TopicTrie<con_sp_t, MQTT_NS::qos> m_subscriptions;
+      std::map<con_sp_t, Outbound> m_outbound;
     };
 
     /// @brief Create an Mqtt TCP server
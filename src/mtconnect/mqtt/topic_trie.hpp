@@ -0,0 +1,288 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mtconnect::mqtt_server {
+  /// @brief Subscriptions indexed by topic filter level for matching topic names
+  ///
+  /// Each level of a filter is a node in the trie with the single level `+` and multi-level `#`
+  /// wildcards held separately from the named children. Matching a topic name only visits the
+  /// nodes that can match its levels, so the cost depends on the depth of the topic and not on the
+  /// number of subscriptions.
+  ///
+  /// @tparam Subscriber the subscriber, must be ordered
+  /// @tparam Value the value stored with each subscription, for example the QoS
+  template <typename Subscriber, typename Value>
+  class TopicTrie
+  {
+  public:
+    /// @brief Check if a topic filter is valid
+    ///
+    /// The filter must not be empty, `+` must occupy a whole level, and `#` must occupy the last
+    /// level.
+    /// @param[in] filter the topic filter
+    /// @return `true` if the filter is valid
+    static bool isValidFilter(std::string_view filter)
+    {
+      if (filter.empty())
+        return false;
+
+      for (size_t pos = 0;;)
+      {
+        auto end = filter.find('/', pos);
+        auto level = filter.substr(pos, end == std::string_view::npos ? end : end - pos);
+        if (level.size() > 1 && level.find_first_of("+#") != std::string_view::npos)
+          return false;
+        if (level == "#" && end != std::string_view::npos)
+          return false;
+        if (end == std::string_view::npos)
+          return true;
+        pos = end + 1;
+      }
+    }
+
+    /// @brief Add or replace a subscription
+    /// @param[in] filter a valid topic filter
+    /// @param[in] subscriber the subscriber
+    /// @param[in] value the value for the subscription
+    /// @return `true` if the subscription is new, `false` if it replaced an existing one
+    bool insert(std::string_view filter, const Subscriber &subscriber, const Value &value)
+    {
+      auto node = &m_root;
+      forEachLevel(filter, [&node](std::string_view level) {
+        std::unique_ptr<Node> *child;
+        if (level == "+")
+          child = &node->m_single;
+        else if (level == "#")
+          child = &node->m_multi;
+        else
+        {
+          auto it = node->m_children.find(level);
+          if (it == node->m_children.end())
+            it = node->m_children.emplace(std::string(level), nullptr).first;
+          child = &it->second;
+        }
+        if (!*child)
+          *child = std::make_unique<Node>();
+        node = child->get();
+      });
+
+      auto [it, added] = node->m_subscribers.insert_or_assign(subscriber, value);
+      if (added)
+      {
+        m_filters[subscriber].emplace(filter);
+        m_size++;
+      }
+      return added;
+    }
+
+    /// @brief Remove a subscription
+    /// @param[in] filter the topic filter
+    /// @param[in] subscriber the subscriber
+    /// @return `true` if the subscription was removed
+    bool erase(std::string_view filter, const Subscriber &subscriber)
+    {
+      auto filters = m_filters.find(subscriber);
+      if (filters == m_filters.end())
+        return false;
+      auto f = filters->second.find(filter);
+      if (f == filters->second.end())
+        return false;
+
+      remove(filter, subscriber);
+      filters->second.erase(f);
+      if (filters->second.empty())
+        m_filters.erase(filters);
+      return true;
+    }
+
+    /// @brief Remove all the subscriptions of a subscriber
+    /// @param[in] subscriber the subscriber
+    /// @return the number of subscriptions removed
+    size_t erase(const Subscriber &subscriber)
+    {
+      auto filters = m_filters.find(subscriber);
+      if (filters == m_filters.end())
+        return 0;
+
+      auto count = filters->second.size();
+      for (const auto &filter : filters->second)
+        remove(filter, subscriber);
+      m_filters.erase(filters);
+      return count;
+    }
+
+    /// @brief Call a function for every subscription whose filter matches a topic name
+    ///
+    /// A subscriber with overlapping filters is visited once for each matching filter. Wildcards
+    /// in the first level do not match topic names starting with `$`.
+    ///
+    /// @param[in] topic the topic name
+    /// @param[in] func called with the subscriber and the value
+    template <typename Func>
+    void match(std::string_view topic, Func &&func) const
+    {
+      match(m_root, topic, true, func);
+    }
+
+    /// @brief Get the filters of a subscriber
+    /// @param[in] subscriber the subscriber
+    /// @return the filters, empty if it has no subscriptions
+    std::vector<std::string> filters(const Subscriber &subscriber) const
+    {
+      auto it = m_filters.find(subscriber);
+      if (it == m_filters.end())
+        return {};
+      return {it->second.begin(), it->second.end()};
+    }
+
+    /// @brief the number of subscriptions
+    size_t size() const { return m_size; }
+    /// @brief `true` if there are no subscriptions
+    bool empty() const { return m_size == 0; }
+
+  protected:
+    struct Node
+    {
+      std::map<std::string, std::unique_ptr<Node>, std::less<>> m_children;
+      std::unique_ptr<Node> m_single;  ///< `+`
+      std::unique_ptr<Node> m_multi;   ///< `#`
+      std::map<Subscriber, Value> m_subscribers;
+
+      bool empty() const
+      {
+        return m_children.empty() && !m_single && !m_multi && m_subscribers.empty();
+      }
+    };
+
+    template <typename Func>
+    static void forEachLevel(std::string_view filter, Func &&func)
+    {
+      for (size_t pos = 0;;)
+      {
+        auto end = filter.find('/', pos);
+        if (end == std::string_view::npos)
+        {
+          func(filter.substr(pos));
+          break;
+        }
+        func(filter.substr(pos, end - pos));
+        pos = end + 1;
+      }
+    }
+
+    template <typename Func>
+    static void visit(const Node &node, Func &func)
+    {
+      for (const auto &[subscriber, value] : node.m_subscribers)
+        func(subscriber, value);
+    }
+
+    template <typename Func>
+    static void match(const Node &node, std::string_view topic, bool first, Func &func)
+    {
+      auto end = topic.find('/');
+      auto level = topic.substr(0, end);
+      std::optional<std::string_view> rest;
+      if (end != std::string_view::npos)
+        rest = topic.substr(end + 1);
+
+      if (!first || !level.starts_with('$'))
+      {
+        if (node.m_multi)
+          visit(*node.m_multi, func);
+        if (node.m_single)
+          matchChild(*node.m_single, rest, func);
+      }
+
+      auto named = node.m_children.find(level);
+      if (named != node.m_children.end())
+        matchChild(*named->second, rest, func);
+    }
+
+    template <typename Func>
+    static void matchChild(const Node &node, const std::optional<std::string_view> &rest,
+                           Func &func)
+    {
+      if (rest)
+        match(node, *rest, false, func);
+      else
+      {
+        visit(node, func);
+        // `a/#` also matches `a`
+        if (node.m_multi)
+          visit(*node.m_multi, func);
+      }
+    }
+
+    static std::unique_ptr<Node> *child(Node &node, std::string_view level)
+    {
+      if (level == "+")
+        return &node.m_single;
+      else if (level == "#")
+        return &node.m_multi;
+      else if (auto it = node.m_children.find(level); it != node.m_children.end())
+        return &it->second;
+      else
+        return nullptr;
+    }
+
+    void remove(std::string_view filter, const Subscriber &subscriber)
+    {
+      std::vector<std::pair<Node *, std::string_view>> path;
+      Node *node = &m_root;
+      forEachLevel(filter, [&](std::string_view level) {
+        if (node == nullptr)
+          return;
+        path.emplace_back(node, level);
+        auto next = child(*node, level);
+        node = next != nullptr ? next->get() : nullptr;
+      });
+
+      if (node == nullptr || node->m_subscribers.erase(subscriber) == 0)
+        return;
+      m_size--;
+
+      // Prune the empty nodes from the leaf up
+      for (auto it = path.rbegin(); it != path.rend(); it++)
+      {
+        auto &[parent, level] = *it;
+        auto next = child(*parent, level);
+        if (!(*next)->empty())
+          break;
+        if (level == "+" || level == "#")
+          next->reset();
+        else
+          parent->m_children.erase(parent->m_children.find(level));
+      }
+    }
+
+  protected:
+    Node m_root;
+    std::map<Subscriber, std::set<std::string, std::less<>>> m_filters;
+    size_t m_size {0};
+  };
+}  // namespace mtconnect::mqtt_server
@@ -108,9 +108,12 @@ namespace mtconnect {
     ObservationPtr Observation::make(const DataItemPtr dataItem, const Properties &incompingProps,
                                      const Timestamp &timestamp, entity::ErrorList &errors)
     {
-      NAMED_SCOPE("Observation");
+      HOT_NAMED_SCOPE("Observation");
 
-      auto props = entity::Properties(incompingProps);
+      // Reserve the space for the data item properties and the timestamp up front
+      entity::Properties props;
+      props.reserve(incompingProps.size() + dataItem->getObservationProperties().size() + 1);
+      props.insert(incompingProps.begin(), incompingProps.end());
       setProperties(dataItem, props);
       props.insert_or_assign("timestamp", timestamp);
 
@@ -426,51 +429,33 @@ namespace mtconnect {
       return factory;
     }
 
-    bool Condition::replace(ConditionPtr &old, ConditionPtr &_new)
+    void ConditionState::add(ConditionPtr condition)
     {
-      if (!m_prev)
-        return false;
-
-      if (m_prev == old)
-      {
-        _new->m_prev = old->m_prev;
-        m_prev = _new;
-        return true;
-      }
-
-      return m_prev->replace(old, _new);
-    }
-
-    ConditionPtr Condition::deepCopy()
-    {
-      auto n = make_shared<Condition>(*this);
+      erase(condition->getCode());
 
-      if (m_prev)
+      // The conditions in a state do not carry their own state. Otherwise each condition would
+      // hold the conditions that were active before it and a cleared condition would never be
+      // released.
+      if (!condition->getActive().empty())
       {
-        n->m_prev = m_prev->deepCopy();
+        condition = make_shared<Condition>(*condition);
+        condition->setActive(ConditionState());
       }
 
-      return n;
+      auto order = m_next++;
+      m_codes.insert(Code {condition->getCode(), order});
+      m_conditions.insert(Entry {order, condition});
     }
 
-    ConditionPtr Condition::deepCopyAndRemove(ConditionPtr &old)
+    bool ConditionState::erase(const std::string &code)
     {
-      if (this->getptr() == old)
-      {
-        if (m_prev)
-          return m_prev->deepCopy();
-        else
-          return nullptr;
-      }
-
-      auto n = make_shared<Condition>(*this);
-
-      if (m_prev)
-      {
-        n->m_prev = m_prev->deepCopyAndRemove(old);
-      }
+      auto it = m_codes.find(Code {code});
+      if (it == m_codes.end())
+        return false;
 
-      return n;
+      m_conditions.erase(Entry {it->m_order, nullptr});
+      m_codes.erase(it);
+      return true;
     }
   }  // namespace observation
 }  // namespace mtconnect
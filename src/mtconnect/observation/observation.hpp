@@ -67,7 +67,7 @@ namespace mtconnect::observation {
     static void setProperties(const DataItemPtr dataItem, entity::Properties &props)
     {
       for (auto &prop : dataItem->getObservationProperties())
-        props.emplace(prop);
+        props.insert(prop);
     }
 
     /// @brief set the associated data item and its properties
@@ -224,10 +224,93 @@ namespace mtconnect::observation {
   using ConditionPtr = std::shared_ptr<Condition>;
   using ConditionList = std::list<ConditionPtr>;
 
+  /// @brief The active conditions of a condition data item
+  ///
+  /// The conditions are kept in the order they were activated and are indexed by their code, the
+  /// `conditionId` or `nativeCode`. Copies share their nodes, adding or removing a condition only
+  /// copies the O(log n) nodes on the path to the change, so the state can be shared between the
+  /// observations in the buffer and the checkpoints.
+  class AGENT_LIB_API ConditionState
+  {
+  public:
+    /// @brief A condition and its activation order
+    struct Entry
+    {
+      uint64_t m_order;
+      ConditionPtr m_condition;
+
+      bool operator<(const Entry &other) const { return m_order < other.m_order; }
+    };
+
+    using const_iterator = entity::data_set::PersistentSet<Entry>::const_iterator;
+    using const_reverse_iterator = entity::data_set::PersistentSet<Entry>::const_reverse_iterator;
+
+    /// @brief find the active condition with a code
+    /// @param[in] code the code
+    /// @return shared pointer to the condition if found
+    ConditionPtr find(const std::string &code) const
+    {
+      auto it = m_codes.find(Code {code});
+      if (it == m_codes.end())
+        return nullptr;
+      return m_conditions.find(Entry {it->m_order, nullptr})->m_condition;
+    }
+    /// @brief add a condition as the most recent, replacing the condition with the same code
+    ///
+    /// If the condition has other active conditions, a copy without them is added.
+    /// @param[in] condition the condition
+    void add(ConditionPtr condition);
+    /// @brief remove the condition with a code
+    /// @param[in] code the code
+    /// @return `true` if a condition was removed
+    bool erase(const std::string &code);
+
+    /// @brief get the conditions, the oldest first
+    /// @param[out] list the conditions
+    void getConditionList(ConditionList &list) const
+    {
+      for (const auto &e : m_conditions)
+        list.emplace_back(e.m_condition);
+    }
+    /// @brief get the first condition that was activated
+    /// @return the condition or `nullptr` if empty
+    ConditionPtr first() const { return empty() ? nullptr : m_conditions.begin()->m_condition; }
+    /// @brief get the most recent condition
+    /// @return the condition or `nullptr` if empty
+    ConditionPtr last() const { return empty() ? nullptr : m_conditions.rbegin()->m_condition; }
+
+    /// @name Iterators in activation order
+    ///@{
+    const_iterator begin() const { return m_conditions.begin(); }
+    const_iterator end() const { return m_conditions.end(); }
+    const_reverse_iterator rbegin() const { return m_conditions.rbegin(); }
+    const_reverse_iterator rend() const { return m_conditions.rend(); }
+    ///@}
+
+    /// @brief the number of active conditions
+    size_t size() const { return m_conditions.size(); }
+    /// @brief `true` if there are no active conditions
+    bool empty() const { return m_conditions.empty(); }
+
+  protected:
+    struct Code
+    {
+      std::string m_code;
+      uint64_t m_order {0};
+
+      bool operator<(const Code &other) const { return m_code < other.m_code; }
+    };
+
+    entity::data_set::PersistentSet<Entry> m_conditions;
+    entity::data_set::PersistentSet<Code> m_codes;
+    uint64_t m_next {0};
+  };
+
   /// @brief An MTConnect Condition
   ///
-  /// Conditions are linked together to keep track of all the conditions that are
-  /// active at one time. When the normal condition arrives, the list is cleared.
+  /// Each condition carries the state of the other conditions of the data item that were active
+  /// when it was added. The conditions in the state do not carry a state of their own. When the
+  /// normal condition arrives, the state is cleared.
   class AGENT_LIB_API Condition : public Observation
   {
   public:
@@ -316,29 +399,28 @@ namespace mtconnect::observation {
       }
     }
 
-    /// @brief get the first condition in the chain
+    /// @brief get the first active condition
     ///
-    /// Conditions are chained together to allow for mutiple conditions active at the same time
-    /// @return shared pointer the first condition in the chain
+    /// Conditions carry the state of the other active conditions to allow for mutiple conditions
+    /// active at the same time
+    /// @return shared pointer the first active condition
     ConditionPtr getFirst()
     {
-      if (m_prev)
-        return m_prev->getFirst();
+      if (!m_active.empty())
+        return m_active.first();
 
       return getptr();
     }
 
     /// @brief Get a list of all active conditions
-    /// @param[out] list the list condtions
+    /// @param[out] list the list condtions, the oldest first
     void getConditionList(ConditionList &list)
     {
-      if (m_prev)
-        m_prev->getConditionList(list);
-
+      m_active.getConditionList(list);
       list.emplace_back(getptr());
     }
 
-    /// @brief find a condition by code in the condition list
+    /// @brief find a condition by code in the active conditions
     /// @param[in] code te code
     /// @return shared pointer to the condition if found
     ConditionPtr find(const std::string &code)
@@ -346,13 +428,10 @@ namespace mtconnect::observation {
       if (m_code == code)
         return getptr();
 
-      if (m_prev)
-        return m_prev->find(code);
-
-      return nullptr;
+      return m_active.find(code);
     }
 
-    /// @brief const find a condition by code in the condition list
+    /// @brief const find a condition by code in the active conditions
     /// @param[in] code te code
     /// @return shared pointer to the condition if found
     const ConditionPtr find(const std::string &code) const
@@ -360,24 +439,17 @@ namespace mtconnect::observation {
       if (m_code == code)
         return std::dynamic_pointer_cast<Condition>(Entity::getptr());
 
-      if (m_prev)
-        return m_prev->find(code);
-
-      return nullptr;
+      return m_active.find(code);
     }
 
-    /// @brief replace a condition with another in the condition list
-    /// @param[in] old the condition to be placed
-    /// @param[in] _new the replacement condition
-    /// @return `true` if the old condition was found
-    bool replace(ConditionPtr &old, ConditionPtr &_new);
-    /// @brief copy the condition and all conditions in the list
-    /// @return a new shared condition pointer
-    ConditionPtr deepCopy();
-    /// @brief copy the condition and all conditions in the list removing one condition
-    /// @param[in] old the condition to skip
-    /// @return the new condition pointer
-    ConditionPtr deepCopyAndRemove(ConditionPtr &old);
+    /// @brief get the active conditions including this condition
+    /// @return the state with this condition as the most recent
+    ConditionState getActiveConditions()
+    {
+      auto state = m_active;
+      state.add(getptr());
+      return state;
+    }
 
     /// @brief Get the code for the condition
     /// @return the code
@@ -385,17 +457,26 @@ namespace mtconnect::observation {
     /// @brief get the condition level
     /// @return the level
     Level getLevel() const { return m_level; }
-    /// @brief get the previous condition in the list
+    /// @brief get the most recent of the other active conditions
+    ///
+    /// The previous condition does not carry a state, use `getConditionList()` to get all the
+    /// active conditions.
     /// @return the previous condition if it exists
-    ConditionPtr getPrev() const { return m_prev; }
-    /// @brief make a condition as the previous condition linking it to the list
+    ConditionPtr getPrev() const { return m_active.last(); }
+    /// @brief get the other conditions active with this condition
+    /// @return the active conditions, not including this condition
+    const ConditionState &getActive() const { return m_active; }
+    /// @brief set the other conditions active with this condition
+    /// @param[in] active the active conditions, must not include this condition
+    void setActive(const ConditionState &active) { m_active = active; }
+    /// @brief make a condition and its active conditions the other active conditions
     /// @param[in] cond the previous condition
-    void appendTo(ConditionPtr cond) { m_prev = cond; }
+    void appendTo(ConditionPtr cond) { m_active = cond->getActiveConditions(); }
 
   protected:
     std::string m_code;
     Level m_level {NORMAL};
-    ConditionPtr m_prev;
+    ConditionState m_active;
   };
 
   /// @brief an MTConnect Event with a string value or controlled vocabulary
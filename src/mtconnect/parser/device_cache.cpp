@@ -0,0 +1,345 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "device_cache.hpp"
+
+#include <boost/beast/core/detail/base64.hpp>
+#include <boost/uuid/detail/sha1.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "mtconnect/entity/binary_codec.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mtconnect::parser {
+  using namespace entity;
+  using namespace device_model;
+
+  namespace {
+    constexpr char Magic[8] = {'M', 'T', 'C', 'D', 'E', 'V', 'S', '\0'};
+    constexpr uint32_t Version = 1;
+
+    /// @brief How a property value is encoded
+    enum PropertyKind : uint8_t
+    {
+      VALUE = 0,        ///< Encoded with `putValue()`
+      ENTITY = 1,       ///< A nested entity
+      ENTITY_LIST = 2,  ///< A list of nested entities
+    };
+
+    bool readFile(const fs::path &path, string &contents)
+    {
+      ifstream in(path, ios::binary);
+      if (!in)
+        return false;
+      contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+      return !in.bad();
+    }
+
+    string fileHash(const string &contents)
+    {
+      boost::uuids::detail::sha1 sha1;
+      sha1.process_bytes(contents.data(), contents.size());
+
+      unsigned char digest[20];
+      sha1.get_digest(digest);
+
+      char encoded[32];
+      auto len = boost::beast::detail::base64::encode(encoded, digest, sizeof(digest));
+
+      return string(encoded, len);
+    }
+
+    class ModelEncoder : public BinaryEncoder
+    {
+    public:
+      using BinaryEncoder::BinaryEncoder;
+
+      void putEntity(const EntityPtr &entity)
+      {
+        putString(entity->getName());
+
+        auto order = entity->getOrder();
+        put<uint32_t>(order ? uint32_t(order->size()) : 0);
+        if (order)
+        {
+          for (const auto &[name, index] : *order)
+          {
+            putString(name);
+            put<int32_t>(index);
+          }
+        }
+
+        const auto &attrs = entity->getAttributes();
+        put<uint32_t>(uint32_t(attrs.size()));
+        for (const auto &attr : attrs)
+          putString(attr);
+
+        const auto &props = entity->getProperties();
+        put<uint32_t>(uint32_t(props.size()));
+        for (const auto &[key, value] : props)
+        {
+          putString(key);
+          if (holds_alternative<EntityPtr>(value))
+          {
+            put<uint8_t>(ENTITY);
+            putEntity(get<EntityPtr>(value));
+          }
+          else if (holds_alternative<EntityList>(value))
+          {
+            const auto &list = get<EntityList>(value);
+            put<uint8_t>(ENTITY_LIST);
+            put<uint32_t>(uint32_t(list.size()));
+            for (const auto &e : list)
+              putEntity(e);
+          }
+          else
+          {
+            put<uint8_t>(VALUE);
+            putValue(value);
+          }
+        }
+      }
+    };
+
+    class ModelDecoder : public BinaryDecoder
+    {
+    public:
+      using BinaryDecoder::BinaryDecoder;
+
+      /// @brief Recreate an entity with the factory the XML parser would have used. Throws
+      /// `EntityError` if the entity cannot be created.
+      EntityPtr getEntity(const FactoryPtr &parent)
+      {
+        QName name(getString());
+        auto factory = parent->factoryFor(name);
+        if (!factory)
+          throw EntityError("No factory for cached entity", name);
+
+        OrderMapPtr order;
+        if (auto count = get<uint32_t>(); count > 0)
+        {
+          order = make_shared<OrderMap>();
+          for (uint32_t i = 0; i < count; i++)
+          {
+            auto key = getString();
+            order->emplace(key, get<int32_t>());
+          }
+        }
+        else if (factory->isAny())
+        {
+          order = make_shared<OrderMap>();
+        }
+
+        AttributeSet attrs;
+        auto attrCount = get<uint32_t>();
+        for (uint32_t i = 0; i < attrCount; i++)
+          attrs.emplace(getString());
+
+        // The properties were written in key order, so each one is added at the end
+        Properties properties;
+        auto count = getCount();
+        properties.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+          PropertyKey key(getString());
+          switch (get<uint8_t>())
+          {
+            case ENTITY:
+              properties.insert({key, getEntity(factory)});
+              break;
+
+            case ENTITY_LIST:
+            {
+              EntityList list;
+              auto size = get<uint32_t>();
+              for (uint32_t j = 0; j < size; j++)
+                list.emplace_back(getEntity(factory));
+              properties.insert({key, std::move(list)});
+              break;
+            }
+
+            default:
+              properties.insert({key, getValue()});
+              break;
+          }
+        }
+
+        ErrorList errors;
+        auto entity = factory->make(name, properties, errors);
+        if (!entity || !errors.empty())
+          throw EntityError("Cached entity is not valid", name);
+
+        if (order)
+          entity->setOrder(order);
+        if (!attrs.empty())
+          entity->setAttributes(attrs);
+
+        return entity;
+      }
+    };
+  }  // namespace
+
+  DeviceCache::DeviceCache(const fs::path &directory) : m_directory(directory)
+  {
+    // A cache that cannot be written only costs a parse, so it must not stop the agent
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec || !fs::is_directory(m_directory, ec))
+    {
+      LOG(warning) << "DeviceCache: cannot create " << m_directory << ": "
+                   << (ec ? ec.message() : "not a directory"s) << ", the cache is disabled";
+      m_enabled = false;
+    }
+  }
+
+  optional<DeviceCache::Model> DeviceCache::load(const fs::path &file) const
+  {
+    NAMED_SCOPE("DeviceCache::load");
+
+    if (!m_enabled)
+      return nullopt;
+
+    auto path = getCachePath(file);
+    string contents, cache;
+    if (!fs::exists(path) || !readFile(file, contents) || !readFile(path, cache))
+      return nullopt;
+
+    if (cache.size() < sizeof(Magic) + sizeof(Version) ||
+        memcmp(cache.data(), Magic, sizeof(Magic)) != 0)
+    {
+      LOG(warning) << "DeviceCache: " << path << " is not a device cache";
+      return nullopt;
+    }
+
+    try
+    {
+      ModelDecoder decoder(cache.data() + sizeof(Magic), cache.size() - sizeof(Magic));
+      if (decoder.get<uint32_t>() != Version || decoder.getString() != GetAgentVersion() ||
+          decoder.getString() != fileHash(contents))
+      {
+        LOG(info) << "DeviceCache: " << path << " is out of date for " << file;
+        return nullopt;
+      }
+
+      Model model;
+      if (decoder.get<uint8_t>() != 0)
+        model.m_schemaVersion = decoder.getString();
+
+      auto nsCount = decoder.get<uint32_t>();
+      for (uint32_t i = 0; i < nsCount; i++)
+      {
+        DevicesNamespace ns;
+        ns.m_urn = decoder.getString();
+        ns.m_location = decoder.getString();
+        ns.m_prefix = decoder.getString();
+        model.m_namespaces.emplace_back(std::move(ns));
+      }
+
+      auto root = Device::getRoot();
+      auto deviceCount = decoder.get<uint32_t>();
+      for (uint32_t i = 0; i < deviceCount; i++)
+      {
+        auto device = dynamic_pointer_cast<Device>(decoder.getEntity(root));
+        if (!device)
+          throw EntityError("Cached entity is not a device");
+        model.m_devices.emplace_back(device);
+      }
+
+      if (!decoder.atEnd())
+        throw out_of_range("Trailing data");
+
+      LOG(info) << "DeviceCache: loaded " << model.m_devices.size() << " devices for " << file
+                << " from " << path;
+      return model;
+    }
+    catch (EntityError &e)
+    {
+      LOG(warning) << "DeviceCache: cannot recreate the devices from " << path << ": "
+                   << e.what();
+    }
+    catch (exception &e)
+    {
+      // Truncated data, a bad count or a value of the wrong type: parse the Devices file instead
+      LOG(warning) << "DeviceCache: " << path << " is corrupt: " << e.what();
+    }
+
+    return nullopt;
+  }
+
+  bool DeviceCache::save(const fs::path &file, const Model &model) const
+  {
+    NAMED_SCOPE("DeviceCache::save");
+
+    string contents;
+    if (!m_enabled || !readFile(file, contents))
+      return false;
+
+    string cache(Magic, sizeof(Magic));
+    ModelEncoder encoder(cache);
+    encoder.put<uint32_t>(Version);
+    encoder.putString(GetAgentVersion());
+    encoder.putString(fileHash(contents));
+
+    encoder.put<uint8_t>(model.m_schemaVersion ? 1 : 0);
+    if (model.m_schemaVersion)
+      encoder.putString(*model.m_schemaVersion);
+
+    encoder.put<uint32_t>(uint32_t(model.m_namespaces.size()));
+    for (const auto &ns : model.m_namespaces)
+    {
+      encoder.putString(ns.m_urn);
+      encoder.putString(ns.m_location);
+      encoder.putString(ns.m_prefix);
+    }
+
+    encoder.put<uint32_t>(uint32_t(model.m_devices.size()));
+    for (const auto &device : model.m_devices)
+      encoder.putEntity(device);
+
+    // Write to a temporary file and rename it so a partial cache is never read
+    auto path = getCachePath(file);
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+      ofstream out(tmp, ios::binary | ios::trunc);
+      out.write(cache.data(), cache.size());
+      if (!out)
+      {
+        LOG(warning) << "DeviceCache: cannot write " << tmp;
+        return false;
+      }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec)
+    {
+      LOG(warning) << "DeviceCache: cannot write " << path << ": " << ec.message();
+      fs::remove(tmp, ec);
+      return false;
+    }
+
+    return true;
+  }
+}  // namespace mtconnect::parser
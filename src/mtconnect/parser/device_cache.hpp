@@ -0,0 +1,77 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <string>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/parser/xml_parser.hpp"
+
+namespace mtconnect::parser {
+  /// @brief Binary cache of the device model parsed from a Devices file
+  ///
+  /// The devices are stored as they are created by the entity factories, before the agent adds
+  /// its data items and unique ids, and are recreated through the same factories without parsing
+  /// the XML. The cache is only used if the SHA-1 of the Devices file and the agent version match
+  /// the ones it was written with.
+  class AGENT_LIB_API DeviceCache
+  {
+  public:
+    /// @brief The device model and the document level information from a Devices file
+    struct Model
+    {
+      std::list<device_model::DevicePtr> m_devices;
+      std::optional<std::string> m_schemaVersion;
+      std::list<DevicesNamespace> m_namespaces;
+    };
+
+    /// @brief Create a cache in a directory
+    /// @param[in] directory the directory for the cache files, created if it does not exist. The
+    ///                      cache is disabled if the directory cannot be created.
+    DeviceCache(const std::filesystem::path &directory);
+
+    /// @brief `true` if the cache directory exists and the cache can be used
+    bool isEnabled() const { return m_enabled; }
+
+    /// @brief Load the model for a Devices file
+    /// @param[in] file the Devices file
+    /// @return the model if the cache is current for the file
+    std::optional<Model> load(const std::filesystem::path &file) const;
+    /// @brief Save the model parsed from a Devices file
+    /// @param[in] file the Devices file
+    /// @param[in] model the model parsed from the file
+    /// @return `true` if the cache was written
+    bool save(const std::filesystem::path &file, const Model &model) const;
+
+    /// @brief get the path of the cache for a Devices file
+    /// @param[in] file the Devices file
+    /// @return the path of the cache file
+    std::filesystem::path getCachePath(const std::filesystem::path &file) const
+    {
+      return m_directory / (file.filename().string() + ".mtdc");
+    }
+
+  protected:
+    std::filesystem::path m_directory;
+    bool m_enabled {true};
+  };
+}  // namespace mtconnect::parser
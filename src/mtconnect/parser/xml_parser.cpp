@@ -94,7 +94,8 @@ namespace mtconnect::parser {
     return !strncmp(aUrn, "urn:mtconnect.org:MTConnect", 27u);
   }
 
-  std::list<DevicePtr> XmlParser::parseFile(const std::string &filePath, XmlPrinter *aPrinter)
+  std::list<DevicePtr> XmlParser::parseFile(const std::string &filePath, XmlPrinter *aPrinter,
+                                            size_t threads)
   {
     using namespace boost::adaptors;
     using namespace boost::range;
@@ -110,6 +111,7 @@ namespace mtconnect::parser {
     xmlXPathContextPtr xpathCtx = nullptr;
     xmlXPathObjectPtr devices = nullptr;
     std::list<DevicePtr> deviceList;
+    m_devicesNamespaces.clear();
 
     try
     {
@@ -162,6 +164,7 @@ namespace mtconnect::parser {
             prefix = (const char *)ns->prefix;
 
           aPrinter->addDevicesNamespace(locationUrn, uri, prefix);
+          m_devicesNamespaces.push_back({locationUrn, uri, prefix});
         }
       }
 
@@ -181,6 +184,7 @@ namespace mtconnect::parser {
             string urn = (const char *)ns->href;
             string prefix = (const char *)ns->prefix;
             aPrinter->addDevicesNamespace(urn, "", prefix);
+            m_devicesNamespaces.push_back({urn, "", prefix});
           }
 
           ns = ns->next;
@@ -197,12 +201,17 @@ namespace mtconnect::parser {
       {
         xmlNodeSetPtr nodeset = devices->nodesetval;
 
-        entity::ErrorList errors;
-        for (int i = 0; i != nodeset->nodeNr; ++i)
-        {
-          auto device =
-              entity::XmlParser::parseXmlNode(Device::getRoot(), nodeset->nodeTab[i], errors);
+        // Each device is parsed into its own slot so the list keeps the document order
+        auto root = Device::getRoot();
+        std::vector<entity::EntityPtr> parsed(nodeset->nodeNr);
+        std::vector<entity::ErrorList> errors(nodeset->nodeNr);
+        ParallelFor(threads, parsed.size(), [&](size_t i) {
+          parsed[i] = entity::XmlParser::parseXmlNode(root, nodeset->nodeTab[i], errors[i]);
+        });
 
+        for (size_t i = 0; i < parsed.size(); i++)
+        {
+          auto &device = parsed[i];
           if (device)
           {
             deviceList.emplace_back(dynamic_pointer_cast<Device>(device));
@@ -212,16 +221,13 @@ namespace mtconnect::parser {
             LOG(error) << "Failed to parse device, skipping";
           }
 
-          if (!errors.empty())
+          for (auto &e : errors[i])
           {
-            for (auto &e : errors)
-            {
-              if (device)
-                LOG(warning) << "When loading device " << device->get<string>("name")
-                             << ", A problem was skipped: " << e->what();
-              else
-                LOG(error) << "Failed to load device: " << e->what();
-            }
+            if (device)
+              LOG(warning) << "When loading device " << device->get<string>("name")
+                           << ", A problem was skipped: " << e->what();
+            else
+              LOG(error) << "Failed to load device: " << e->what();
           }
         }
       }
@@ -37,6 +37,14 @@ namespace mtconnect::printer {
 
 /// @brief MTConnect Device parser namespace
 namespace mtconnect::parser {
+  /// @brief A namespace from a Devices file that is added to the printer
+  struct DevicesNamespace
+  {
+    std::string m_urn;
+    std::string m_location;
+    std::string m_prefix;
+  };
+
   /// @brief parse an xml document and create a list of devices
   class AGENT_LIB_API XmlParser
   {
@@ -47,11 +55,17 @@ namespace mtconnect::parser {
     virtual ~XmlParser();
 
     /// @brief Parses a file and returns a list of devices
+    ///
+    /// The device elements are parsed in parallel when more than one thread is given. The devices
+    /// are returned in document order.
+    ///
     /// @param[in] aPath to the file
     /// @param[in] aPrinter the printer to obtain and set namespaces
+    /// @param[in] threads the number of threads used to parse the devices
     /// @returns a list of device pointers
     std::list<device_model::DevicePtr> parseFile(const std::string &aPath,
-                                                 printer::XmlPrinter *aPrinter);
+                                                 printer::XmlPrinter *aPrinter,
+                                                 size_t threads = 1);
     /// @brief Parses a single device fragment
     /// @param[in] deviceXml device xml of a single device
     /// @param[in] aPrinter the printer to obtain and set namespaces
@@ -70,11 +84,15 @@ namespace mtconnect::parser {
     /// @brief get the schema version
     /// @return the version
     const auto &getSchemaVersion() const { return m_schemaVersion; }
+    /// @brief get the namespaces the last file added to the printer
+    /// @return the namespaces
+    const auto &getDevicesNamespaces() const { return m_devicesNamespaces; }
 
   protected:
     // LibXML XML Doc
     xmlDocPtr m_doc = nullptr;
     std::optional<std::string> m_schemaVersion;
+    std::list<DevicesNamespace> m_devicesNamespaces;
     mutable std::shared_mutex m_mutex;
   };
 }  // namespace mtconnect::parser
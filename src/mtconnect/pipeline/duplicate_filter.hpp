@@ -17,18 +17,43 @@
 
 #pragma once
 
+#include <unordered_map>
+
+#include "mtconnect/buffer/checkpoint.hpp"
 #include "mtconnect/config.hpp"
+#include "mtconnect/device_model/data_item/data_item.hpp"
 #include "transform.hpp"
 
 namespace mtconnect::pipeline {
   /// @brief Filter duplicates
+  ///
+  /// Keeps a shadow of the latest observation for each data item seen by this pipeline. The
+  /// shadow is valid as long as the data item's latest sequence in the buffer matches the
+  /// sequence recorded with the shadow, so duplicates can be discarded without taking the
+  /// buffer lock. When another source has written the data item or the device has been
+  /// reloaded, the shadow is primed again from the buffer.
   class AGENT_LIB_API DuplicateFilter : public Transform
   {
   public:
+    /// @brief the latest observation for a data item as known by this pipeline
+    struct Shadow
+    {
+      observation::ObservationPtr m_observation;
+      DataItemPtr m_dataItem;
+      SequenceNumber_t m_sequence {0};
+    };
+
+    /// @brief pipeline local shadow state
+    struct State : TransformState
+    {
+      std::unordered_map<std::string, Shadow> m_shadows;
+    };
+
     DuplicateFilter(const DuplicateFilter &) = default;
     /// @brief Create a duplicate filter with shared state from the context
     /// @param context the context
-    DuplicateFilter(PipelineContextPtr context) : Transform("DuplicateFilter"), m_context(context)
+    DuplicateFilter(PipelineContextPtr context)
+      : Transform("DuplicateFilter"), m_context(context), m_state(std::make_shared<State>())
     {
       m_guard = TypeGuard<observation::Observation>(RUN);
     }
@@ -40,19 +65,71 @@ namespace mtconnect::pipeline {
     entity::EntityPtr operator()(entity::EntityPtr &&entity) override
     {
       using namespace observation;
+      using namespace buffer;
 
       auto o = std::dynamic_pointer_cast<Observation>(entity);
       if (o->isOrphan())
         return entity::EntityPtr();
 
-      auto o2 = m_context->m_contract->checkDuplicate(o);
+      auto di = o->getDataItem();
+      const auto &id = di->getId();
+
+      ObservationPtr o2;
+      if (auto latest = current(di))
+      {
+        o2 = Checkpoint::checkDuplicate(o, latest);
+      }
+      else
+      {
+        SequenceNumber_t sequence {0};
+        auto primed = m_context->m_contract->getLatest(id, sequence);
+        if (primed)
+        {
+          std::lock_guard<TransformState> guard(*m_state);
+          m_state->m_shadows.insert_or_assign(id, Shadow {primed, di, sequence});
+          o2 = Checkpoint::checkDuplicate(o, primed);
+        }
+        else
+        {
+          o2 = m_context->m_contract->checkDuplicate(o);
+        }
+      }
+
       if (!o2)
         return entity::EntityPtr();
+
+      auto res = next(o2);
+
+      // If the observation was added to the buffer synchronously, values can be
+      // shadowed directly. Conditions and data sets are merged in the buffer, so
+      // prime them again on the next observation.
+      if (auto seq = o2->getSequence(); seq != 0)
+      {
+        std::lock_guard<TransformState> guard(*m_state);
+        if (di->isCondition() || di->isDataSet())
+          m_state->m_shadows.erase(id);
+        else
+          m_state->m_shadows.insert_or_assign(id, Shadow {o2, di, seq});
+      }
+
+      return res;
+    }
+
+  protected:
+    // Get the shadow observation if it is still current with the buffer
+    observation::ObservationPtr current(const DataItemPtr &di)
+    {
+      std::lock_guard<TransformState> guard(*m_state);
+      auto shadow = m_state->m_shadows.find(di->getId());
+      if (shadow != m_state->m_shadows.end() && shadow->second.m_dataItem == di &&
+          shadow->second.m_sequence == di->getLatestSequence())
+        return shadow->second.m_observation;
       else
-        return next(std::move(o2));
+        return nullptr;
     }
 
   protected:
     PipelineContextPtr m_context;
+    std::shared_ptr<State> m_state;
   };
 }  // namespace mtconnect::pipeline
@@ -69,28 +69,54 @@ namespace mtconnect::pipeline {
 
       const auto &data = entity->getValue<std::string>();
       ResponseDocument rd;
-      ResponseDocument::parse(data, rd, m_context, m_defaultDevice, m_uuid);
+      ResponseDocument::Handler handler;
+      handler.m_header = [this](const ResponseDocument &doc) {
+        if (m_feedback.m_instanceId != 0 && m_feedback.m_instanceId != doc.m_instanceId)
+        {
+          m_feedback.m_assetEvents.clear();
+          m_feedback.m_errors.clear();
+
+          LOG(warning) << "MTConnectXmlTransform: instance id changed from "
+                       << m_feedback.m_instanceId << " to " << doc.m_instanceId;
+          throw std::system_error(make_error_code(ErrorCode::INSTANCE_ID_CHANGED));
+        }
+      };
+      // Streams are parsed without a DOM, but the observations are only forwarded once the whole
+      // document has been parsed. A document that fails partway delivers nothing and does not
+      // advance next.
+      EntityList observations;
+      handler.m_entity = [&observations](EntityPtr &&obs) {
+        observations.emplace_back(std::move(obs));
+      };
+
+      // Upstream agents that honor format=json return a JSON document, detect by the first token
+      bool parsed;
+      auto first = data.find_first_not_of(" \t\r\n");
+      if (first != std::string::npos && data[first] == '{')
+        parsed = ResponseDocument::parseJson(data, rd, m_context, handler, m_defaultDevice);
+      else
+        parsed = ResponseDocument::parse(data, rd, m_context, handler, m_defaultDevice, m_uuid);
 
-      if (m_feedback.m_instanceId != 0 && m_feedback.m_instanceId != rd.m_instanceId)
+      m_feedback.m_errors = rd.m_errors;
+      if (rd.m_errors.size() > 0)
       {
-        m_feedback.m_assetEvents.clear();
-        m_feedback.m_errors.clear();
+        throw std::system_error(make_error_code(ErrorCode::RESTART_STREAM));
+      }
 
-        LOG(warning) << "MTConnectXmlTransform: instance id changed from "
-                     << m_feedback.m_instanceId << " to " << rd.m_instanceId;
-        throw std::system_error(make_error_code(ErrorCode::INSTANCE_ID_CHANGED));
+      if (!parsed)
+      {
+        LOG(warning) << "MTConnectXmlTransform: cannot parse the document, discarding "
+                     << observations.size() << " observations";
+        throw std::system_error(make_error_code(ErrorCode::RESTART_STREAM));
       }
 
       m_feedback.m_instanceId = rd.m_instanceId;
       m_feedback.m_agentVersion = rd.m_agentVersion;
       m_feedback.m_next = rd.m_next;
       m_feedback.m_assetEvents = rd.m_assetEvents;
-      m_feedback.m_errors = rd.m_errors;
 
-      if (rd.m_errors.size() > 0)
-      {
-        throw std::system_error(make_error_code(ErrorCode::RESTART_STREAM));
-      }
+      for (auto &obs : observations)
+        next(std::move(obs));
 
       if (rd.m_enityType == ResponseDocument::DEVICE)
       {
@@ -116,6 +116,15 @@ namespace mtconnect {
       /// @returns `obs` if it is not a duplicate, `nullptr` if it is. The observation
       /// may be modified if the observation needs to be subset.
       virtual const ObservationPtr checkDuplicate(const ObservationPtr &obs) const = 0;
+      /// @brief Get the latest observation for a data item to prime pipeline local state
+      /// @param[in] id the data item id
+      /// @param[out] sequence the sequence number of the last observation added for the data
+      /// item, compare with `DataItem::getLatestSequence()` to check if the state is current
+      /// @returns the latest observation or `nullptr` if there is none or it is not available
+      virtual ObservationPtr getLatest(const std::string &id, uint64_t &sequence) const
+      {
+        return nullptr;
+      }
     };
   }  // namespace pipeline
 }  // namespace mtconnect
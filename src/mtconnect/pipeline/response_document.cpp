@@ -17,11 +17,17 @@
 
 #include "response_document.hpp"
 
+#include <cstring>
 #include <date/date.h>
 
 #include <libxml/parser.h>
+#include <libxml/xmlreader.h>
 #include <libxml/xpath.h>
 #include <libxml/xpathInternals.h>
+#include <rapidjson/encodedstream.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
 
 #include "mtconnect/asset/asset.hpp"
 #include "mtconnect/device_model/device.hpp"
@@ -114,20 +120,24 @@ namespace mtconnect::pipeline {
     return child;
   }
 
+  static inline void readHeader(ResponseDocument &out, xmlNodePtr header, bool streams)
+  {
+    out.m_instanceId = boost::lexical_cast<SequenceNumber_t>(attributeValue(header, "instanceId"));
+
+    if (streams)
+    {
+      auto next = attributeValue(header, "nextSequence", false);
+      if (!next.empty())
+        out.m_next = boost::lexical_cast<SequenceNumber_t>(next);
+    }
+  }
+
   static inline bool parseHeader(ResponseDocument &out, xmlNodePtr root)
   {
     auto header = findChild(root, "Header");
     if (header)
     {
-      out.m_instanceId =
-          boost::lexical_cast<SequenceNumber_t>(attributeValue(header, "instanceId"));
-
-      if (xmlStrcmp(root->name, BAD_CAST "MTConnectStreams") == 0)
-      {
-        auto next = attributeValue(header, "nextSequence", false);
-        if (!next.empty())
-          out.m_next = boost::lexical_cast<SequenceNumber_t>(next);
-      }
+      readHeader(out, header, xmlStrcmp(root->name, BAD_CAST "MTConnectStreams") == 0);
       return true;
     }
 
@@ -317,6 +327,112 @@ namespace mtconnect::pipeline {
     return di;
   }
 
+  /// @brief Create an observation once its properties have been collected
+  /// @param[in,out] out the response document, asset events are added directly
+  /// @param[in] di the data item for the observation
+  /// @param[in] device the device of the enclosing device stream
+  /// @param[in] properties the properties including the `VALUE`
+  /// @return the observation or asset command, `nullptr` if it was skipped or is an asset event
+  inline static EntityPtr makeObservation(ResponseDocument &out, DataItemPtr di, DevicePtr device,
+                                          Properties &properties)
+  {
+    // Remove old properties
+    properties.erase("name");
+    properties.erase("dataItemId");
+
+    if (di->isAssetRemoved())
+    {
+      auto v = properties.find("VALUE");
+      if (v != properties.end() && holds_alternative<string>(v->second) &&
+          get<string>(v->second) != "UNAVAILABLE")
+      {
+        return make_shared<pipeline::AssetCommand>(
+            "AssetCommand", Properties {{"assetId"s, get<string>(v->second)},
+                                        {"device"s, *(device->getUuid())},
+                                        {"VALUE"s, "RemoveAsset"s}});
+      }
+    }
+
+    auto ts = properties["timestamp"];
+    auto timestamp = parseTimestamp(get<string>(ts));
+
+    ErrorList errors;
+    auto obs = observation::Observation::make(di, properties, timestamp, errors);
+    if (!errors.empty())
+    {
+      for (auto &e : errors)
+      {
+        LOG(warning) << "Error while parsing observation: " << e->what();
+      }
+      return nullptr;
+    }
+
+    if (di->isAssetChanged() || di->isAssetAdded())
+    {
+      out.m_assetEvents.emplace_back((obs));
+      return nullptr;
+    }
+
+    return obs;
+  }
+
+  /// @brief Create an observation from an observation element
+  /// @param[in,out] out the response document, asset events are added directly
+  /// @param[in] o the observation element
+  /// @param[in] device the device of the enclosing device stream
+  /// @return the observation or asset command, `nullptr` if it was skipped or is an asset event
+  inline static EntityPtr parseObservation(ResponseDocument &out, xmlNodePtr o, DevicePtr device)
+  {
+    Properties properties;
+
+    eachAttribute(o, [&properties](xmlAttrPtr attr) {
+      if (xmlStrcmp(BAD_CAST "sequence", attr->name) != 0)
+      {
+        string s((const char *)attr->children->content);
+        properties.insert({(const char *)attr->name, s});
+      }
+
+      return true;
+    });
+
+    // Check for table or data set
+    string name((const char *)o->name);
+    auto di = findDataItem(name, device, properties);
+    if (!di)
+    {
+      return nullptr;
+    }
+
+    auto val = text(o);
+    if (val == "UNAVAILABLE" || !di->isDataSet())
+    {
+      properties.insert({"VALUE", val});
+    }
+    else  // isDataSet
+    {
+      Value &v = properties["VALUE"];
+      v.emplace<DataSet>();
+      DataSet &ds = get<DataSet>(v);
+      dataSet(o, di->isTable(), ds);
+    }
+
+    return makeObservation(out, di, device, properties);
+  }
+
+  inline static DevicePtr findStreamDevice(PipelineContract *contract,
+                                           const std::optional<std::string> &deviceName,
+                                           const std::string &uuid)
+  {
+    const auto &key = deviceName ? *deviceName : uuid;
+    auto device = contract->findDevice(key);
+    if (!device)
+    {
+      LOG(warning) << "Parsing XML document: cannot find device by uuid: " << key
+                   << ", skipping device";
+    }
+    return device;
+  }
+
   inline static bool parseObservations(ResponseDocument &out, xmlNodePtr node,
                                        pipeline::PipelineContextPtr context,
                                        const std::optional<std::string> &deviceName)
@@ -328,95 +444,15 @@ namespace mtconnect::pipeline {
     auto contract = context->m_contract.get();
 
     eachElement(streams, "DeviceStream", [&out, &contract, &deviceName](xmlNodePtr dev) {
-      DevicePtr device;
-      if (deviceName)
-      {
-        device = contract->findDevice(*deviceName);
-        if (!device)
-        {
-          LOG(warning) << "Parsing XML document: cannot find device by uuid: " << *deviceName
-                       << ", skipping device";
-          return true;
-        }
-      }
-      else
-      {
-        auto uuid = attributeValue(dev, "uuid");
-        device = contract->findDevice(uuid);
-        if (!device)
-        {
-          LOG(warning) << "Parsing XML document: cannot find device by uuid: " << uuid
-                       << ", skipping device";
-          return true;
-        }
-      }
+      DevicePtr device = findStreamDevice(
+          contract, deviceName, deviceName ? string() : attributeValue(dev, "uuid"));
+      if (!device)
+        return true;
 
       eachElement(dev, "ComponentStream", [&out, &device](xmlNodePtr comp) {
         eachElement(comp, [&out, &device](xmlNodePtr org) {
           eachElement(org, [&out, &device](xmlNodePtr o) {
-            Properties properties;
-
-            eachAttribute(o, [&properties](xmlAttrPtr attr) {
-              if (xmlStrcmp(BAD_CAST "sequence", attr->name) != 0)
-              {
-                string s((const char *)attr->children->content);
-                properties.insert({(const char *)attr->name, s});
-              }
-
-              return true;
-            });
-
-            // Check for table or data set
-            string name((const char *)o->name);
-            auto di = findDataItem(name, device, properties);
-            if (!di)
-            {
-              return true;
-            }
-
-            // Remove old properties
-            properties.erase("name");
-            properties.erase("dataItemId");
-
-            auto ts = properties["timestamp"];
-            auto timestamp = parseTimestamp(get<string>(ts));
-
-            auto val = text(o);
-            if (val == "UNAVAILABLE" || (!di->isDataSet() && !di->isAssetRemoved()))
-            {
-              properties.insert({"VALUE", val});
-            }
-            else if (di->isAssetRemoved())
-            {
-              auto ac = make_shared<pipeline::AssetCommand>(
-                  "AssetCommand", Properties {{"assetId"s, val},
-                                              {"device"s, *(device->getUuid())},
-                                              {"VALUE"s, "RemoveAsset"s}});
-              out.m_entities.emplace_back(ac);
-              return true;
-            }
-            else  // isDataSet
-            {
-              Value &v = properties["VALUE"];
-              v.emplace<DataSet>();
-              DataSet &ds = get<DataSet>(v);
-              dataSet(o, di->isTable(), ds);
-            }
-
-            ErrorList errors;
-            auto obs = observation::Observation::make(di, properties, timestamp, errors);
-            if (!errors.empty())
-            {
-              for (auto &e : errors)
-              {
-                LOG(warning) << "Error while parsing XML: " << e->what();
-              }
-              return true;
-            }
-
-            if (di->isAssetChanged() || di->isAssetAdded())
-              out.m_assetEvents.emplace_back((obs));
-            else
+            if (auto obs = parseObservation(out, o, device))
               out.m_entities.emplace_back(obs);
             return true;
           });
@@ -541,4 +577,537 @@ namespace mtconnect::pipeline {
       return false;
     }
   }
+
+  /// @brief Depth of elements in an `MTConnectStreams` document
+  enum StreamDepth
+  {
+    ROOT_DEPTH = 0,
+    STREAMS_DEPTH = 1,
+    DEVICE_STREAM_DEPTH = 2,
+    COMPONENT_STREAM_DEPTH = 3,
+    ORGANIZER_DEPTH = 4,
+    OBSERVATION_DEPTH = 5
+  };
+
+  inline static string readerAttribute(xmlTextReaderPtr reader, const char *name)
+  {
+    string res;
+    if (auto value = xmlTextReaderGetAttribute(reader, BAD_CAST name))
+    {
+      res = (const char *)value;
+      xmlFree(value);
+    }
+    return res;
+  }
+
+  bool ResponseDocument::parse(const std::string_view &content, ResponseDocument &out,
+                               pipeline::PipelineContextPtr context, const Handler &handler,
+                               const std::optional<std::string> &device,
+                               const std::optional<std::string> &uuid)
+  {
+    unique_ptr<xmlTextReader, function<void(xmlTextReaderPtr)>> reader(
+        xmlReaderForMemory(content.data(), static_cast<int>(content.length()), "incoming.xml",
+                           nullptr, XML_PARSE_NOBLANKS),
+        [](xmlTextReaderPtr r) { xmlFreeTextReader(r); });
+    if (!reader)
+      return false;
+
+    auto contract = context->m_contract.get();
+    bool header = false;
+    DevicePtr streamDevice;
+
+    int ret = xmlTextReaderRead(reader.get());
+    while (ret == 1)
+    {
+      if (xmlTextReaderNodeType(reader.get()) != XML_READER_TYPE_ELEMENT)
+      {
+        ret = xmlTextReaderRead(reader.get());
+        continue;
+      }
+
+      auto name = (const char *)xmlTextReaderConstLocalName(reader.get());
+      bool descend = false;
+      switch (xmlTextReaderDepth(reader.get()))
+      {
+        case ROOT_DEPTH:
+          if (strcmp(name, "MTConnectStreams") != 0)
+          {
+            // Only streams are large enough to warrant incremental parsing
+            reader.reset();
+            auto res = parse(content, out, context, device, uuid);
+            if (handler.m_header)
+              handler.m_header(out);
+            return res;
+          }
+          out.m_enityType = OBSERVATION;
+          descend = true;
+          break;
+
+        case STREAMS_DEPTH:
+          if (strcmp(name, "Header") == 0)
+          {
+            readHeader(out, xmlTextReaderExpand(reader.get()), true);
+            header = true;
+            if (handler.m_header)
+              handler.m_header(out);
+          }
+          else if (strcmp(name, "Streams") == 0)
+          {
+            if (!header)
+            {
+              LOG(error) << "Cannot find next in header for streams doc";
+              return false;
+            }
+            descend = true;
+          }
+          break;
+
+        case DEVICE_STREAM_DEPTH:
+          if (strcmp(name, "DeviceStream") == 0)
+          {
+            streamDevice = findStreamDevice(
+                contract, device, device ? string() : readerAttribute(reader.get(), "uuid"));
+            descend = bool(streamDevice);
+          }
+          break;
+
+        case COMPONENT_STREAM_DEPTH:
+          descend = strcmp(name, "ComponentStream") == 0;
+          break;
+
+        case ORGANIZER_DEPTH:
+          descend = true;
+          break;
+
+        case OBSERVATION_DEPTH:
+          // Only the observation element is expanded, the reader frees it when it moves on
+          if (auto node = xmlTextReaderExpand(reader.get()))
+          {
+            if (auto obs = parseObservation(out, node, streamDevice))
+              handler.m_entity(std::move(obs));
+          }
+          break;
+      }
+
+      if (descend)
+        ret = xmlTextReaderRead(reader.get());
+      else
+        ret = xmlTextReaderNext(reader.get());
+    }
+
+    if (ret < 0)
+    {
+      LOG(error) << "Error parsing MTConnectStreams document";
+      return false;
+    }
+
+    return header;
+  }
+
+  namespace rj = ::rapidjson;
+
+  /// @brief SAX handler for JSON version 2 `MTConnectStreams` and `MTConnectError` documents
+  ///
+  /// Tracks the position in the document with a stack of states. Observations are created and
+  /// passed to the handler as soon as their object is complete.
+  struct JsonResponseHandler : rj::BaseReaderHandler<rj::UTF8<>, JsonResponseHandler>
+  {
+    enum State
+    {
+      ROOT,
+      TOP,
+      DOCUMENT,
+      HEADER,
+      STREAMS,
+      DEVICE_STREAMS,
+      DEVICE_STREAM,
+      COMPONENT_STREAMS,
+      COMPONENT_STREAM,
+      CATEGORY,
+      OBSERVATIONS,
+      OBSERVATION,
+      VECTOR,
+      DATA_SET,
+      ROW,
+      CELL,
+      ERRORS,
+      ERROR_LIST,
+      ERROR_ENTRY,
+      SKIP
+    };
+
+    JsonResponseHandler(ResponseDocument &out, PipelineContract *contract,
+                        const ResponseDocument::Handler &handler,
+                        const std::optional<std::string> &device)
+      : m_out(out), m_contract(contract), m_handler(handler), m_deviceName(device)
+    {
+      m_states.push_back(ROOT);
+    }
+
+    bool Null() { return scalar(std::monostate()); }
+    bool Bool(bool b) { return scalar(b); }
+    bool Int(int i) { return scalar(int64_t(i)); }
+    bool Uint(unsigned i) { return scalar(int64_t(i)); }
+    bool Int64(int64_t i) { return scalar(i); }
+    bool Uint64(uint64_t i)
+    {
+      if (m_states.back() == HEADER)
+        return header(i);
+      return scalar(int64_t(i));
+    }
+    bool Double(double d) { return scalar(d); }
+    bool String(const Ch *str, rj::SizeType length, bool copy)
+    {
+      return scalar(std::string(str, length));
+    }
+    bool Key(const Ch *str, rj::SizeType length, bool copy)
+    {
+      m_key.assign(str, length);
+      return true;
+    }
+
+    bool StartObject()
+    {
+      State next = SKIP;
+      switch (m_states.back())
+      {
+        case ROOT:
+          next = TOP;
+          break;
+
+        case TOP:
+          if (m_key == "MTConnectStreams")
+            m_out.m_enityType = ResponseDocument::OBSERVATION;
+          else if (m_key == "MTConnectError")
+            m_out.m_enityType = ResponseDocument::ERRORS;
+          else
+          {
+            LOG(error) << "Unsupported JSON document type: " << m_key;
+            return false;
+          }
+          next = DOCUMENT;
+          break;
+
+        case DOCUMENT:
+          if (m_key == "Header")
+            next = HEADER;
+          else if (m_key == "Errors")
+            next = ERRORS;
+          else if (m_key == "Streams")
+          {
+            if (!m_header)
+            {
+              LOG(error) << "Cannot find next in header for streams doc";
+              return false;
+            }
+            next = STREAMS;
+          }
+          break;
+
+        case DEVICE_STREAMS:
+          m_uuid.clear();
+          m_device.reset();
+          next = DEVICE_STREAM;
+          break;
+
+        case COMPONENT_STREAMS:
+          next = COMPONENT_STREAM;
+          break;
+
+        case COMPONENT_STREAM:
+          next = CATEGORY;
+          break;
+
+        case OBSERVATIONS:
+          m_properties.clear();
+          next = OBSERVATION;
+          break;
+
+        case OBSERVATION:
+          if (m_key == "value")
+          {
+            m_dataSet.clear();
+            next = DATA_SET;
+          }
+          break;
+
+        case DATA_SET:
+          m_rowKey = m_key;
+          m_row.clear();
+          m_removed = false;
+          next = ROW;
+          break;
+
+        case ROW:
+          m_cellKey = m_key;
+          m_removed = false;
+          next = CELL;
+          break;
+
+        case ERROR_LIST:
+          m_code.clear();
+          m_message.clear();
+          next = ERROR_ENTRY;
+          break;
+
+        default:
+          break;
+      }
+
+      m_states.push_back(next);
+      return true;
+    }
+
+    bool EndObject(rj::SizeType memberCount)
+    {
+      auto state = m_states.back();
+      m_states.pop_back();
+
+      switch (state)
+      {
+        case HEADER:
+          m_header = true;
+          if (m_handler.m_header)
+            m_handler.m_header(m_out);
+          break;
+
+        case OBSERVATION:
+          if (auto di = findDataItem(m_name, m_device, m_properties))
+          {
+            if (auto obs = makeObservation(m_out, di, m_device, m_properties))
+              m_handler.m_entity(std::move(obs));
+          }
+          break;
+
+        case DATA_SET:
+          m_properties.insert_or_assign("VALUE", std::move(m_dataSet));
+          m_dataSet.clear();
+          break;
+
+        case ROW:
+          // Removed entries are represented as {"removed": true}
+          if (m_removed)
+            m_dataSet.emplace(m_rowKey, DataSetValue(), true);
+          else if (m_row.empty())
+            m_dataSet.emplace(m_rowKey, DataSetValue());
+          else
+            m_dataSet.emplace(m_rowKey, DataSetValue(std::move(m_row)));
+          m_removed = false;
+          break;
+
+        case CELL:
+          if (m_removed)
+            m_row.emplace(m_cellKey, TableCellValue(), true);
+          m_removed = false;
+          break;
+
+        case ERROR_ENTRY:
+          m_out.m_errors.emplace_back(ResponseDocument::Error {m_code, m_message});
+          LOG(error) << "Received protocol error: " << m_code << " " << m_message;
+          break;
+
+        default:
+          break;
+      }
+
+      return true;
+    }
+
+    bool StartArray()
+    {
+      State next = SKIP;
+      switch (m_states.back())
+      {
+        case STREAMS:
+          if (m_key == "DeviceStream")
+            next = DEVICE_STREAMS;
+          break;
+
+        case DEVICE_STREAM:
+          if (m_key == "ComponentStream")
+          {
+            m_device = findStreamDevice(m_contract, m_deviceName, m_uuid);
+            if (m_device)
+              next = COMPONENT_STREAMS;
+          }
+          break;
+
+        case CATEGORY:
+          m_name = m_key;
+          next = OBSERVATIONS;
+          break;
+
+        case OBSERVATION:
+          if (m_key == "value")
+          {
+            m_vector.clear();
+            next = VECTOR;
+          }
+          break;
+
+        case ERRORS:
+          next = ERROR_LIST;
+          break;
+
+        default:
+          break;
+      }
+
+      m_states.push_back(next);
+      return true;
+    }
+
+    bool EndArray(rj::SizeType elementCount)
+    {
+      auto state = m_states.back();
+      m_states.pop_back();
+
+      if (state == VECTOR)
+      {
+        m_properties.insert_or_assign("VALUE", std::move(m_vector));
+        m_vector.clear();
+      }
+
+      return true;
+    }
+
+  protected:
+    bool header(uint64_t value)
+    {
+      if (m_key == "instanceId")
+        m_out.m_instanceId = value;
+      else if (m_key == "nextSequence")
+        m_out.m_next = value;
+      return true;
+    }
+
+    bool scalar(entity::Value &&value)
+    {
+      switch (m_states.back())
+      {
+        case DOCUMENT:
+          if (m_key == "jsonVersion" && holds_alternative<int64_t>(value) &&
+              get<int64_t>(value) != 2)
+          {
+            LOG(error) << "Only JSON version 2 documents are supported, received version "
+                       << get<int64_t>(value);
+            return false;
+          }
+          break;
+
+        case HEADER:
+          if (holds_alternative<int64_t>(value))
+            return header(uint64_t(get<int64_t>(value)));
+          else if (holds_alternative<string>(value) &&
+                   (m_key == "instanceId" || m_key == "nextSequence"))
+            return header(boost::lexical_cast<uint64_t>(get<string>(value)));
+          break;
+
+        case DEVICE_STREAM:
+          if (m_key == "uuid" && holds_alternative<string>(value))
+            m_uuid = get<string>(value);
+          break;
+
+        case OBSERVATION:
+          if (m_key == "value")
+            m_properties.insert_or_assign("VALUE", std::move(value));
+          else if (m_key != "sequence")
+            m_properties.insert_or_assign(m_key, std::move(value));
+          break;
+
+        case VECTOR:
+          if (holds_alternative<double>(value))
+            m_vector.push_back(get<double>(value));
+          else if (holds_alternative<int64_t>(value))
+            m_vector.push_back(double(get<int64_t>(value)));
+          break;
+
+        case DATA_SET:
+          m_dataSet.emplace(m_key, dataSetValue<DataSetValue>(std::move(value)));
+          break;
+
+        case ROW:
+          if (m_key == "removed" && holds_alternative<bool>(value))
+            m_removed = get<bool>(value);
+          else
+            m_row.emplace(m_key, dataSetValue<TableCellValue>(std::move(value)));
+          break;
+
+        case CELL:
+          m_removed = m_key == "removed" && holds_alternative<bool>(value) && get<bool>(value);
+          break;
+
+        case ERROR_ENTRY:
+          if (m_key == "errorCode" && holds_alternative<string>(value))
+            m_code = get<string>(value);
+          else if ((m_key == "value" || m_key == "ErrorMessage") &&
+                   holds_alternative<string>(value))
+            m_message = get<string>(value);
+          break;
+
+        default:
+          break;
+      }
+
+      return true;
+    }
+
+    template <typename VT>
+    VT dataSetValue(entity::Value &&value)
+    {
+      if (holds_alternative<string>(value))
+        return std::move(get<string>(value));
+      else if (holds_alternative<int64_t>(value))
+        return get<int64_t>(value);
+      else if (holds_alternative<double>(value))
+        return get<double>(value);
+      else
+        return std::monostate();
+    }
+
+  protected:
+    ResponseDocument &m_out;
+    PipelineContract *m_contract;
+    const ResponseDocument::Handler &m_handler;
+    const std::optional<std::string> &m_deviceName;
+
+    std::vector<State> m_states;
+    std::string m_key;
+    bool m_header = false;
+
+    std::string m_uuid;
+    DevicePtr m_device;
+
+    std::string m_name;
+    Properties m_properties;
+    entity::Vector m_vector;
+    DataSet m_dataSet;
+    std::string m_rowKey;
+    TableRow m_row;
+    std::string m_cellKey;
+    bool m_removed = false;
+
+    std::string m_code;
+    std::string m_message;
+  };
+
+  bool ResponseDocument::parseJson(const std::string_view &content, ResponseDocument &out,
+                                   pipeline::PipelineContextPtr context, const Handler &handler,
+                                   const std::optional<std::string> &device)
+  {
+    JsonResponseHandler json(out, context->m_contract.get(), handler, device);
+
+    rj::Reader reader;
+    rj::MemoryStream ms(content.data(), content.size());
+    rj::EncodedInputStream<rj::UTF8<>, rj::MemoryStream> is(ms);
+    auto res = reader.Parse(is, json);
+    if (res.IsError())
+    {
+      LOG(error) << "Error parsing JSON response document: " << rj::GetParseError_En(res.Code())
+                 << " at offset " << res.Offset();
+      return false;
+    }
+
+    return true;
+  }
 }  // namespace mtconnect::pipeline
@@ -46,6 +46,15 @@ namespace mtconnect::pipeline {
     };
     using Errors = std::list<Error>;
 
+    /// @brief Callbacks for incrementally parsing a response document
+    struct Handler
+    {
+      /// @brief called once the header has been parsed and before any entities are delivered
+      std::function<void(const ResponseDocument &)> m_header;
+      /// @brief called for each observation as soon as its element is complete
+      std::function<void(entity::EntityPtr &&)> m_entity;
+    };
+
     /// @brief parse the content of the XML document
     /// @param[in] content XML document
     /// @param[out] doc the created response document
@@ -57,9 +66,42 @@ namespace mtconnect::pipeline {
                       const std::optional<std::string> &device = std::nullopt,
                       const std::optional<std::string> &uuid = std::nullopt);
 
+    /// @brief parse the content of the XML document incrementally
+    ///
+    /// `MTConnectStreams` documents are parsed with a pull parser and each observation is passed
+    /// to the handler as soon as its element has been read, without building a DOM for the whole
+    /// document. Observations are not added to `m_entities`. All other documents are parsed with
+    /// the DOM parser as above.
+    ///
+    /// @param[in] content XML document
+    /// @param[out] doc the created response document
+    /// @param[in] context pipeline context
+    /// @param[in] handler callbacks for the header and observations
+    /// @param[in] device optional device uuid
+    /// @return `true` if successful
+    static bool parse(const std::string_view &content, ResponseDocument &doc,
+                      pipeline::PipelineContextPtr context, const Handler &handler,
+                      const std::optional<std::string> &device = std::nullopt,
+                      const std::optional<std::string> &uuid = std::nullopt);
+
+    /// @brief parse a JSON version 2 `MTConnectStreams` or `MTConnectError` document
+    ///
+    /// The document is read with a SAX parser and each observation is passed to the handler
+    /// as soon as its object is complete.
+    ///
+    /// @param[in] content JSON document
+    /// @param[out] doc the created response document
+    /// @param[in] context pipeline context
+    /// @param[in] handler callbacks for the header and observations
+    /// @param[in] device optional device uuid
+    /// @return `true` if successful
+    static bool parseJson(const std::string_view &content, ResponseDocument &doc,
+                          pipeline::PipelineContextPtr context, const Handler &handler,
+                          const std::optional<std::string> &device = std::nullopt);
+
     // Parsed data
-    SequenceNumber_t m_next;           ///< Next sequence number
-    uint64_t m_instanceId;             ///< Agent instance id
+    SequenceNumber_t m_next = 0;       ///< Next sequence number
+    uint64_t m_instanceId = 0;         ///< Agent instance id
     int32_t m_agentVersion = 0;        ///< Agent version
     entity::EntityList m_entities;     ///< List of entities
     entity::EntityList m_assetEvents;  ///< List of asset events
@@ -139,8 +139,9 @@ namespace mtconnect {
                                         const TokenList::const_iterator &end, ErrorList &errors,
                                         int32_t schemaVersion, bool validation)
     {
-      NAMED_SCOPE("zipProperties");
+      HOT_NAMED_SCOPE("zipProperties");
       Properties props;
+      size_t capacity = 0;
       for (auto req = reqs.begin(); token != end && req != reqs.end(); token++, req++)
       {
         const string &tok = *token;
@@ -161,8 +162,15 @@ namespace mtconnect {
 
         try
         {
-          req->convertType(value, dataItem->isTable());
-          props.insert_or_assign(req->getName(), value);
+          req->convertType(value, dataItem->isTable(), capacity);
+
+          // The time series sample count precedes the values, use it to size the vector
+          if (req->getName() == "sampleCount")
+          {
+            if (auto count = get_if<int64_t>(&value); count && *count > 0)
+              capacity = size_t(*count);
+          }
+          props.insert_or_assign(req->getName(), std::move(value));
         }
         catch (entity::PropertyError &e)
         {
@@ -209,7 +217,7 @@ namespace mtconnect {
                                                    const TokenList::const_iterator &end,
                                                    ErrorList &errors)
     {
-      NAMED_SCOPE("DataItemMapper.ShdrTokenMapper.mapTokensToDataItem");
+      HOT_NAMED_SCOPE("DataItemMapper.ShdrTokenMapper.mapTokensToDataItem");
       auto key = *token++;
       DataItemPtr dataItem;
       auto dataItemIt = m_dataItemMap.find(key);
@@ -223,7 +231,7 @@ namespace mtconnect {
         {
           // resync to next item
           if (m_logOnce.count(dataItemKey.first) > 0)
-            LOG(trace) << "Could not find data item: " << dataItemKey.first;
+            LOG_SAMPLED(trace) << "Could not find data item: " << dataItemKey.first;
           else
           {
             LOG(info) << "Could not find data item: " << dataItemKey.first;
@@ -371,7 +379,7 @@ namespace mtconnect {
 
     EntityPtr ShdrTokenMapper::operator()(EntityPtr &&entity)
     {
-      NAMED_SCOPE("DataItemMapper.ShdrTokenMapper.operator");
+      HOT_NAMED_SCOPE("DataItemMapper.ShdrTokenMapper.operator");
       if (auto timestamped = std::dynamic_pointer_cast<Timestamped>(entity))
       {
         // Don't copy the tokens.
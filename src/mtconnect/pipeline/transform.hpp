@@ -23,6 +23,7 @@
 #include "guard.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/entity/entity.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "pipeline_context.hpp"
 
 namespace mtconnect {
@@ -54,7 +55,12 @@ namespace mtconnect {
       Transform(const Transform &) = default;
       /// @brief Construct a transform with a name
       /// @param[in] name transform name
-      Transform(const std::string &name) : m_name(name) {}
+      Transform(const std::string &name) : m_name(name)
+      {
+        if (metrics::Registry::isEnabled())
+          m_latency = &metrics::Registry::instance().histogram(
+              "mtconnect_transform_latency_seconds", {{"transform", name}});
+      }
       virtual ~Transform() = default;
 
       /// @brief Get the transform name
@@ -113,7 +119,11 @@ namespace mtconnect {
           switch (t->check(entity.get()))
           {
             case RUN:
+            {
+              // Time only this transform, not the transforms it calls
+              metrics::ExclusiveTimer timer(t->m_latency);
               return (*t)(std::move(entity));
+            }
 
             case SKIP:
               return t->next(std::move(entity));
@@ -264,6 +274,7 @@ namespace mtconnect {
       std::string m_name;
       TransformList m_next;
       Guard m_guard;
+      metrics::Histogram *m_latency {nullptr};
     };
 
     /// @brief A transform that just returns the entity. It does not call next.
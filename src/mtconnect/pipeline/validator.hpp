@@ -50,6 +50,7 @@ namespace mtconnect::pipeline {
       using namespace observation;
       using namespace mtconnect::validation::observations;
       auto obs = std::dynamic_pointer_cast<Observation>(entity);
+      // Only valid until a property is added to the observation
       auto &value = obs->getValue();
 
       bool valid = true;
@@ -58,11 +59,10 @@ namespace mtconnect::pipeline {
       {
         if (auto evt = std::dynamic_pointer_cast<observation::Event>(obs))
         {
-          auto vocab = ControlledVocabularies.find(evt->getName());
-          if (vocab != ControlledVocabularies.end())
+          if (auto vocab = di->getControlledVocabulary())
           {
             auto sv = std::get_if<std::string>(&value);
-            auto &lits = vocab->second;
+            auto &lits = *vocab;
             if (lits.size() != 0 && sv != nullptr)
             {
               auto lit = lits.find(*sv);
@@ -103,19 +103,20 @@ namespace mtconnect::pipeline {
 
       if (!valid)
       {
-        obs->setProperty("quality", std::string("INVALID"));
-        // Log once
+        // Log once. Setting a property can move the values, so the value is fetched again and
+        // logged before the quality is set.
         auto &id = di->getId();
         if (m_logOnce.count(id) < 1)
         {
           LOG(warning) << "DataItem '" << id << "': Invalid value for '" << obs->getName() << "': '"
-                       << value << '\'';
+                       << obs->getValue() << '\'';
           m_logOnce.insert(id);
         }
         else
         {
           LOG(trace) << "DataItem '" << id << "': Invalid value for '" << obs->getName();
         }
+        obs->setProperty("quality", std::string("INVALID"));
       }
       else if (!obs->hasProperty("quality"))
       {
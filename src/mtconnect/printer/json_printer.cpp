@@ -37,6 +37,7 @@
 #include "mtconnect/device_model/reference.hpp"
 #include "mtconnect/entity/json_printer.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/printer/json_printer_helper.hpp"
 #include "mtconnect/sink/rest_sink/error.hpp"
 #include "mtconnect/version.h"
@@ -48,6 +49,26 @@ namespace mtconnect::printer {
   using namespace device_model;
   using namespace rapidjson;
 
+  // Document types of the render time histograms
+  static constexpr char ErrorDocument[] = "MTConnectError";
+  static constexpr char DevicesDocument[] = "MTConnectDevices";
+  static constexpr char StreamsDocument[] = "MTConnectStreams";
+  static constexpr char AssetsDocument[] = "MTConnectAssets";
+
+  /// @brief get the render time histogram for a document when metrics are enabled
+  ///
+  /// The histogram is looked up once for each document type instead of locking the registry for
+  /// every document. The registry never removes metrics, so the reference stays valid.
+  template <const char *Document>
+  static metrics::Histogram *renderTime()
+  {
+    if (!metrics::Registry::isEnabled())
+      return nullptr;
+    static auto &histogram = metrics::Registry::instance().histogram(
+        "mtconnect_render_seconds", {{"format", "json"}, {"document", Document}});
+    return &histogram;
+  }
+
   JsonPrinter::JsonPrinter(uint32_t jsonVersion, bool pretty, bool validation)
     : Printer(pretty, validation), m_jsonVersion(jsonVersion)
   {
@@ -122,6 +143,7 @@ namespace mtconnect::printer {
                                        bool pretty,
                                        const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<ErrorDocument>());
     defaultSchemaVersion();
     auto version = IntSchemaVersion(*m_schemaVersion);
 
@@ -168,6 +190,7 @@ namespace mtconnect::printer {
                                       bool includeHidden, bool pretty,
                                       const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<DevicesDocument>());
     defaultSchemaVersion();
 
     StringBuffer output;
@@ -196,6 +219,7 @@ namespace mtconnect::printer {
                                        bool pretty,
                                        const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<AssetsDocument>());
     defaultSchemaVersion();
 
     StringBuffer output;
@@ -397,6 +421,7 @@ namespace mtconnect::printer {
                                        bool pretty,
                                        const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<StreamsDocument>());
     defaultSchemaVersion();
 
     StringBuffer output;
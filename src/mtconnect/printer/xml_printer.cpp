@@ -33,6 +33,7 @@
 #include "mtconnect/device_model/configuration/configuration.hpp"
 #include "mtconnect/device_model/device.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/sink/rest_sink/error.hpp"
 #include "mtconnect/version.h"
 #include "xml_printer.hpp"
@@ -56,6 +57,27 @@ namespace mtconnect::printer {
   using namespace asset;
   using namespace device_model::configuration;
 
+  // Document types of the render time histograms
+  static constexpr char ErrorDocument[] = "MTConnectError";
+  static constexpr char DevicesDocument[] = "MTConnectDevices";
+  static constexpr char DeviceDocument[] = "Device";
+  static constexpr char StreamsDocument[] = "MTConnectStreams";
+  static constexpr char AssetsDocument[] = "MTConnectAssets";
+
+  /// @brief get the render time histogram for a document when metrics are enabled
+  ///
+  /// The histogram is looked up once for each document type instead of locking the registry for
+  /// every document. The registry never removes metrics, so the reference stays valid.
+  template <const char *Document>
+  static metrics::Histogram *renderTime()
+  {
+    if (!metrics::Registry::isEnabled())
+      return nullptr;
+    static auto &histogram = metrics::Registry::instance().histogram(
+        "mtconnect_render_seconds", {{"format", "xml"}, {"document", Document}});
+    return &histogram;
+  }
+
   class AGENT_LIB_API XmlWriter
   {
   public:
@@ -348,6 +370,7 @@ namespace mtconnect::printer {
                                       const uint64_t nextSeq, const entity::EntityList &list,
                                       bool pretty, const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<ErrorDocument>());
     string ret;
 
     try
@@ -396,6 +419,7 @@ namespace mtconnect::printer {
                                 const std::map<std::string, size_t> *count, bool includeHidden,
                                 bool pretty, const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<DevicesDocument>());
     string ret;
 
     try
@@ -430,6 +454,7 @@ namespace mtconnect::printer {
 
   std::string XmlPrinter::printDevice(DevicePtr device, bool pretty)
   {
+    metrics::ScopedTimer timer(renderTime<DeviceDocument>());
     string ret;
 
     try
@@ -457,6 +482,7 @@ namespace mtconnect::printer {
                                  const uint64_t lastSeq, ObservationList &observations, bool pretty,
                                  const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<StreamsDocument>());
     string ret;
 
     try
@@ -538,6 +564,7 @@ namespace mtconnect::printer {
                                  const unsigned int assetCount, const AssetList &asset, bool pretty,
                                  const std::optional<std::string> requestId) const
   {
+    metrics::ScopedTimer timer(renderTime<AssetsDocument>());
     string ret;
     try
     {
@@ -64,11 +64,6 @@ namespace mtconnect::ruby {
   using namespace std::literals;
   using namespace observation;
 
-  RClass *RubyObservation::m_eventClass;
-  RClass *RubyObservation::m_sampleClass;
-  RClass *RubyObservation::m_conditionClass;
-
-  std::recursive_mutex RubyVM::m_mutex;
   RubyVM *RubyVM::m_vm = nullptr;
 
   static mrb_value LoadModule(mrb_state *mrb, mrb_value &filename)
@@ -146,67 +141,84 @@ namespace mtconnect::ruby {
       }
     }
 
-    if (!m_rubyVM)
+    // Each virtual machine loads its own copy of the module for the sources bound to it
+    auto count = size_t(std::max(1, GetOption<int>(m_options, "VirtualMachines").value_or(1)));
+    if (count > 1)
+      LOG(info) << "Starting " << count << " ruby virtual machines";
+
+    for (size_t i = 0; i < count; i++)
     {
-      m_rubyVM = make_unique<RubyVM>();
+      auto vm = make_shared<RubyVM>(i, count);
+      load(*vm, modulePath);
+      m_rubyVMs.emplace_back(vm);
+    }
+  }
 
-      lock_guard guard(*m_rubyVM);
+  void Embedded::load(RubyVM &vm, const std::optional<std::filesystem::path> &modulePath)
+  {
+    using namespace std::filesystem;
 
-      auto mrb = m_rubyVM->state();
+    lock_guard guard(vm);
 
-      RubyAgent::initialize(mrb, m_rubyVM->mtconnect(), m_agent);
-      RubyPipeline::initialize(mrb, m_rubyVM->mtconnect());
-      RubyEntity::initialize(mrb, m_rubyVM->mtconnect());
-      RubyObservation::initialize(mrb, m_rubyVM->mtconnect());
-      RubyTransform::initialize(mrb, m_rubyVM->mtconnect());
+    auto mrb = vm.state();
 
-      if (modulePath)
-      {
-        LOG(info) << "Loading module: " << *modulePath;
+    RubyAgent::initialize(mrb, vm.mtconnect(), m_agent);
+    RubyPipeline::initialize(mrb, vm.mtconnect());
+    RubyEntity::initialize(mrb, vm.mtconnect());
+    RubyObservation::initialize(mrb, vm.mtconnect());
+    RubyTransform::initialize(mrb, vm.mtconnect());
 
-        std::error_code ec;
-        path file = canonical(*modulePath, ec);
-        if (ec)
-        {
-          LOG(error) << "Cannot open file: " << ec.message();
-        }
-        else
+    if (modulePath)
+    {
+      LOG(info) << "Loading module: " << *modulePath;
+
+      std::error_code ec;
+      path file = canonical(*modulePath, ec);
+      if (ec)
+      {
+        LOG(error) << "Cannot open file: " << ec.message();
+      }
+      else
+      {
+        LOG(info) << "Resolved module path: " << file;
+        FILE *fp = nullptr;
+        try
         {
-          LOG(info) << "Resolved module path: " << file;
-          FILE *fp = nullptr;
-          try
+          int save = mrb_gc_arena_save(mrb);
+          mrb_value file = mrb_str_new_cstr(mrb, modulePath->string().c_str());
+          mrb_bool state = false;
+          mrb_value res = mrb_protect(
+              mrb, [](mrb_state *mrb, mrb_value filename) { return LoadModule(mrb, filename); },
+              file, &state);
+          mrb_gc_arena_restore(mrb, save);
+          if (mrb_false_p(res))
           {
-            int save = mrb_gc_arena_save(mrb);
-            mrb_value file = mrb_str_new_cstr(mrb, modulePath->string().c_str());
-            mrb_bool state = false;
-            mrb_value res = mrb_protect(
-                mrb, [](mrb_state *mrb, mrb_value filename) { return LoadModule(mrb, filename); },
-                file, &state);
-            mrb_gc_arena_restore(mrb, save);
-            if (mrb_false_p(res))
-            {
-              LOG(fatal) << "Error loading file " << *modulePath << ": exiting agent";
-              throw FatalException("Fatal error loading module");
-            }
-          }
-          catch (std::exception ex)
-          {
-            LOG(fatal) << "Failed to load module: " << *modulePath << ": " << ex.what();
-            throw FatalException("Fatal error loading module");
-          }
-          catch (...)
-          {
-            LOG(fatal) << "Failed to load module: " << *modulePath;
+            LOG(fatal) << "Error loading file " << *modulePath << ": exiting agent";
             throw FatalException("Fatal error loading module");
           }
-          if (fp != nullptr)
-          {
-            fclose(fp);
-          }
+        }
+        catch (std::exception ex)
+        {
+          LOG(fatal) << "Failed to load module: " << *modulePath << ": " << ex.what();
+          throw FatalException("Fatal error loading module");
+        }
+        catch (...)
+        {
+          LOG(fatal) << "Failed to load module: " << *modulePath;
+          throw FatalException("Fatal error loading module");
+        }
+        if (fp != nullptr)
+        {
+          fclose(fp);
         }
       }
     }
   }
 
-  Embedded::~Embedded() { m_rubyVM.reset(); }
+  Embedded::~Embedded()
+  {
+    // Close the virtual machines in the reverse order they were created
+    while (!m_rubyVMs.empty())
+      m_rubyVMs.pop_back();
+  }
 }  // namespace mtconnect::ruby
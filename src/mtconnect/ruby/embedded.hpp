@@ -19,7 +19,10 @@
 
 #include <boost/asio.hpp>
 
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/utilities.hpp"
@@ -40,11 +43,15 @@ namespace mtconnect {
       Embedded(configuration::AgentConfiguration *config, const ConfigOptions &options);
       ~Embedded();
 
+    protected:
+      /// @brief Initialize the MTConnect module and load the ruby module into a virtual machine
+      void load(RubyVM &vm, const std::optional<std::filesystem::path> &modulePath);
+
     protected:
       Agent *m_agent;
       ConfigOptions m_options;
       boost::asio::io_context *m_context = nullptr;
-      std::unique_ptr<RubyVM> m_rubyVM;
+      std::vector<std::shared_ptr<RubyVM>> m_rubyVMs;
     };
   }  // namespace ruby
 }  // namespace mtconnect
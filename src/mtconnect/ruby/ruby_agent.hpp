@@ -22,6 +22,7 @@
 #include "mtconnect/sink/sink.hpp"
 #include "mtconnect/source/source.hpp"
 #include "ruby_smart_ptr.hpp"
+#include "ruby_vm.hpp"
 
 namespace mtconnect::ruby {
   using namespace mtconnect::device_model;
@@ -80,8 +81,13 @@ namespace mtconnect::ruby {
             auto agent = MRubyPtr<Agent>::unwrap(mrb, self);
             auto sources = mrb_ary_new(mrb);
 
+            // Only the sources bound to this virtual machine
+            auto &vm = RubyVM::of(mrb);
+            size_t index = 0;
             for (auto &source : agent->getSources())
             {
+              if (!vm.isBoundTo(index++))
+                continue;
               auto obj = MRubySharedPtr<source::Source>::wrap(mrb, "Source", source);
               mrb_ary_push(mrb, sources, obj);
             }
@@ -187,7 +193,7 @@ namespace mtconnect::ruby {
   /// @remark Ruby Agent Wrapper
   /// @code
   /// class Agent -> mtconnect::Agent
-  ///   def sources -> mtconnect::Agent::getSources()
+  ///   def sources -> mtconnect::Agent::getSources() bound to this virtual machine
   ///   def sinks -> mtconnect::Agent::getSinks()
   ///   def devices -> mtconnect::Agent::getDevices()
   ///   def default_device -> mtconnect::Agent::getDefaultDevice()
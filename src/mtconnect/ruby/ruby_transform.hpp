@@ -152,21 +152,32 @@ namespace mtconnect::ruby {
 
     RubyTransform(mrb_state *mrb, mrb_value self, const std::string &name, const string &guard)
       : Transform(name),
+        m_vm(RubyVM::of(mrb).weak_from_this()),
         m_self(self),
         m_method(mrb_intern_lit(mrb, "transform")),
         m_block(mrb_nil_value()),
         m_guardString(guard),
         m_guardBlock(mrb_nil_value())
     {
+      // Look up the classes once instead of for every entity
+      auto module = RubyVM::of(mrb).mtconnect();
+      m_entityClass = mrb_class_get_under(mrb, module, "Entity");
+      m_sampleClass = mrb_class_get_under(mrb, module, "Sample");
+      m_eventClass = mrb_class_get_under(mrb, module, "Event");
+      m_conditionClass = mrb_class_get_under(mrb, module, "Condition");
+      m_timestampedClass = mrb_class_get_under(mrb, module, "Timestamped");
+      m_tokensClass = mrb_class_get_under(mrb, module, "Tokens");
+
       setGuard();
     }
 
     ~RubyTransform()
     {
-      std::lock_guard guard(RubyVM::rubyVM());
-      if (RubyVM::hasVM())
+      // The virtual machine is gone if it is closing
+      if (auto vm = m_vm.lock())
       {
-        auto mrb = RubyVM::rubyVM().state();
+        std::lock_guard guard(*vm);
+        auto mrb = vm->state();
 
         mrb_gc_unregister(mrb, m_self);
         m_self = mrb_nil_value();
@@ -188,26 +199,26 @@ namespace mtconnect::ruby {
         m_guard = [this, old = m_guard](const entity::Entity *entity) -> GuardAction {
           using namespace entity;
           using namespace observation;
-          std::lock_guard guard(RubyVM::rubyVM());
+          auto vm = m_vm.lock();
+          if (!vm)
+            return old(entity);
+          std::lock_guard guard(*vm);
 
-          auto mrb = RubyVM::rubyVM().state();
+          auto mrb = vm->state();
           int save = mrb_gc_arena_save(mrb);
 
           entity::EntityPtr ptr = entity->getptr();
-          mrb_value ev = MRubySharedPtr<Entity>::wrap(mrb, "Entity", ptr);
+          CallData call {m_self, m_guardBlock, 0,
+                         MRubySharedPtr<Entity>::wrap(mrb, m_entityClass, ptr)};
 
           mrb_bool state = false;
-          mrb_value values[] = {m_guardBlock, ev};
-          mrb_value data = mrb_ary_new_from_values(mrb, 2, values);
           mrb_value rv = mrb_protect(
               mrb,
               [](mrb_state *mrb, mrb_value data) {
-                mrb_value block = mrb_ary_ref(mrb, data, 0);
-                mrb_value ev = mrb_ary_ref(mrb, data, 1);
-
-                return mrb_yield(mrb, block, ev);
+                auto call = static_cast<CallData *>(mrb_cptr(data));
+                return mrb_yield(mrb, call->m_block, call->m_entity);
               },
-              data, &state);
+              mrb_cptr_value(mrb, &call), &state);
 
           if (state)
           {
@@ -248,8 +259,6 @@ namespace mtconnect::ruby {
         m_guard = GuardCls(RUN);
     }
 
-    using calldata = pair<RubyTransform *, EntityPtr>;
-
     entity::EntityPtr operator()(entity::EntityPtr &&entity) override
     {
       NAMED_SCOPE("RubyTransform::operator()");
@@ -259,14 +268,17 @@ namespace mtconnect::ruby {
 
       EntityPtr res;
 
-      std::lock_guard guard(RubyVM::rubyVM());
-      auto mrb = RubyVM::rubyVM().state();
+      auto vm = m_vm.lock();
+      if (!vm)
+        return res;
+
+      std::lock_guard guard(*vm);
+      auto mrb = vm->state();
       int save = mrb_gc_arena_save(mrb);
 
       try
       {
-        mrb_value ev;
-        const char *klass = "Entity";
+        RClass *klass = m_entityClass;
         Entity *ptr = entity.get();
         Observation *obs;
         if (obs = dynamic_cast<Observation *>(ptr); obs != nullptr)
@@ -274,52 +286,46 @@ namespace mtconnect::ruby {
           switch (obs->getDataItem()->getCategory())
           {
             case device_model::data_item::DataItem::SAMPLE:
-              klass = "Sample";
+              klass = m_sampleClass;
               break;
             case device_model::data_item::DataItem::EVENT:
-              klass = "Event";
+              klass = m_eventClass;
               break;
             case device_model::data_item::DataItem::CONDITION:
-              klass = "Condition";
+              klass = m_conditionClass;
               break;
           }
         }
         else if (dynamic_cast<pipeline::Timestamped *>(ptr) != nullptr)
-          klass = "Timestamped";
+          klass = m_timestampedClass;
         else if (dynamic_cast<pipeline::Tokens *>(ptr) != nullptr)
-          klass = "Tokens";
+          klass = m_tokensClass;
 
-        ev = MRubySharedPtr<Entity>::wrap(mrb, klass, entity);
+        // The call data is passed by pointer so no ruby array is allocated for each call
+        CallData call {m_self, m_block, m_method, MRubySharedPtr<Entity>::wrap(mrb, klass, entity)};
         mrb_value rv;
 
         mrb_bool state = false;
         if (!mrb_nil_p(m_block))
         {
-          mrb_value values[] = {m_self, m_block, ev};
-          mrb_value data = mrb_ary_new_from_values(mrb, 3, values);
           rv = mrb_protect(
               mrb,
               [](mrb_state *mrb, mrb_value data) {
-                mrb_value self = mrb_ary_ref(mrb, data, 0);
-                mrb_value block = mrb_ary_ref(mrb, data, 1);
-                mrb_value ev = mrb_ary_ref(mrb, data, 2);
-                return mrb_yield_with_class(mrb, block, 1, &ev, self, mrb_class(mrb, self));
+                auto call = static_cast<CallData *>(mrb_cptr(data));
+                return mrb_yield_with_class(mrb, call->m_block, 1, &call->m_entity, call->m_self,
+                                            mrb_class(mrb, call->m_self));
               },
-              data, &state);
+              mrb_cptr_value(mrb, &call), &state);
         }
         else
         {
-          mrb_value values[] = {m_self, mrb_symbol_value(m_method), ev};
-          mrb_value data = mrb_ary_new_from_values(mrb, 3, values);
           rv = mrb_protect(
               mrb,
               [](mrb_state *mrb, mrb_value data) {
-                mrb_value self = mrb_ary_ref(mrb, data, 0);
-                mrb_sym method = mrb_symbol(mrb_ary_ref(mrb, data, 1));
-                mrb_value ev = mrb_ary_ref(mrb, data, 2);
-                return mrb_funcall_id(mrb, self, method, 1, ev);
+                auto call = static_cast<CallData *>(mrb_cptr(data));
+                return mrb_funcall_id(mrb, call->m_self, call->m_method, 1, call->m_entity);
               },
-              data, &state);
+              mrb_cptr_value(mrb, &call), &state);
         }
         if (state)
         {
@@ -348,7 +354,23 @@ namespace mtconnect::ruby {
     void setObject(mrb_value obj) { m_self = obj; }
 
   protected:
+    /// @brief The arguments of a protected call into the virtual machine
+    struct CallData
+    {
+      mrb_value m_self;
+      mrb_value m_block;
+      mrb_sym m_method;
+      mrb_value m_entity;
+    };
+
     PipelineContract *m_contract;
+    std::weak_ptr<RubyVM> m_vm;
+    RClass *m_entityClass;
+    RClass *m_sampleClass;
+    RClass *m_eventClass;
+    RClass *m_conditionClass;
+    RClass *m_timestampedClass;
+    RClass *m_tokensClass;
     mrb_value m_self;
     mrb_sym m_method;
     mrb_value m_block;
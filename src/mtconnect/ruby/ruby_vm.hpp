@@ -20,10 +20,18 @@
 #include "mtconnect/config.hpp"
 
 namespace mtconnect::ruby {
-  class AGENT_LIB_API RubyVM
+  /// @brief An mruby instance with the MTConnect module
+  ///
+  /// Each virtual machine has its own lock and its own copy of the loaded modules. The sources are
+  /// distributed between the virtual machines so the transforms of different sources can run at
+  /// the same time.
+  class AGENT_LIB_API RubyVM : public std::enable_shared_from_this<RubyVM>
   {
   public:
-    RubyVM()
+    /// @brief Create a virtual machine
+    /// @param[in] index the index of this virtual machine
+    /// @param[in] count the number of virtual machines the sources are distributed between
+    RubyVM(size_t index = 0, size_t count = 1) : m_index(index), m_count(count)
     {
       m_mrb = mrb_open();
       if (!m_mrb)
@@ -31,16 +39,19 @@ namespace mtconnect::ruby {
         /* handle error */
         throw std::runtime_error("Cannot start mrb");
       }
+      m_mrb->ud = this;
 
       createModule();
       defineLogger();
 
-      m_vm = this;
+      if (m_vm == nullptr)
+        m_vm = this;
     }
 
     ~RubyVM()
     {
-      m_vm = nullptr;
+      if (m_vm == this)
+        m_vm = nullptr;
       std::lock_guard guard(m_mutex);
       if (m_mrb)
       {
@@ -55,8 +66,17 @@ namespace mtconnect::ruby {
     void unlock() { m_mutex.unlock(); }
     [[nodiscard]] bool try_lock() { return m_mutex.try_lock(); }
 
+    /// @brief Check if a source is bound to this virtual machine
+    /// @param[in] source the index of the source in the agent
+    /// @return `true` if the source's transforms run in this virtual machine
+    bool isBoundTo(size_t source) const { return source % m_count == m_index; }
+
+    /// @brief get the first virtual machine
     static auto &rubyVM() { return *m_vm; }
     static bool hasVM() { return m_vm != nullptr; }
+    /// @brief get the virtual machine that owns an mruby state
+    /// @param[in] mrb the mruby state
+    static RubyVM &of(mrb_state *mrb) { return *static_cast<RubyVM *>(mrb->ud); }
 
   protected:
     void createModule() { m_module = mrb_define_module(m_mrb, "MTConnect"); }
@@ -123,7 +143,9 @@ namespace mtconnect::ruby {
     Agent *m_agent;
     RClass *m_module = nullptr;
     mrb_state *m_mrb = nullptr;
-    static std::recursive_mutex m_mutex;
+    size_t m_index;
+    size_t m_count;
+    std::recursive_mutex m_mutex;
     static RubyVM *m_vm;
   };
 }  // namespace mtconnect::ruby
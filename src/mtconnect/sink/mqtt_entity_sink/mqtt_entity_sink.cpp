@@ -17,10 +17,12 @@
 
 #include "mqtt_entity_sink.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
 
-#include <nlohmann/json.hpp>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/entity/entity.hpp"
@@ -28,7 +30,6 @@
 #include "mtconnect/observation/observation.hpp"
 
 using ptree = boost::property_tree::ptree;
-using json = nlohmann::json;
 
 using namespace std;
 using namespace mtconnect;
@@ -42,6 +43,26 @@ namespace mtconnect {
   namespace sink {
     namespace mqtt_entity_sink {
 
+      static MqttClient::QOS parseQos(const ConfigOptions& options)
+      {
+        if (auto qosInt = GetOption<int>(options, configuration::MqttQOS))
+        {
+          return *qosInt == 0   ? MqttClient::QOS::at_most_once
+                 : *qosInt == 2 ? MqttClient::QOS::exactly_once
+                                : MqttClient::QOS::at_least_once;
+        }
+
+        if (auto qosStr = GetOption<std::string>(options, configuration::MqttQOS))
+        {
+          if (*qosStr == "at_most_once" || *qosStr == "0")
+            return MqttClient::QOS::at_most_once;
+          if (*qosStr == "exactly_once" || *qosStr == "2")
+            return MqttClient::QOS::exactly_once;
+        }
+
+        return MqttClient::QOS::at_least_once;
+      }
+
       MqttEntitySink::MqttEntitySink(boost::asio::io_context& context,
                                      sink::SinkContractPtr&& contract, const ConfigOptions& options,
                                      const ptree& config)
@@ -75,26 +96,10 @@ namespace mtconnect {
         m_observationTopicPrefix = get<string>(m_options[configuration::ObservationTopicPrefix]);
         m_deviceTopicPrefix = get<string>(m_options[configuration::DeviceTopicPrefix]);
         m_assetTopicPrefix = get<string>(m_options[configuration::AssetTopicPrefix]);
-      }
 
-      static MqttClient::QOS parseQos(const ConfigOptions& options)
-      {
-        if (auto qosInt = GetOption<int>(options, configuration::MqttQOS))
-        {
-          return *qosInt == 0   ? MqttClient::QOS::at_most_once
-                 : *qosInt == 2 ? MqttClient::QOS::exactly_once
-                                : MqttClient::QOS::at_least_once;
-        }
-
-        if (auto qosStr = GetOption<std::string>(options, configuration::MqttQOS))
-        {
-          if (*qosStr == "at_most_once" || *qosStr == "0")
-            return MqttClient::QOS::at_most_once;
-          if (*qosStr == "exactly_once" || *qosStr == "2")
-            return MqttClient::QOS::exactly_once;
-        }
-
-        return MqttClient::QOS::at_least_once;
+        // Resolve the publishing options once, they are used for every message
+        m_qos = parseQos(m_options);
+        m_retain = GetOption<bool>(m_options, configuration::MqttRetain).value_or(false);
       }
 
       void MqttEntitySink::start()
@@ -106,21 +111,15 @@ namespace mtconnect {
             LOG(debug) << "MqttEntitySink: Client connected to broker";
             client->connectComplete();
 
-            auto agentDevice = m_sinkContract->getDeviceByName("Agent");
-            if (agentDevice)
+            if (m_sinkContract->getDeviceByName("Agent"))
             {
-              auto lwtTopic = get<string>(m_options[configuration::MqttLastWillTopic]);
-              boost::replace_all(lwtTopic, "[device]", *agentDevice->getUuid());
-
-              // Get QoS and Retain from options
-              auto qos = parseQos(m_options);
-              bool retain = GetOption<bool>(m_options, configuration::MqttRetain).value_or(false);
-              LOG(debug) << "Publishing availability to: " << lwtTopic;
-
-              client->publish(lwtTopic, "AVAILABLE", retain, qos);
+              LOG(debug) << "Publishing availability to: " << m_lastWillTopic;
+              client->publish(m_lastWillTopic, "AVAILABLE", m_retain, m_qos);
             }
 
-            // Publish initial content
+            // Send what was missed while disconnected before the current state so the
+            // retained value for each topic is the latest.
+            publishQueuedObservations();
             publishInitialContent();
           };
 
@@ -154,13 +153,43 @@ namespace mtconnect {
           // Publish UNAVAILABLE before disconnecting
           if (m_client->isConnected())
           {
-            auto qos = parseQos(m_options);
-            m_client->publish(m_lastWillTopic, "UNAVAILABLE", true, qos);
+            m_client->publish(m_lastWillTopic, "UNAVAILABLE", true, m_qos);
           }
           m_client->stop();
         }
       }
 
+      void MqttEntitySink::queueObservation(const observation::ObservationPtr& observation)
+      {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (m_queuedObservations.full())
+        {
+          LOG(warning) << "MqttEntitySink::publish: Observation queue full (" << MAX_QUEUE_SIZE
+                       << "), dropping oldest observation";
+        }
+        // The circular buffer overwrites the oldest entry when full
+        m_queuedObservations.push_back(observation);
+      }
+
+      void MqttEntitySink::publishQueuedObservations()
+      {
+        boost::circular_buffer<observation::ObservationPtr> queued(MAX_QUEUE_SIZE);
+        {
+          std::lock_guard<std::mutex> lock(m_queueMutex);
+          queued.swap(m_queuedObservations);
+        }
+
+        if (queued.empty())
+          return;
+
+        LOG(debug) << "MqttEntitySink: Publishing " << queued.size() << " queued observations";
+        for (auto& obs : queued)
+        {
+          // Requeues the observation if the connection drops again
+          publish(obs);
+        }
+      }
+
       void MqttEntitySink::publishInitialContent()
       {
         LOG(debug) << "MqttEntitySink: Publishing initial content";
@@ -178,269 +207,346 @@ namespace mtconnect {
         int obsCount = 0;
         for (auto& dev : m_sinkContract->getDevices())
         {
-          auto& buffer = m_sinkContract->getCircularBuffer();
-          std::lock_guard<buffer::CircularBuffer> lock(buffer);
-
-          auto latest = buffer.getLatest();
           observation::ObservationList observations;
-
-          for (auto& di : dev->getDeviceDataItems())
           {
-            auto dataItem = di.lock();
-            if (dataItem)
+            auto& buffer = m_sinkContract->getCircularBuffer();
+            std::lock_guard<buffer::CircularBuffer> lock(buffer);
+
+            auto& latest = buffer.getLatest();
+            for (auto& di : dev->getDeviceDataItems())
             {
-              auto obs = latest.getObservation(dataItem->getId());
-              if (obs)
+              auto dataItem = di.lock();
+              if (dataItem)
               {
-                observations.push_back(obs);
+                auto obs = latest.getObservation(dataItem->getId());
+                if (obs)
+                {
+                  observations.push_back(obs);
+                }
               }
             }
           }
 
-          // Publish each observation
+          // Publish each observation, queued if the client disconnects
           for (auto& obs : observations)
           {
-            auto obsCopy = obs;
-            if (m_client && m_client->isConnected())
-            {
-              publish(obsCopy);
-              obsCount++;
-            }
-            else
-            {
-              std::lock_guard<std::mutex> lock(m_queueMutex);
-              if (m_queuedObservations.size() >= MAX_QUEUE_SIZE)
-              {
-                m_queuedObservations.erase(m_queuedObservations.begin());
-              }
-              m_queuedObservations.push_back(obsCopy);
-              obsCount++;
-            }
+            publish(obs);
+            obsCount++;
           }
         }
         LOG(debug) << "Published " << obsCount << " initial observations";
       }
 
-      std::string MqttEntitySink::formatTimestamp(const Timestamp& timestamp)
+      size_t MqttEntitySink::formatTimestamp(const Timestamp& timestamp, char* buffer)
       {
-        using namespace date;
-        using namespace std::chrono;
+        using std::chrono::microseconds;
+
+        auto us = date::floor<microseconds>(timestamp);
+        auto day = date::floor<date::days>(us);
+        date::year_month_day ymd {day};
+        date::hh_mm_ss<microseconds> time {us - day};
+
+        auto len = snprintf(buffer, 32, "%04d-%02u-%02uT%02d:%02d:%02d.%06dZ", int(ymd.year()),
+                            unsigned(ymd.month()), unsigned(ymd.day()), int(time.hours().count()),
+                            int(time.minutes().count()), int(time.seconds().count()),
+                            int(time.subseconds().count()));
+        return len > 0 ? size_t(len) : 0;
+      }
 
-        std::ostringstream oss;
-        oss << date::format("%FT%TZ", floor<microseconds>(timestamp));
-        return oss.str();
+      // Fixed six digit precision for doubles without going through a stream
+      static void appendFixed(std::string& value, double d)
+      {
+        char buffer[400];
+        auto res = std::to_chars(buffer, buffer + sizeof(buffer), d, std::chars_format::fixed, 6);
+        if (res.ec == std::errc())
+          value.append(buffer, res.ptr);
       }
 
-      std::string MqttEntitySink::getObservationValue(
-          const observation::ObservationPtr& observation)
+      void MqttEntitySink::getObservationValue(const observation::ObservationPtr& observation,
+                                               std::string& value)
       {
+        using namespace rapidjson;
+
+        value.clear();
         if (observation->isUnavailable())
         {
-          return "UNAVAILABLE";
+          value.append("UNAVAILABLE");
+          return;
         }
 
-        auto value = observation->getValue();
+        auto& v = observation->getValue();
 
-        if (holds_alternative<string>(value))
+        if (holds_alternative<string>(v))
         {
-          return get<string>(value);
+          value.append(get<string>(v));
         }
-        else if (holds_alternative<int64_t>(value))
+        else if (holds_alternative<int64_t>(v))
         {
-          return std::to_string(get<int64_t>(value));
+          char buffer[24];
+          auto res = std::to_chars(buffer, buffer + sizeof(buffer), get<int64_t>(v));
+          value.append(buffer, res.ptr);
         }
-        else if (holds_alternative<double>(value))
+        else if (holds_alternative<double>(v))
         {
-          std::ostringstream oss;
-          oss << std::fixed << std::setprecision(6) << get<double>(value);
-          return oss.str();
+          appendFixed(value, get<double>(v));
         }
-        else if (holds_alternative<entity::Vector>(value))
+        else if (holds_alternative<entity::Vector>(v))
         {
-          auto& vec = get<entity::Vector>(value);
-          std::ostringstream oss;
+          auto& vec = get<entity::Vector>(v);
           for (size_t i = 0; i < vec.size(); ++i)
           {
             if (i > 0)
-              oss << " ";
-            oss << std::fixed << std::setprecision(6) << vec[i];
+              value.push_back(' ');
+            appendFixed(value, vec[i]);
           }
-          return oss.str();
         }
-        else if (holds_alternative<entity::DataSet>(value))
+        else if (holds_alternative<entity::DataSet>(v))
         {
           // For DataSet, return as JSON string
-          json j = json::object();
-          auto& ds = get<entity::DataSet>(value);
+          thread_local StringBuffer buffer;
+          thread_local Writer<StringBuffer> writer(buffer);
+          buffer.Clear();
+          writer.Reset(buffer);
+
+          writer.StartObject();
+          auto& ds = get<entity::DataSet>(v);
           for (auto& entry : ds)
           {
             // Convert the variant value to appropriate JSON type
             if (holds_alternative<string>(entry.m_value))
             {
-              j[entry.m_key] = get<string>(entry.m_value);
+              writer.Key(entry.m_key.data(), SizeType(entry.m_key.size()));
+              auto& s = get<string>(entry.m_value);
+              writer.String(s.data(), SizeType(s.size()));
             }
             else if (holds_alternative<int64_t>(entry.m_value))
             {
-              j[entry.m_key] = get<int64_t>(entry.m_value);
+              writer.Key(entry.m_key.data(), SizeType(entry.m_key.size()));
+              writer.Int64(get<int64_t>(entry.m_value));
             }
             else if (holds_alternative<double>(entry.m_value))
             {
-              j[entry.m_key] = get<double>(entry.m_value);
+              // JSON has no NaN or Infinity, rapidjson would leave the key without a value
+              writer.Key(entry.m_key.data(), SizeType(entry.m_key.size()));
+              auto d = get<double>(entry.m_value);
+              if (std::isfinite(d))
+                writer.Double(d);
+              else
+                writer.Null();
             }
           }
-          return j.dump();
+          writer.EndObject();
+          value.append(buffer.GetString(), buffer.GetSize());
         }
+        else
+        {
+          value.append("UNAVAILABLE");
+        }
+      }
+
+      // Keys are written in sorted order to match the nlohmann::json output of earlier versions
+      template <typename W>
+      inline static void writeKey(W& writer, const std::string_view& key)
+      {
+        writer.Key(key.data(), rapidjson::SizeType(key.size()));
+      }
+
+      template <typename W>
+      inline static void writeString(W& writer, const std::string_view& value)
+      {
+        writer.String(value.data(), rapidjson::SizeType(value.size()));
+      }
 
-        return "UNAVAILABLE";
+      template <typename W>
+      inline static void writeDataItemName(W& writer, const DataItemPtr& dataItem)
+      {
+        const auto& name = dataItem->getName();
+        if (name && !name->empty())
+        {
+          writeKey(writer, "name");
+          writeString(writer, *name);
+        }
       }
 
-      std::string MqttEntitySink::formatObservationJson(
-          const observation::ObservationPtr& observation)
+      template <typename W>
+      inline static void writeDataItemType(W& writer, const DataItemPtr& dataItem,
+                                           const std::string_view& timestamp,
+                                           SequenceNumber_t sequence)
       {
-        json j;
+        writeKey(writer, "sequence");
+        writer.Uint64(sequence);
 
+        auto subType = dataItem->maybeGet<std::string>("subType");
+        if (subType && !subType->empty())
+        {
+          writeKey(writer, "subType");
+          writeString(writer, *subType);
+        }
+
+        writeKey(writer, "timestamp");
+        writeString(writer, timestamp);
+
+        writeKey(writer, "type");
+        writeString(writer, dataItem->getType());
+      }
+
+      void MqttEntitySink::formatObservationJson(const observation::ObservationPtr& observation,
+                                                 std::string& payload)
+      {
+        using namespace rapidjson;
+        using namespace device_model::data_item;
+
+        payload.clear();
         try
         {
           auto dataItem = observation->getDataItem();
           if (!dataItem)
           {
             LOG(error) << "Observation has no data item";
-            return "{}";
+            payload.append("{}");
+            return;
           }
 
-          j["dataItemId"] = dataItem->getId();
+          thread_local std::string value;
+          getObservationValue(observation, value);
 
-          const auto& name = dataItem->getName();
-          if (name && !name->empty())
-          {
-            j["name"] = *name;
-          }
+          thread_local StringBuffer buffer;
+          thread_local Writer<StringBuffer> writer(buffer);
+          buffer.Clear();
+          writer.Reset(buffer);
 
-          j["type"] = dataItem->getType();
-
-          auto subType = dataItem->maybeGet<std::string>("subType");
-          if (subType && !subType->empty())
-          {
-            j["subType"] = *subType;
-          }
-
-          j["timestamp"] = formatTimestamp(observation->getTimestamp());
+          writer.StartObject();
 
           // Get the category
-          auto category = dataItem->getCategory();
-          if (category == device_model::data_item::DataItem::SAMPLE)
-          {
-            j["category"] = "SAMPLE";
-          }
-          else if (category == device_model::data_item::DataItem::EVENT)
-          {
-            j["category"] = "EVENT";
-          }
-          else if (category == device_model::data_item::DataItem::CONDITION)
+          switch (dataItem->getCategory())
           {
-            j["category"] = "CONDITION";
+            case DataItem::SAMPLE:
+              writeKey(writer, "category");
+              writeString(writer, "SAMPLE");
+              break;
+            case DataItem::EVENT:
+              writeKey(writer, "category");
+              writeString(writer, "EVENT");
+              break;
+            case DataItem::CONDITION:
+              writeKey(writer, "category");
+              writeString(writer, "CONDITION");
+              break;
           }
 
+          writeKey(writer, "dataItemId");
+          writeString(writer, dataItem->getId());
+          writeDataItemName(writer, dataItem);
+
           // Add the result/value
-          j["result"] = getObservationValue(observation);
+          writeKey(writer, "result");
+          writeString(writer, value);
 
-          // Add sequence number
-          j["sequence"] = observation->getSequence();
+          char ts[32];
+          auto len = formatTimestamp(observation->getTimestamp(), ts);
+          writeDataItemType(writer, dataItem, std::string_view(ts, len),
+                            observation->getSequence());
+          writer.EndObject();
 
-          auto result = j.dump();
-          LOG(trace) << "Formatted observation JSON: " << result;
-          return result;
+          payload.append(buffer.GetString(), buffer.GetSize());
+          LOG(trace) << "Formatted observation JSON: " << payload;
         }
         catch (const std::exception& e)
         {
           LOG(error) << "Exception formatting observation: " << e.what();
-          return "{}";
+          payload.assign("{}");
         }
       }
 
-      std::string MqttEntitySink::formatConditionJson(const observation::ConditionPtr& condition)
+      void MqttEntitySink::formatConditionJson(const observation::ConditionPtr& condition,
+                                               std::string& payload)
       {
-        json j;
+        using namespace rapidjson;
 
+        payload.clear();
         auto dataItem = condition->getDataItem();
         if (!dataItem)
         {
-          return "{}";
+          payload.append("{}");
+          return;
         }
 
-        j["dataItemId"] = dataItem->getId();
+        thread_local StringBuffer buffer;
+        thread_local Writer<StringBuffer> writer(buffer);
+        buffer.Clear();
+        writer.Reset(buffer);
 
-        const auto& name = dataItem->getName();
-        if (name && !name->empty())
-        {
-          j["name"] = *name;
-        }
-
-        j["type"] = dataItem->getType();
+        writer.StartObject();
+        writeKey(writer, "category");
+        writeString(writer, "CONDITION");
 
-        auto subType = dataItem->maybeGet<std::string>("subType");
-        if (subType && !subType->empty())
+        // Add condition ID if present
+        if (!condition->getCode().empty())
         {
-          j["subType"] = *subType;
+          writeKey(writer, "conditionId");
+          writeString(writer, condition->getCode());
         }
 
-        j["timestamp"] = formatTimestamp(condition->getTimestamp());
-        j["category"] = "CONDITION";
+        writeKey(writer, "dataItemId");
+        writeString(writer, dataItem->getId());
 
         // Add condition-specific fields
+        writeKey(writer, "level");
         switch (condition->getLevel())
         {
           case Condition::NORMAL:
-            j["level"] = "NORMAL";
+            writeString(writer, "NORMAL");
             break;
           case Condition::WARNING:
-            j["level"] = "WARNING";
+            writeString(writer, "WARNING");
             break;
           case Condition::FAULT:
-            j["level"] = "FAULT";
+            writeString(writer, "FAULT");
             break;
           case Condition::UNAVAILABLE:
-            j["level"] = "UNAVAILABLE";
+            writeString(writer, "UNAVAILABLE");
             break;
         }
 
-        // Add native code if present
-        if (condition->hasProperty("nativeCode"))
+        // Add message/value if present
+        if (condition->hasValue())
         {
-          j["nativeCode"] = condition->get<string>("nativeCode");
+          thread_local std::string value;
+          getObservationValue(condition, value);
+          writeKey(writer, "message");
+          writeString(writer, value);
         }
 
-        // Add condition ID if present
-        if (!condition->getCode().empty())
-        {
-          j["conditionId"] = condition->getCode();
-        }
+        writeDataItemName(writer, dataItem);
 
-        // Add message/value if present
-        if (condition->hasValue())
+        // Add native code if present
+        if (condition->hasProperty("nativeCode"))
         {
-          j["message"] = getObservationValue(condition);
+          writeKey(writer, "nativeCode");
+          writeString(writer, condition->get<string>("nativeCode"));
         }
 
-        // Add sequence number
-        j["sequence"] = condition->getSequence();
+        char ts[32];
+        auto len = formatTimestamp(condition->getTimestamp(), ts);
+        writeDataItemType(writer, dataItem, std::string_view(ts, len), condition->getSequence());
+        writer.EndObject();
 
-        return j.dump();
+        payload.append(buffer.GetString(), buffer.GetSize());
       }
 
-      std::string MqttEntitySink::getObservationTopic(
-          const observation::ObservationPtr& observation)
+      std::shared_ptr<const std::string> MqttEntitySink::getObservationTopic(
+          const DataItemPtr& dataItem)
       {
-        auto dataItem = observation->getDataItem();
-        if (!dataItem)
-        {
-          return "";
-        }
+        std::lock_guard<std::mutex> lock(m_topicMutex);
+
+        auto it = m_topics.find(dataItem->getId());
+        if (it != m_topics.end())
+          return it->second;
 
         auto device = dataItem->getComponent()->getDevice();
         if (!device)
         {
-          return "";
+          return nullptr;
         }
 
         std::string topic = m_observationTopicPrefix;
@@ -449,7 +555,9 @@ namespace mtconnect {
         // Append data item ID for flat structure
         topic += "/" + dataItem->getId();
 
-        return topic;
+        auto shared = std::make_shared<const std::string>(std::move(topic));
+        m_topics.emplace(dataItem->getId(), shared);
+        return shared;
       }
 
       bool MqttEntitySink::publish(observation::ObservationPtr& observation)
@@ -463,52 +571,41 @@ namespace mtconnect {
 
         if (!m_client || !m_client->isConnected())
         {
-          std::lock_guard<std::mutex> lock(m_queueMutex);
-          if (m_queuedObservations.size() >= MAX_QUEUE_SIZE)
-          {
-            LOG(warning) << "MqttEntitySink::publish: Observation queue full (" << MAX_QUEUE_SIZE
-                         << "), dropping oldest observation for "
-                         << m_queuedObservations.front()->getDataItem()->getId();
-            m_queuedObservations.erase(m_queuedObservations.begin());
-          }
-          LOG(debug) << "MqttEntitySink::publish: Client not connected, queuing observation for "
+          LOG(trace) << "MqttEntitySink::publish: Client not connected, queuing observation for "
                      << dataItem->getId();
-          m_queuedObservations.push_back(observation);
+          queueObservation(observation);
           return false;
         }
 
-        std::string topic = getObservationTopic(observation);
-        if (topic.empty())
+        auto topic = getObservationTopic(dataItem);
+        if (!topic)
         {
           LOG(warning) << "MqttEntitySink::publish: Empty topic for " << dataItem->getId();
           return false;
         }
 
-        // Get QoS setting
-        auto qos = parseQos(m_options);
-        bool retain = GetOption<bool>(m_options, configuration::MqttRetain).value_or(false);
-
         try
         {
+          thread_local std::string payload;
+
           auto condition = dynamic_pointer_cast<observation::Condition>(observation);
           if (condition)
           {
-            observation::ConditionList condList;
-            condition->getFirst()->getConditionList(condList);
+            observation::ConditionList condList {condition->getFirst()};
 
             for (auto& cond : condList)
             {
-              std::string payload = formatConditionJson(cond);
-              LOG(debug) << "Publishing condition to: " << topic
+              formatConditionJson(cond, payload);
+              LOG(trace) << "Publishing condition to: " << *topic
                          << ", payload size: " << payload.size();
-              m_client->publish(topic, payload, retain, qos);
+              m_client->publish(*topic, payload, m_retain, m_qos);
             }
           }
           else
           {
-            std::string payload = formatObservationJson(observation);
-            LOG(debug) << "Publishing observation to: " << topic << ", size: " << payload.size();
-            m_client->publish(topic, payload, retain, qos);
+            formatObservationJson(observation, payload);
+            LOG(trace) << "Publishing observation to: " << *topic << ", size: " << payload.size();
+            m_client->publish(*topic, payload, m_retain, m_qos);
           }
 
           return true;
@@ -522,6 +619,12 @@ namespace mtconnect {
 
       bool MqttEntitySink::publish(device_model::DevicePtr device)
       {
+        // The device may have been replaced, recompute the topics on the next publish
+        {
+          std::lock_guard<std::mutex> lock(m_topicMutex);
+          m_topics.clear();
+        }
+
         if (!m_client || !m_client->isConnected())
         {
           return false;
@@ -18,9 +18,12 @@
 #pragma once
 
 #include "boost/asio/io_context.hpp"
+#include <boost/circular_buffer.hpp>
 #include <boost/dll/alias.hpp>
 
-#include <nlohmann/json.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "mtconnect/buffer/checkpoint.hpp"
 #include "mtconnect/config.hpp"
@@ -33,7 +36,6 @@
 using namespace std;
 using namespace mtconnect;
 using namespace mtconnect::mqtt_client;
-using json = nlohmann::json;
 
 namespace mtconnect {
   namespace sink {
@@ -87,51 +89,79 @@ namespace mtconnect {
         /// @return `true` when the client is connected
         bool isConnected() { return m_client && m_client->isConnected(); }
 
+        static constexpr size_t MAX_QUEUE_SIZE = 10000;  // Maximum queued observations
+
+        /// @brief get a copy of the observations queued while disconnected, oldest first
+        std::vector<observation::ObservationPtr> getQueuedObservations()
+        {
+          std::lock_guard<std::mutex> lock(m_queueMutex);
+          return {m_queuedObservations.begin(), m_queuedObservations.end()};
+        }
+
       protected:
         /// @brief Format observation as JSON matching MTConnect.NET format
         /// @param observation the observation to format
-        /// @return JSON string
-        std::string formatObservationJson(const observation::ObservationPtr& observation);
+        /// @param payload string to receive the JSON, reused between calls
+        void formatObservationJson(const observation::ObservationPtr& observation,
+                                   std::string& payload);
 
         /// @brief Format condition observation as JSON
         /// @param condition the condition observation
-        /// @return JSON string
-        std::string formatConditionJson(const observation::ConditionPtr& condition);
-
-        /// @brief Get topic for observation using flat structure
-        /// @param observation the observation
-        /// @return formatted topic string
-        std::string getObservationTopic(const observation::ObservationPtr& observation);
+        /// @param payload string to receive the JSON, reused between calls
+        void formatConditionJson(const observation::ConditionPtr& condition,
+                                 std::string& payload);
+
+        /// @brief Get topic for a data item using flat structure
+        ///
+        /// Topics are computed once per data item and cached until the device is published again.
+        ///
+        /// @param dataItem the data item
+        /// @return formatted topic string or `nullptr` if the data item has no device
+        std::shared_ptr<const std::string> getObservationTopic(const DataItemPtr& dataItem);
 
         /// @brief Get value from observation as string
         /// @param observation the observation
-        /// @return value as string
-        std::string getObservationValue(const observation::ObservationPtr& observation);
+        /// @param value string to receive the value, reused between calls
+        void getObservationValue(const observation::ObservationPtr& observation,
+                                 std::string& value);
 
         /// @brief Publish initial device and current observations
         void publishInitialContent();
 
-        /// @brief Convert timestamp to ISO 8601 format
+        /// @brief Publish the observations queued while disconnected, oldest first
+        void publishQueuedObservations();
+
+        /// @brief Queue an observation while disconnected, dropping the oldest if full
+        /// @param observation the observation
+        void queueObservation(const observation::ObservationPtr& observation);
+
+        /// @brief Convert timestamp to ISO 8601 format with microseconds
         /// @param timestamp the timestamp
-        /// @return ISO 8601 string
-        std::string formatTimestamp(const Timestamp& timestamp);
+        /// @param buffer the buffer to write into, must be at least 32 characters
+        /// @return the length of the formatted timestamp
+        static size_t formatTimestamp(const Timestamp& timestamp, char* buffer);
 
       protected:
-        static constexpr size_t MAX_QUEUE_SIZE = 10000;  // Maximum queued observations
 
         std::string m_observationTopicPrefix;  //! Observation topic prefix
         std::string m_deviceTopicPrefix;       //! Device topic prefix
         std::string m_assetTopicPrefix;        //! Asset topic prefix
         std::string m_lastWillTopic;           //! Topic to publish last will
 
+        MqttClient::QOS m_qos;  //! QoS resolved from the options
+        bool m_retain;          //! Retain flag resolved from the options
+
         boost::asio::io_context& m_context;
         boost::asio::io_context::strand m_strand;
 
         ConfigOptions m_options;
 
         std::shared_ptr<MqttClient> m_client;
-        std::vector<observation::ObservationPtr> m_queuedObservations;
+        boost::circular_buffer<observation::ObservationPtr> m_queuedObservations {MAX_QUEUE_SIZE};
         std::mutex m_queueMutex;
+
+        std::unordered_map<std::string, std::shared_ptr<const std::string>> m_topics;
+        std::mutex m_topicMutex;
       };
     }  // namespace mqtt_entity_sink
   }    // namespace sink
@@ -68,7 +68,8 @@ namespace mtconnect {
                     {configuration::MqttCert, string()},
                     {configuration::MqttClientId, string()},
                     {configuration::MqttUserName, string()},
-                    {configuration::MqttPassword, string()}});
+                    {configuration::MqttPassword, string()},
+                    {configuration::MqttCurrentDelta, string()}});
         AddDefaultedOptions(
             config, m_options,
             {{configuration::MqttHost, "127.0.0.1"s},
@@ -95,10 +96,24 @@ namespace mtconnect {
         m_sampleInterval = *GetOption<Milliseconds>(m_options, configuration::MqttSampleInterval);
 
         m_sampleCount = *GetOption<int>(m_options, configuration::MqttSampleCount);
+
+        if (auto delta = GetOption<string>(m_options, configuration::MqttCurrentDelta))
+        {
+          if (boost::iequals(*delta, "Component"))
+            m_currentDelta = CurrentDelta::COMPONENT;
+          else if (boost::iequals(*delta, "DataItem"))
+            m_currentDelta = CurrentDelta::DATA_ITEM;
+          else if (!delta->empty() && !boost::iequals(*delta, "None"))
+            LOG(warning) << "Invalid MqttCurrentDelta: " << *delta << ", publishing full current";
+        }
       }
 
       void MqttService::start()
       {
+        // Keep the instance id when the buffer was restored from the observation journal
+        if (auto id = m_sinkContract->getInstanceId())
+          m_instanceId = *id;
+
         if (!m_client)
         {
           auto clientHandler = make_unique<ClientHandler>();
@@ -175,6 +190,9 @@ namespace mtconnect {
       void MqttService::pubishInitialContent()
       {
         using std::placeholders::_1;
+        // Publish the full current for every device after connecting
+        m_currentSequence.clear();
+
         for (auto &dev : m_sinkContract->getDevices())
         {
           publish(dev);
@@ -190,7 +208,7 @@ namespace mtconnect {
         auto seq = publishCurrent(boost::system::error_code {});
         for (auto &dev : m_sinkContract->getDevices())
         {
-          FilterSet filterSet = filterForDevice(dev);
+          FilterSet filterSet = *filterForDevice(dev);
           auto sampler =
               make_shared<AsyncSample>(m_strand, m_sinkContract->getCircularBuffer(),
                                        std::move(filterSet), m_sampleInterval, 600s, m_client, dev);
@@ -262,27 +280,48 @@ namespace mtconnect {
 
         for (auto &device : m_sinkContract->getDevices())
         {
-          auto topic = formatTopic(m_currentTopic, device);
-          LOG(debug) << "Publishing current for: " << topic;
-
+          const auto &uuid = *device->getUuid();
+          auto last = m_currentSequence.find(uuid);
           ObservationList observations;
-          auto filterSet = filterForDevice(device);
 
           {
             auto &buffer = m_sinkContract->getCircularBuffer();
             std::lock_guard<buffer::CircularBuffer> lock(buffer);
 
+            if (m_modelChanged)
+            {
+              m_modelChanged = false;
+              m_currentSequence.clear();
+              last = m_currentSequence.end();
+            }
+
             firstSeq = buffer.getFirstSequence();
             seq = buffer.getSequence();
-            m_sinkContract->getCircularBuffer().getLatest().getObservations(observations,
-                                                                            filterSet);
+
+            // Skip the device if nothing has changed since the last current
+            auto changed = m_deviceChanged.try_emplace(device.get(), 0).first;
+            if (last != m_currentSequence.end() && changed->second < last->second)
+              continue;
+
+            buffer.getLatest().getObservations(observations, filterForDevice(device));
           }
 
-          auto doc = m_printer->printSample(m_instanceId,
-                                            m_sinkContract->getCircularBuffer().getBufferSize(),
-                                            seq, firstSeq, seq - 1, observations);
+          auto topic = formatTopic(m_currentTopic, device);
+          if (last == m_currentSequence.end() || m_currentDelta == CurrentDelta::NONE)
+          {
+            LOG(debug) << "Publishing current for: " << topic;
+            auto doc = m_printer->printSample(m_instanceId,
+                                              m_sinkContract->getCircularBuffer().getBufferSize(),
+                                              seq, firstSeq, seq - 1, observations);
 
-          m_client->publish(topic, doc);
+            m_client->publish(topic, doc);
+          }
+          else
+          {
+            publishDelta(topic, observations, last->second, seq, firstSeq);
+          }
+
+          m_currentSequence.insert_or_assign(uuid, seq);
         }
 
         using std::placeholders::_1;
@@ -293,15 +332,61 @@ namespace mtconnect {
         return seq;
       }
 
+      void MqttService::publishDelta(const std::string &topic, ObservationList &observations,
+                                     SequenceNumber_t since, SequenceNumber_t seq,
+                                     SequenceNumber_t firstSeq)
+      {
+        std::map<std::string, ObservationList> changes;
+        for (auto &observation : observations)
+        {
+          if (observation->getSequence() < since)
+            continue;
+
+          auto dataItem = observation->getDataItem();
+          if (m_currentDelta == CurrentDelta::COMPONENT)
+          {
+            if (auto component = dataItem->getComponent())
+              changes[component->getId()].push_back(observation);
+          }
+          else
+          {
+            changes[dataItem->getId()].push_back(observation);
+          }
+        }
+
+        auto prefix = topic;
+        if (prefix.back() != '/')
+          prefix.append("/");
+
+        for (auto &[id, list] : changes)
+        {
+          LOG(debug) << "Publishing current delta for: " << prefix << id;
+          auto doc =
+              m_printer->printSample(m_instanceId, m_sinkContract->getCircularBuffer().getBufferSize(),
+                                     seq, firstSeq, seq - 1, list);
+          m_client->publish(prefix + id, doc);
+        }
+      }
+
       bool MqttService::publish(observation::ObservationPtr &observation)
       {
-        // Since we are doing periodic publishing, there is nothing to do here.
+        // Samples and currents are published periodically, only track which devices changed
+        if (auto component = observation->getDataItem()->getComponent())
+        {
+          if (auto device = component->getDevice())
+            m_deviceChanged.insert_or_assign(device.get(), observation->getSequence());
+        }
         return true;
       }
 
       bool MqttService::publish(device_model::DevicePtr device)
       {
-        m_filters.clear();
+        {
+          std::lock_guard<buffer::CircularBuffer> lock(m_sinkContract->getCircularBuffer());
+          m_filters.clear();
+          m_deviceChanged.clear();
+          m_modelChanged = true;
+        }
 
         auto topic = formatTopic(m_deviceTopic, device);
         auto doc = m_jsonPrinter->print(device);
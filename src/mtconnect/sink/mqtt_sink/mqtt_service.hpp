@@ -52,6 +52,14 @@ namespace mtconnect {
 
       struct AsyncSample;
 
+      /// @brief How the current is published once a full current has been published
+      enum class CurrentDelta
+      {
+        NONE,       ///< Always publish the full current for the device
+        COMPONENT,  ///< Publish the changed observations for each component on its own topic
+        DATA_ITEM   ///< Publish each changed observation on its own topic
+      };
+
       class AGENT_LIB_API MqttService : public sink::Sink
       {
         // dynamic loading of sink
@@ -76,7 +84,8 @@ namespace mtconnect {
 
         /// @brief Receive an observation
         ///
-        /// This does nothing since we are periodically publishing current and samples
+        /// Records the sequence of the last change to the device so the current is only published
+        /// for devices that changed. Called with the circular buffer locked.
         ///
         /// @param observation shared pointer to the observation
         /// @return `true` if the publishing was successful
@@ -96,6 +105,8 @@ namespace mtconnect {
         void pubishInitialContent();
 
         /// @brief Publish a current using `CurrentInterval` option.
+        ///
+        /// Devices without new observations since their last current are skipped.
         SequenceNumber_t publishCurrent(boost::system::error_code ec);
 
         /// @brief publish sample when observations arrive.
@@ -114,14 +125,14 @@ namespace mtconnect {
         bool isConnected() { return m_client && m_client->isConnected(); }
 
       protected:
-        const FilterSet &filterForDevice(const DevicePtr &device)
+        const FilterSetOpt &filterForDevice(const DevicePtr &device)
         {
           auto filter = m_filters.find(*(device->getUuid()));
           if (filter == m_filters.end())
           {
             auto pos = m_filters.emplace(*(device->getUuid()), FilterSet());
             filter = pos.first;
-            auto &set = filter->second;
+            auto &set = *filter->second;
             for (const auto &wdi : device->getDeviceDataItems())
             {
               const auto di = wdi.lock();
@@ -132,6 +143,9 @@ namespace mtconnect {
           return filter->second;
         }
 
+        void publishDelta(const std::string &topic, observation::ObservationList &observations,
+                          SequenceNumber_t since, SequenceNumber_t seq, SequenceNumber_t firstSeq);
+
         std::string formatTopic(const std::string &topic, const DevicePtr device,
                                 const std::string defaultUuid = "Unknown")
         {
@@ -182,6 +196,7 @@ namespace mtconnect {
 
         std::chrono::milliseconds m_currentInterval;  //! Interval in ms to update current
         std::chrono::milliseconds m_sampleInterval;   //! min interval in ms to update sample
+        CurrentDelta m_currentDelta {CurrentDelta::NONE};
 
         uint64_t m_instanceId;
 
@@ -197,8 +212,15 @@ namespace mtconnect {
         boost::asio::steady_timer m_currentTimer;
         int m_sampleCount;  //! Timer for current requests
 
-        std::map<std::string, FilterSet> m_filters;
+        std::map<std::string, FilterSetOpt> m_filters;  //! Cached until the devices change
         std::map<std::string, std::shared_ptr<AsyncSample>> m_samplers;
+
+        //! The sequence of the last observation for each device, guarded by the buffer lock
+        std::unordered_map<const device_model::Device *, SequenceNumber_t> m_deviceChanged;
+        //! Set when the devices change, guarded by the buffer lock
+        bool m_modelChanged {false};
+        //! The next sequence when the current was last published for each device uuid
+        std::map<std::string, SequenceNumber_t> m_currentSequence;
       };
     }  // namespace mqtt_sink
   }    // namespace sink
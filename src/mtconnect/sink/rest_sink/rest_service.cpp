@@ -22,6 +22,7 @@
 #include "error.hpp"
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/entity/xml_parser.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/pipeline/shdr_token_mapper.hpp"
 #include "mtconnect/pipeline/shdr_tokenizer.hpp"
 #include "mtconnect/pipeline/timestamp_extractor.hpp"
@@ -113,6 +114,8 @@ namespace mtconnect {
             "Time in ms between publishing a empty document when no data has changed"},
            {"id", PATH, "webservice request id"}});
 
+      if (metrics::Registry::isEnabled())
+        createMetricsRoutings();
       createCurrentRoutings();
       createSampleRoutings();
       createAssetRoutings();
@@ -136,7 +139,14 @@ namespace mtconnect {
           });
     }
 
-    void RestService::start() { m_server->start(); }
+    void RestService::start()
+    {
+      // Keep the instance id when the buffer was restored from the observation journal
+      if (auto id = m_sinkContract->getInstanceId())
+        m_instanceId = *id;
+
+      m_server->start();
+    }
 
     void RestService::stop() { m_server->stop(); }
 
@@ -460,6 +470,22 @@ namespace mtconnect {
       m_server->addRouting({boost::beast::http::verb::get, regex("/.+"), handler});
     }
 
+    void RestService::createMetricsRoutings()
+    {
+      using namespace rest_sink;
+      auto handler = [&](SessionPtr session, RequestPtr request) -> bool {
+        auto body = metrics::Registry::instance().print();
+        respond(session,
+                make_unique<Response>(status::ok, body, "text/plain; version=0.0.4; charset=utf-8"),
+                request->m_requestId);
+        return true;
+      };
+
+      m_server->addRouting({boost::beast::http::verb::get, "/metrics", handler})
+          .document("Agent performance metrics",
+                    "Latency histograms and counters in the Prometheus text exposition format");
+    }
+
     void RestService::createProbeRoutings()
     {
       using namespace rest_sink;
@@ -29,6 +29,7 @@
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/utilities.hpp"
 #include "session.hpp"
 #include "websocket_request_manager.hpp"
@@ -154,6 +155,13 @@ namespace mtconnect::sink::rest_sink {
         LOG(trace) << "Waiting for mutex";
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        if (metrics::Registry::isEnabled())
+        {
+          static auto &depth = metrics::Registry::instance().histogram(
+              "mtconnect_websocket_queue_depth", {}, 1.0);
+          depth.record(m_messageQueue.size());
+        }
+
         if (m_busy || m_messageQueue.size() > 0)
         {
           LOG(debug) << "Queuing Chunk for " << *requestId;
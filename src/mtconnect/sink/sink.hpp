@@ -111,6 +111,9 @@ namespace mtconnect {
       /// @brief Get the common circular buffer
       /// @return a reference to the circular buffer
       virtual buffer::CircularBuffer &getCircularBuffer() = 0;
+      /// @brief Get the instance id the agent restored from its observation journal
+      /// @return the instance id or `nullopt` if the sink should create its own
+      virtual std::optional<uint64_t> getInstanceId() const { return std::nullopt; }
 
       /// @brief Get a pointer to the asset storage
       /// @return a pointer to the asset storage.
@@ -18,6 +18,8 @@
 #pragma once
 
 #include "mtconnect/config.hpp"
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/source/adapter/adapter_capture.hpp"
 #include "mtconnect/source/adapter/adapter_pipeline.hpp"
 #include "mtconnect/source/source.hpp"
 
@@ -57,6 +59,15 @@ namespace mtconnect::source::adapter {
     void setHandler(std::unique_ptr<Handler> &h) { m_handler = std::move(h); }
     ///@}
 
+  protected:
+    /// @brief record the input to the handler when the `CaptureFile` option is given
+    void captureInput()
+    {
+      auto path = GetOption<std::string>(m_options, configuration::CaptureFile);
+      if (m_handler && path && !path->empty())
+        AdapterCapture::wrap(std::make_shared<AdapterCapture>(*path), *m_handler);
+    }
+
   protected:
     std::string m_identity;
     std::unique_ptr<Handler> m_handler;
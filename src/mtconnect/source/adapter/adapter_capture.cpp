@@ -0,0 +1,109 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "adapter_capture.hpp"
+
+#include <stdexcept>
+
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect::source::adapter {
+  AdapterCapture::AdapterCapture(const std::filesystem::path &path)
+    : m_file(path, ios::binary | ios::trunc), m_start(chrono::steady_clock::now())
+  {
+    if (!m_file)
+    {
+      LOG(error) << "Cannot open adapter capture file: " << path;
+      return;
+    }
+
+    LOG(info) << "Capturing adapter input to " << path;
+    m_file << CaptureHeader << '\n';
+  }
+
+  void AdapterCapture::record(CaptureRecord::Kind kind, const std::string &topic,
+                              const std::string &payload)
+  {
+    auto offset = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - m_start);
+
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_file)
+      return;
+
+    m_file << offset.count() << ' ' << char(kind) << ' ' << topic.size() << ' ' << payload.size()
+           << '\n'
+           << topic << payload << '\n';
+    m_file.flush();
+  }
+
+  void AdapterCapture::wrap(std::shared_ptr<AdapterCapture> capture, Handler &handler)
+  {
+    if (handler.m_processData)
+    {
+      handler.m_processData = [capture, process = std::move(handler.m_processData)](
+                                  const std::string &data, const std::string &source) {
+        capture->record(CaptureRecord::DATA, "", data);
+        process(data, source);
+      };
+    }
+    if (handler.m_command)
+    {
+      handler.m_command = [capture, command = std::move(handler.m_command)](
+                              const std::string &cmd, const std::string &value,
+                              const std::string &source) {
+        capture->record(CaptureRecord::COMMAND, cmd, value);
+        command(cmd, value, source);
+      };
+    }
+    if (handler.m_processMessage)
+    {
+      handler.m_processMessage = [capture, process = std::move(handler.m_processMessage)](
+                                     const std::string &topic, const std::string &data,
+                                     const std::string &source) {
+        capture->record(CaptureRecord::MESSAGE, topic, data);
+        process(topic, data, source);
+      };
+    }
+  }
+
+  CaptureReader::CaptureReader(const std::filesystem::path &path) : m_file(path, ios::binary)
+  {
+    string header;
+    if (!m_file || !getline(m_file, header) || header != CaptureHeader)
+      throw runtime_error("Not an adapter capture file: " + path.string());
+  }
+
+  bool CaptureReader::next(CaptureRecord &record)
+  {
+    int64_t offset;
+    char kind;
+    size_t topicSize, payloadSize;
+    if (!(m_file >> offset >> kind >> topicSize >> payloadSize) || m_file.get() != '\n')
+      return false;
+
+    record.m_offset = chrono::nanoseconds(offset);
+    record.m_kind = CaptureRecord::Kind(kind);
+    record.m_topic.resize(topicSize);
+    record.m_payload.resize(payloadSize);
+    m_file.read(record.m_topic.data(), topicSize);
+    m_file.read(record.m_payload.data(), payloadSize);
+
+    return bool(m_file) && m_file.get() == '\n';
+  }
+}  // namespace mtconnect::source::adapter
@@ -0,0 +1,99 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/source/adapter/adapter_pipeline.hpp"
+
+namespace mtconnect::source::adapter {
+  /// @brief A single adapter input recorded at the handler boundary
+  struct CaptureRecord
+  {
+    /// @brief The handler method that received the input
+    enum Kind : char
+    {
+      DATA = 'D',     ///< `Handler::m_processData`
+      COMMAND = 'C',  ///< `Handler::m_command`, the topic is the command
+      MESSAGE = 'M'   ///< `Handler::m_processMessage`
+    };
+
+    std::chrono::nanoseconds m_offset {0};  ///< time since the capture started
+    Kind m_kind {DATA};
+    std::string m_topic;
+    std::string m_payload;
+  };
+
+  /// @brief Records the raw input of an adapter with its timing so it can be replayed
+  ///
+  /// The capture file starts with a header line followed by one record for each call to the
+  /// handler. Each record is a line with the offset in nanoseconds, the kind, and the sizes of the
+  /// topic and payload, followed by the topic and payload and a newline. The sizes allow payloads
+  /// to contain new lines.
+  class AGENT_LIB_API AdapterCapture
+  {
+  public:
+    /// @brief Create a capture file, replacing an existing file
+    /// @param[in] path the capture file
+    AdapterCapture(const std::filesystem::path &path);
+
+    /// @brief Append a record to the capture
+    /// @param[in] kind the kind of record
+    /// @param[in] topic the topic or command, empty for data
+    /// @param[in] payload the raw input
+    void record(CaptureRecord::Kind kind, const std::string &topic, const std::string &payload);
+
+    /// @brief Wrap the handler methods so all input is recorded before it is processed
+    /// @param[in] capture the capture
+    /// @param[in,out] handler the handler to wrap
+    static void wrap(std::shared_ptr<AdapterCapture> capture, Handler &handler);
+
+  protected:
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  /// @brief Reads the records of a capture file
+  class AGENT_LIB_API CaptureReader
+  {
+  public:
+    /// @brief Open a capture file
+    /// @param[in] path the capture file
+    /// @throws std::runtime_error if the file is not a capture
+    CaptureReader(const std::filesystem::path &path);
+
+    /// @brief Read the next record
+    /// @param[out] record the record
+    /// @return `true` if a record was read, `false` at the end of the capture or a truncated
+    /// record
+    bool next(CaptureRecord &record);
+
+  protected:
+    std::ifstream m_file;
+  };
+
+  /// @brief The first line of a capture file
+  constexpr const char *CaptureHeader = "MTConnectCapture 1";
+}  // namespace mtconnect::source::adapter
@@ -88,9 +88,12 @@ namespace mtconnect::source::adapter::agent_adapter {
                          {configuration::RelativeTime, false},
                          {configuration::UsePolling, false},
                          {configuration::EnableSourceDeviceModels, false},
+                         {configuration::EnableCompression, false},
+                         {configuration::UseJson, false},
                          {"!CloseConnectionAfterResponse!", false}});
 
     m_handler = m_pipeline.makeHandler();
+    captureInput();
 
     auto urlOpt = GetOption<std::string>(m_options, configuration::Url);
     if (urlOpt)
@@ -114,6 +117,8 @@ namespace mtconnect::source::adapter::agent_adapter {
     m_reconnectInterval = *GetOption<Milliseconds>(m_options, configuration::ReconnectInterval);
     m_pollingInterval = *GetOption<Milliseconds>(m_options, configuration::PollingInterval);
     m_probeAgent = *GetOption<bool>(m_options, configuration::EnableSourceDeviceModels);
+    m_compression = *GetOption<bool>(m_options, configuration::EnableCompression);
+    m_useJson = *GetOption<bool>(m_options, configuration::UseJson);
 
     m_closeConnectionAfterResponse = *GetOption<bool>(m_options, "!CloseConnectionAfterResponse!");
 
@@ -185,10 +190,12 @@ namespace mtconnect::source::adapter::agent_adapter {
     m_session->setIdentity(m_identity);
     m_session->setCloseConnectionAfterResponse(m_closeConnectionAfterResponse);
     m_session->setUpdateAssets([this]() { updateAssets(); });
+    m_session->setCompression(m_compression);
 
     m_assetSession->setHandler(m_handler.get());
     m_assetSession->setIdentity(m_identity);
     m_assetSession->setCloseConnectionAfterResponse(m_closeConnectionAfterResponse);
+    m_assetSession->setCompression(m_compression);
 
     using namespace std::placeholders;
     m_assetSession->setFailed(std::bind(&AgentAdapter::assetsFailed, this, _1));
@@ -391,7 +398,10 @@ namespace mtconnect::source::adapter::agent_adapter {
     if (m_stopped)
       return false;
 
-    m_streamRequest.emplace(m_sourceDevice, "current", UrlQuery(), false,
+    UrlQuery query;
+    if (m_useJson)
+      query.insert_or_assign("format", "json");
+    m_streamRequest.emplace(m_sourceDevice, "current", query, false,
                             [this]() { return sample(); });
     return m_session->makeRequest(*m_streamRequest);
   }
@@ -406,6 +416,8 @@ namespace mtconnect::source::adapter::agent_adapter {
       using namespace boost;
       UrlQuery query({{"from", lexical_cast<string>(m_feedback.m_next)},
                       {"count", lexical_cast<string>(m_count)}});
+      if (m_useJson)
+        query.insert_or_assign("format", "json");
       m_streamRequest.emplace(m_sourceDevice, "sample", query, false, [this]() {
         m_pollingTimer.expires_after(m_pollingInterval);
         m_pollingTimer.async_wait(asio::bind_executor(
@@ -426,6 +438,8 @@ namespace mtconnect::source::adapter::agent_adapter {
                       {"count", lexical_cast<string>(m_count)},
                       {"heartbeat", lexical_cast<string>(m_heartbeat.count())},
                       {"interval", lexical_cast<string>(m_pollingInterval.count())}});
+      if (m_useJson)
+        query.insert_or_assign("format", "json");
       m_streamRequest.emplace(m_sourceDevice, "sample", query, true, nullptr);
       m_session->makeRequest(*m_streamRequest);
     }
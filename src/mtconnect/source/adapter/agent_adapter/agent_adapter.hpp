@@ -135,6 +135,8 @@ namespace mtconnect::source::adapter::agent_adapter {
     bool m_stopped = false;
     bool m_usePolling = false;
     bool m_probeAgent = false;
+    bool m_compression = false;
+    bool m_useJson = false;
 
     std::chrono::milliseconds m_reconnectInterval;
     std::chrono::milliseconds m_pollingInterval;
@@ -0,0 +1,98 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <string_view>
+#include <zlib.h>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/logging.hpp"
+
+namespace mtconnect::source::adapter::agent_adapter {
+  /// @brief Incremental decompression of a `Content-Encoding: gzip` HTTP body
+  ///
+  /// The body can be given in arbitrary pieces as it arrives from the network. Decompressed data
+  /// is passed to the sink as soon as zlib produces it, so a multipart stream can be framed
+  /// without waiting for the end of the response.
+  class Inflater
+  {
+  public:
+    Inflater()
+    {
+      m_stream.zalloc = Z_NULL;
+      m_stream.zfree = Z_NULL;
+      m_stream.opaque = Z_NULL;
+      m_stream.next_in = Z_NULL;
+      m_stream.avail_in = 0;
+
+      // Adding 16 to the window bits selects the gzip wrapper
+      m_valid = inflateInit2(&m_stream, 16 + MAX_WBITS) == Z_OK;
+    }
+    Inflater(const Inflater &) = delete;
+    Inflater &operator=(const Inflater &) = delete;
+    ~Inflater()
+    {
+      if (m_valid)
+        inflateEnd(&m_stream);
+    }
+
+    /// @brief decompress the next piece of the body
+    /// @tparam Sink a callable taking `(const char *data, size_t size)`
+    /// @param[in] input compressed data
+    /// @param[in] sink receives the decompressed data
+    /// @return `false` if the data is not a valid gzip stream
+    template <typename Sink>
+    bool inflate(std::string_view input, Sink &&sink)
+    {
+      if (!m_valid)
+        return false;
+
+      m_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+      m_stream.avail_in = static_cast<uInt>(input.size());
+
+      do
+      {
+        m_stream.next_out = reinterpret_cast<Bytef *>(m_buffer);
+        m_stream.avail_out = sizeof(m_buffer);
+
+        auto res = ::inflate(&m_stream, Z_NO_FLUSH);
+        if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR)
+        {
+          LOG(error) << "Cannot decompress gzip content: "
+                     << (m_stream.msg != nullptr ? m_stream.msg : "unknown error");
+          return false;
+        }
+
+        auto size = sizeof(m_buffer) - m_stream.avail_out;
+        if (size > 0)
+          sink(m_buffer, size);
+
+        // A gzip body may consist of multiple members
+        if (res == Z_STREAM_END && inflateReset(&m_stream) != Z_OK)
+          return false;
+      } while (m_stream.avail_in > 0 || m_stream.avail_out == 0);
+
+      return true;
+    }
+
+  protected:
+    z_stream m_stream;
+    bool m_valid {false};
+    char m_buffer[16 * 1024];
+  };
+}  // namespace mtconnect::source::adapter::agent_adapter
@@ -109,6 +109,7 @@ namespace mtconnect::source::adapter::agent_adapter {
     void setUpdateAssets(UpdateAssets updateAssets) { m_updateAssets = std::move(updateAssets); }
     void setCloseConnectionAfterResponse(bool close) { m_closeConnectionAfterResponse = close; }
     void setTimeout(std::chrono::milliseconds timeout) { m_timeout = timeout; }
+    void setCompression(bool compression) { m_compression = compression; }
     ///@}
 
   protected:
@@ -119,6 +120,7 @@ namespace mtconnect::source::adapter::agent_adapter {
     bool m_closeConnectionAfterResponse = false;    ///< Close connection after each response
     std::chrono::milliseconds m_timeout = std::chrono::milliseconds(30000);  ///< I/O timeout
     bool m_closeOnRead = false;                     ///< Close after read (HTTP 1.0 or Connection: close)
+    bool m_compression = false;                     ///< Request gzip content encoding
   };
 
 }  // namespace mtconnect::source::adapter::agent_adapter
@@ -29,6 +29,7 @@
 #include "mtconnect/pipeline/mtconnect_xml_transform.hpp"
 #include "mtconnect/pipeline/response_document.hpp"
 #include "mtconnect/utilities.hpp"
+#include "inflater.hpp"
 #include "session.hpp"
 
 namespace mtconnect::source::adapter::agent_adapter {
@@ -108,6 +109,7 @@ namespace mtconnect::source::adapter::agent_adapter {
         m_chunkParser.reset();
         m_textParser.reset();
         m_req.reset();
+        m_inflater.reset();
         m_hasHeader = false;
         if (m_chunk.size() > 0)
           m_chunk.consume(m_chunk.size());
@@ -253,6 +255,11 @@ namespace mtconnect::source::adapter::agent_adapter {
         m_req->set(http::field::connection, "close");
       }
 
+      if (m_compression)
+      {
+        m_req->set(http::field::accept_encoding, "gzip");
+      }
+
       derived().lowestLayer().expires_after(m_timeout);
 
       LOG(debug) << "Agent adapter making request: " << m_url.getUrlText(std::nullopt) << " target "
@@ -329,6 +336,14 @@ namespace mtconnect::source::adapter::agent_adapter {
         m_closeOnRead = a->value() == "close";
       }
 
+      m_inflater.reset();
+      if (auto e = msg.find(http::field::content_encoding);
+          e != msg.end() && beast::iequals(e->value(), "gzip"))
+      {
+        LOG(trace) << "Agent adapter: response is gzip encoded";
+        m_inflater.emplace();
+      }
+
       if (m_request->m_stream && m_headerParser->chunked())
       {
         onChunkedContent();
@@ -368,7 +383,22 @@ namespace mtconnect::source::adapter::agent_adapter {
       if (!derived().lowestLayer().socket().is_open())
         derived().disconnect();
 
-      processData(m_textParser->get().body());
+      if (m_inflater)
+      {
+        std::string body;
+        if (!m_inflater->inflate(m_textParser->get().body(), [&body](const char *data, size_t size) {
+              body.append(data, size);
+            }))
+        {
+          return failed(source::make_error_code(ErrorCode::RETRY_REQUEST),
+                        "Cannot decompress response");
+        }
+        processData(body);
+      }
+      else
+      {
+        processData(m_textParser->get().body());
+      }
 
       m_textParser.reset();
       m_req.reset();
@@ -529,6 +559,20 @@ namespace mtconnect::source::adapter::agent_adapter {
           return body.size();
         }
 
+        if (m_inflater)
+        {
+          // Inflate as the data arrives so the parts can be framed before the response completes
+          if (!m_inflater->inflate({body.data(), body.size()}, [this](const char *data, size_t size) {
+                m_chunk.commit(asio::buffer_copy(m_chunk.prepare(size), asio::buffer(data, size)));
+              }))
+          {
+            derived().lowestLayer().close();
+            failed(source::make_error_code(source::ErrorCode::RESTART_STREAM),
+                   "Cannot decompress streaming data");
+            return body.size();
+          }
+        }
+        else
         {
           std::ostream cstr(&m_chunk);
           cstr << body;
@@ -537,18 +581,22 @@ namespace mtconnect::source::adapter::agent_adapter {
         LOG(trace) << "Received: -------- " << m_chunk.size() << " " << remain << "\n"
                    << body << "\n-------------";
 
-        if (!m_hasHeader)
+        // A single read may complete more than one part
+        while (true)
         {
-          if (!parseMimeHeader())
+          if (!m_hasHeader)
           {
-            LOG(trace) << "Insufficient data to parse chunk header, wait for more data";
-            return body.size();
+            if (!parseMimeHeader())
+            {
+              LOG(trace) << "Insufficient data to parse chunk header, wait for more data";
+              break;
+            }
           }
-        }
 
-        auto len = m_chunk.size();
-        if (len >= m_chunkLength)
-        {
+          auto len = m_chunk.size();
+          if (len < m_chunkLength)
+            break;
+
           auto start = static_cast<const char *>(m_chunk.data().data());
           boost::string_view sbuf(start, m_chunkLength);
 
@@ -556,6 +604,9 @@ namespace mtconnect::source::adapter::agent_adapter {
 
           processData(std::string(sbuf));
 
+          if (!m_request)
+            break;
+
           m_chunk.consume(m_chunkLength);
           m_hasHeader = false;
         }
@@ -614,6 +665,7 @@ namespace mtconnect::source::adapter::agent_adapter {
     size_t m_chunkLength;
     bool m_hasHeader = false;
     boost::asio::streambuf m_chunk;
+    std::optional<Inflater> m_inflater;
 
     // For request queuing
     std::optional<Request> m_request;
@@ -102,6 +102,7 @@ namespace mtconnect {
       }
 
       m_handler = m_pipeline.makeHandler();
+      captureInput();
       auto clientHandler = make_unique<ClientHandler>();
 
       m_pipeline.m_handler = m_handler.get();
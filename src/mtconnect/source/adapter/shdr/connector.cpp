@@ -21,7 +21,6 @@
 #include <boost/asio.hpp>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/connect.hpp>
-#include <boost/asio/read_until.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/bind/bind.hpp>
 
@@ -51,10 +50,9 @@ namespace mtconnect::source::adapter::shdr {
       m_resolver(m_strand.context()),
       m_port(port),
       m_localPort(0),
-      m_incoming(1024 * 1024),
+      m_incoming(RECEIVE_BUFFER_SIZE),
       m_timer(strand.context()),
       m_heartbeatTimer(strand.context()),
-      m_receiveTimeout(strand.context()),
       m_connected(false),
       m_disconnecting(false),
       m_realTime(false),
@@ -219,6 +217,7 @@ namespace mtconnect::source::adapter::shdr {
 
       connected();
       m_connected = true;
+      setReceiveTimeout();
       sendCommand("PING");
 
       reader(sys::error_code(), 0);
@@ -227,7 +226,7 @@ namespace mtconnect::source::adapter::shdr {
 
   void Connector::reader(sys::error_code ec, size_t len)
   {
-    NAMED_SCOPE("Connector::reader");
+    HOT_NAMED_SCOPE("Connector::reader");
 
     if (!m_connected)
       return;
@@ -246,21 +245,15 @@ namespace mtconnect::source::adapter::shdr {
         return;
       }
 
-      m_timer.cancel();
-
-      while (parseSocketBuffer())
-        ;
+      // Only record the time, the receive timeout service checks the limit
+      if (m_receiveWatch)
+        m_receiveWatch->touch();
 
-      m_timer.expires_after(m_receiveTimeLimit);
-      m_timer.async_wait([this](boost::system::error_code ec) {
-        if (ec != boost::asio::error::operation_aborted)
-        {
-          LOG(warning) << "operation timed out after " << m_receiveTimeLimit.count() << "ms";
-          asio::dispatch(m_strand, boost::bind(&Connector::reconnect, this));
-        }
-      });
+      m_incoming.commit(len);
+      parseSocketBuffer();
 
-      asio::async_read_until(m_socket, m_incoming, '\n', [this](sys::error_code ec, size_t len) {
+      // Read directly into the free space of the ring
+      m_socket.async_read_some(m_incoming.prepare(), [this](sys::error_code ec, size_t len) {
         asio::dispatch(m_strand, boost::bind(&Connector::reader, this, ec, len));
       });
     }
@@ -277,47 +270,46 @@ namespace mtconnect::source::adapter::shdr {
     }
   }
 
-  void Connector::parseBuffer(const char *buffer)
+  void Connector::parseBuffer(string_view buffer)
   {
-    std::ostream os(&m_incoming);
-    os << buffer;
-    while (parseSocketBuffer())
-      ;
+    if (m_receiveWatch)
+      m_receiveWatch->touch();
+
+    // There is always free space after the lines are parsed
+    while (!buffer.empty())
+    {
+      buffer.remove_prefix(m_incoming.write(buffer));
+      parseSocketBuffer();
+    }
   }
 
   inline void Connector::setReceiveTimeout()
   {
     NAMED_SCOPE("Connector::setReceiveTimeout");
 
-    m_receiveTimeout.expires_after(m_receiveTimeLimit);
-    m_receiveTimeout.async_wait([this](sys::error_code ec) {
-      if (!ec)
-      {
-        LOG(warning) << "(Port:" << m_localPort << ")"
-                     << " connect: Did not receive data for over: " << m_receiveTimeLimit.count()
-                     << " ms";
-        asio::dispatch(m_strand, boost::bind(&Connector::reconnect, this));
-      }
-      else if (ec != boost::asio::error::operation_aborted)
-      {
-        LOG(error) << "Receive timeout: " << ec.message();
-      }
+    // Replaces the current watch, the service drops it once it is released
+    auto &service = asio::use_service<ReceiveTimeoutService>(m_strand.context());
+    m_receiveWatch = service.watch(m_receiveTimeLimit, [this]() {
+      LOG(warning) << "(Port:" << m_localPort << ")"
+                   << " connect: Did not receive data for over: " << m_receiveTimeLimit.count()
+                   << " ms";
+      asio::dispatch(m_strand, boost::bind(&Connector::reconnect, this));
     });
   }
 
-  inline void Connector::processLine(const std::string &line)
+  inline void Connector::processLine(string_view line)
   {
-    NAMED_SCOPE("Connector::processLine");
+    HOT_NAMED_SCOPE("Connector::processLine");
 
-    LOG(trace) << "(" << m_server << ":" << m_port << ") Received line: " << line;
+    LOG_SAMPLED(trace) << "(" << m_server << ":" << m_port << ") Received line: " << line;
 
     // Check for heartbeats
-    if (line[0] == '*' && !line.compare(0, 6, "* PONG"))
+    if (line[0] == '*' && line.starts_with("* PONG"))
     {
       LOG(debug) << "(Port:" << m_localPort << ") Received a PONG for " << m_server << " on port "
                  << m_port;
       if (!m_heartbeats)
-        startHeartbeats(line);
+        startHeartbeats(string(line));
     }
     else
     {
@@ -332,39 +324,18 @@ namespace mtconnect::source::adapter::shdr {
     return isspace(*cp) ? 0 : cp - start + 1;
   }
 
-  bool Connector::parseSocketBuffer()
+  void Connector::parseSocketBuffer()
   {
-    NAMED_SCOPE("Connector::parseSocketBuffer");
-
-    // Cancel receive time limit
-    setReceiveTimeout();
-
-    if (m_incoming.size() == 0)
-      return false;
-
-    // Grab the beginning of the data buffer.
-    auto start = static_cast<const char *>(m_incoming.data().data());
-    auto len = m_incoming.data().size();
+    HOT_NAMED_SCOPE("Connector::parseSocketBuffer");
 
-    LOG(trace) << "(" << m_server << ":" << m_port << ") " << len
-               << " characters in incomming buffer";
+    LOG_SAMPLED(trace) << "(" << m_server << ":" << m_port << ") " << m_incoming.size()
+                       << " characters in incomming buffer";
 
-    // Scan forward in the buffer for a \n
-    const char *eol = static_cast<const char *>(memchr(start, '\n', len));
-    size_t consumed = (eol == nullptr) ? 0 : eol - start + 1;
-
-    // If there is no end of line, wait for more data.
-    if (consumed == 0)
-    {
-      LOG(trace) << "(" << m_server << ":" << m_port
-                 << ") no eol found, waiting for more characters";
-      return false;
-    }
-    else
-    {
+    bool overflow = m_incoming.lines([this](string_view line) {
       // Check for the condition when the line is blank
       // This is a manual trim right using char* to skip additional work in string
-      size_t size = (consumed == 1) ? 0 : rightTrimmedSize(eol - 1, start);
+      size_t size =
+          line.empty() ? 0 : rightTrimmedSize(line.data() + line.size() - 1, line.data());
 
       // Check for a blank line, just consume and carry on
       if (size == 0)
@@ -374,12 +345,15 @@ namespace mtconnect::source::adapter::shdr {
       else
       {
         // We have a line
-        processLine({start, size});
+        processLine(line.substr(0, size));
       }
-    }
+    });
 
-    m_incoming.consume(consumed);
-    return m_incoming.size() > 0;
+    if (overflow)
+    {
+      LOG(warning) << "(" << m_server << ":" << m_port << ") line is longer than the "
+                   << m_incoming.capacity() << " byte receive buffer, discarding it";
+    }
   }
 
   void Connector::sendCommand(const string &command)
@@ -465,8 +439,9 @@ namespace mtconnect::source::adapter::shdr {
     LOG(error) << "Closing " << m_server << ":" << m_port << " (Local Port:" << m_localPort << ")";
 
     m_heartbeatTimer.cancel();
-    m_receiveTimeout.cancel();
+    m_receiveWatch.reset();
     m_timer.cancel();
+    m_incoming.clear();
 
     if (m_connected)
     {
@@ -22,12 +22,16 @@
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <string_view>
 #include <thread>
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/utilities.hpp"
+#include "receive_buffer.hpp"
+#include "receive_timeout_service.hpp"
 
 #define HEARTBEAT_FREQ 60000
+#define RECEIVE_BUFFER_SIZE (1024 * 1024)
 
 namespace mtconnect::source::adapter::shdr {
   /// @brief Connection to an adapter socket
@@ -57,8 +61,9 @@ namespace mtconnect::source::adapter::shdr {
     /// @return `true` if it can connect
     virtual bool connect();
 
-    // Abstract method to handle what to do with each line of data from Socket
-    virtual void processData(const std::string &data) = 0;
+    /// @brief Abstract method to handle what to do with each line of data from Socket
+    /// @param[in] data the line. It refers to the receive buffer and is only valid during the call.
+    virtual void processData(std::string_view data) = 0;
     virtual void protocolCommand(const std::string &data) = 0;
 
     // Set Reconnect intervals
@@ -81,7 +86,7 @@ namespace mtconnect::source::adapter::shdr {
     std::chrono::milliseconds heartbeatFrequency() const { return m_heartbeatFrequency; }
 
     // Collect data and until it is \n terminated
-    void parseBuffer(const char *buffer);
+    void parseBuffer(std::string_view buffer);
 
     // Send a command to the adapter
     void sendCommand(const std::string &command);
@@ -96,6 +101,11 @@ namespace mtconnect::source::adapter::shdr {
 
     void setRealTime(bool realTime = true) { m_realTime = realTime; }
 
+    /// @brief Set the size of the receive buffer. Must be called before the connector is started.
+    /// @param[in] size the size of the buffer in bytes, lines longer than the buffer are discarded
+    void setReceiveBufferSize(size_t size) { m_incoming = ReceiveBuffer(size); }
+    size_t getReceiveBufferSize() const { return m_incoming.capacity(); }
+
     const auto &getHeartbeatOverride() const { return m_heartbeatOverride; }
 
   protected:
@@ -108,8 +118,8 @@ namespace mtconnect::source::adapter::shdr {
                    const boost::asio::ip::tcp::endpoint &endpoint);
     void writer(boost::system::error_code ec, std::size_t length);
     void reader(boost::system::error_code ec, std::size_t length);
-    bool parseSocketBuffer();
-    void processLine(const std::string &line);
+    void parseSocketBuffer();
+    void processLine(std::string_view line);
     void startHeartbeats(const std::string &buf);
     void heartbeat(boost::system::error_code ec);
     void setReceiveTimeout();
@@ -132,13 +142,15 @@ namespace mtconnect::source::adapter::shdr {
     unsigned int m_port;
     unsigned int m_localPort;
 
-    boost::asio::streambuf m_incoming;
+    ReceiveBuffer m_incoming;
     boost::asio::streambuf m_outgoing;
 
     // Some timeers
     boost::asio::steady_timer m_timer;
     boost::asio::steady_timer m_heartbeatTimer;
-    boost::asio::steady_timer m_receiveTimeout;
+
+    // Receive time limit, checked for all connections by the receive timeout service
+    ReceiveTimeoutService::WatchPtr m_receiveWatch;
 
     // The connected state of this connector
     bool m_connected;
@@ -0,0 +1,162 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace mtconnect::source::adapter::shdr {
+  /// @brief Fixed size ring buffer that the connector reads into and splits into lines
+  ///
+  /// The memory is allocated once, on first use, and never grows. New data is only scanned once
+  /// for newlines with `memchr`. Complete lines are returned as views into the ring. A line that
+  /// wraps around the end of the ring is copied to a scratch buffer so the view is contiguous.
+  ///
+  /// A line that does not fit in the ring is discarded, up to and including its newline, and the
+  /// lines after it are processed normally.
+  class ReceiveBuffer
+  {
+  public:
+    /// @brief Create a buffer
+    /// @param[in] capacity the size of the ring, the longest line is one less than the capacity
+    explicit ReceiveBuffer(size_t capacity) : m_capacity(capacity) {}
+
+    /// @brief the size of the ring
+    size_t capacity() const { return m_capacity; }
+    /// @brief the number of bytes that have not been consumed as lines
+    size_t size() const { return m_size; }
+    /// @brief `true` if the rest of an over-long line is being discarded
+    bool discarding() const { return m_discarding; }
+
+    /// @brief get the free space for the next read
+    /// @return up to two buffers, the second is used when the free space wraps around the ring
+    std::array<boost::asio::mutable_buffer, 2> prepare()
+    {
+      allocate();
+      auto tail = (m_head + m_size) % m_capacity;
+      auto free = m_capacity - m_size;
+      auto first = std::min(free, m_capacity - tail);
+      return {boost::asio::mutable_buffer(m_buffer.get() + tail, first),
+              boost::asio::mutable_buffer(m_buffer.get(), free - first)};
+    }
+    /// @brief add the data read into the buffers from `prepare()`
+    /// @param[in] len the number of bytes read
+    void commit(size_t len) { m_size += std::min(len, m_capacity - m_size); }
+    /// @brief copy data into the free space of the ring
+    /// @param[in] data the data
+    /// @return the number of bytes copied
+    size_t write(std::string_view data)
+    {
+      size_t count = 0;
+      for (auto &buffer : prepare())
+      {
+        auto len = std::min(buffer.size(), data.size() - count);
+        std::memcpy(buffer.data(), data.data() + count, len);
+        count += len;
+      }
+      commit(count);
+      return count;
+    }
+
+    /// @brief Consume all the complete lines
+    /// @param[in] func called with a view of each line, without the newline. The view is only
+    ///                 valid during the call.
+    /// @return `true` if the ring filled without a newline and a line started being discarded
+    template <typename Func>
+    bool lines(Func &&func)
+    {
+      while (m_scanned < m_size)
+      {
+        auto pos = (m_head + m_scanned) % m_capacity;
+        auto len = std::min(m_size - m_scanned, m_capacity - pos);
+        auto start = m_buffer.get() + pos;
+        auto eol = static_cast<const char *>(std::memchr(start, '\n', len));
+        if (eol == nullptr)
+        {
+          m_scanned += len;
+          continue;
+        }
+
+        auto size = m_scanned + (eol - start);
+        if (m_discarding)
+          m_discarding = false;
+        else
+          func(line(size));
+        consume(size + 1);
+      }
+
+      if (m_size == m_capacity)
+      {
+        bool started = !m_discarding;
+        m_discarding = true;
+        consume(m_size);
+        return started;
+      }
+
+      return false;
+    }
+
+    /// @brief discard all the data, used when the connection is closed
+    void clear()
+    {
+      m_head = m_size = m_scanned = 0;
+      m_discarding = false;
+    }
+
+  protected:
+    void allocate()
+    {
+      if (!m_buffer)
+        m_buffer = std::make_unique<char[]>(m_capacity);
+    }
+
+    std::string_view line(size_t size)
+    {
+      auto first = m_capacity - m_head;
+      if (size <= first)
+        return std::string_view(m_buffer.get() + m_head, size);
+
+      m_wrapped.assign(m_buffer.get() + m_head, first);
+      m_wrapped.append(m_buffer.get(), size - first);
+      return m_wrapped;
+    }
+
+    void consume(size_t size)
+    {
+      m_size -= size;
+      m_head = m_size == 0 ? 0 : (m_head + size) % m_capacity;
+      m_scanned = 0;
+    }
+
+  protected:
+    size_t m_capacity;
+    std::unique_ptr<char[]> m_buffer;
+    std::string m_wrapped;
+
+    size_t m_head {0};
+    size_t m_size {0};
+    size_t m_scanned {0};
+    bool m_discarding {false};
+  };
+}  // namespace mtconnect::source::adapter::shdr
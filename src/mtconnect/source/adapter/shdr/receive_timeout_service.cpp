@@ -0,0 +1,122 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "receive_timeout_service.hpp"
+
+#include <vector>
+
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace asio = boost::asio;
+namespace sys = boost::system;
+
+namespace mtconnect::source::adapter::shdr {
+  asio::execution_context::id ReceiveTimeoutService::id;
+
+  ReceiveTimeoutService::ReceiveTimeoutService(asio::io_context &context)
+    : asio::execution_context::service(context), m_timer(context)
+  {}
+
+  ReceiveTimeoutService::WatchPtr ReceiveTimeoutService::watch(milliseconds limit,
+                                                               function<void()> expired)
+  {
+    NAMED_SCOPE("ReceiveTimeoutService::watch");
+
+    auto watch = make_shared<Watch>();
+    watch->m_limit = limit;
+    watch->m_expired = std::move(expired);
+    watch->touch();
+
+    lock_guard<mutex> lock(m_mutex);
+    m_watches.emplace_back(watch);
+    schedule(watch->deadline());
+
+    return watch;
+  }
+
+  void ReceiveTimeoutService::shutdown()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_watches.clear();
+    m_scheduled.reset();
+    m_timer.cancel();
+  }
+
+  void ReceiveTimeoutService::schedule(steady_clock::time_point deadline)
+  {
+    // Only move the timer earlier, a later deadline is picked up when the timer fires
+    if (m_scheduled && *m_scheduled <= deadline)
+      return;
+
+    m_scheduled = deadline;
+    m_timer.expires_at(deadline);
+    m_timer.async_wait([this](sys::error_code ec) { check(ec); });
+  }
+
+  void ReceiveTimeoutService::check(sys::error_code ec)
+  {
+    NAMED_SCOPE("ReceiveTimeoutService::check");
+
+    if (ec)
+    {
+      if (ec != asio::error::operation_aborted)
+        LOG(error) << "Receive timeout: " << ec.message();
+      return;
+    }
+
+    vector<WatchPtr> expired;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_scheduled.reset();
+
+      auto now = steady_clock::now();
+      optional<steady_clock::time_point> next;
+      for (auto it = m_watches.begin(); it != m_watches.end();)
+      {
+        auto watch = it->lock();
+        if (!watch)
+        {
+          it = m_watches.erase(it);
+          continue;
+        }
+
+        auto deadline = watch->deadline();
+        if (deadline <= now)
+        {
+          expired.emplace_back(watch);
+          it = m_watches.erase(it);
+        }
+        else
+        {
+          if (!next || deadline < *next)
+            next = deadline;
+          it++;
+        }
+      }
+
+      if (next)
+        schedule(*next);
+    }
+
+    // Called without the lock so a connector can start a new watch
+    for (auto &watch : expired)
+      watch->m_expired();
+  }
+}  // namespace mtconnect::source::adapter::shdr
@@ -0,0 +1,106 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "mtconnect/config.hpp"
+
+namespace mtconnect::source::adapter::shdr {
+  /// @brief Tracks the receive timeouts of all the connectors on an io context with one timer
+  ///
+  /// A connector records the time it last received data in its watch instead of re-arming a
+  /// timer for every read. The timer only wakes at the earliest deadline of all the watches, so
+  /// a busy connection adds no timer operations or wakeups.
+  ///
+  /// Use `boost::asio::use_service<ReceiveTimeoutService>(context)` to get the service.
+  class AGENT_LIB_API ReceiveTimeoutService : public boost::asio::execution_context::service
+  {
+  public:
+    using key_type = ReceiveTimeoutService;
+    static boost::asio::execution_context::id id;
+
+    /// @brief The receive deadline of a connection
+    class Watch
+    {
+    public:
+      /// @brief record that data was received, extending the deadline
+      void touch()
+      {
+        m_last.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                     std::memory_order_relaxed);
+      }
+      /// @brief get the time without data before the connection times out
+      auto getLimit() const { return m_limit; }
+
+    protected:
+      friend class ReceiveTimeoutService;
+
+      std::chrono::steady_clock::time_point deadline() const
+      {
+        using namespace std::chrono;
+        return steady_clock::time_point(steady_clock::duration(m_last.load())) + m_limit;
+      }
+
+    protected:
+      std::atomic<std::chrono::steady_clock::rep> m_last {0};
+      std::chrono::milliseconds m_limit {0};
+      std::function<void()> m_expired;
+    };
+    using WatchPtr = std::shared_ptr<Watch>;
+
+    /// @brief Create the service for an io context
+    /// @param[in] context the io context
+    explicit ReceiveTimeoutService(boost::asio::io_context &context);
+    ~ReceiveTimeoutService() override = default;
+
+    /// @brief Start watching a connection
+    /// @param[in] limit the time without data before the connection times out
+    /// @param[in] expired called once, on a thread running the io context, when the limit is
+    ///                    exceeded. The watch is no longer checked afterwards.
+    /// @return the watch. The connection is no longer watched once it is released.
+    WatchPtr watch(std::chrono::milliseconds limit, std::function<void()> expired);
+
+    /// @brief the number of watches being checked
+    size_t size() const
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_watches.size();
+    }
+
+  protected:
+    void shutdown() override;
+    void schedule(std::chrono::steady_clock::time_point deadline);
+    void check(boost::system::error_code ec);
+
+  protected:
+    mutable std::mutex m_mutex;
+    boost::asio::steady_timer m_timer;
+    std::optional<std::chrono::steady_clock::time_point> m_scheduled;
+    std::list<std::weak_ptr<Watch>> m_watches;
+  };
+}  // namespace mtconnect::source::adapter::shdr
@@ -74,6 +74,16 @@ namespace mtconnect::source::adapter::shdr {
     if (timeout != m_options.end())
       m_legacyTimeout = get<Seconds>(timeout->second);
 
+    auto bufferSize =
+        ConvertFileSize(m_options, configuration::ReceiveBufferSize, RECEIVE_BUFFER_SIZE);
+    if (bufferSize < 1024)
+    {
+      LOG(warning) << "Receive buffer size set to " << bufferSize
+                   << " bytes, limiting it to 1024 bytes";
+      bufferSize = 1024;
+    }
+    setReceiveBufferSize(size_t(bufferSize));
+
     stringstream url;
     url << "shdr://" << m_server << ':' << m_port;
     m_name = url.str();
@@ -99,6 +109,7 @@ namespace mtconnect::source::adapter::shdr {
     }
 
     m_handler = m_pipeline.makeHandler();
+    captureInput();
     if (m_pipeline.hasContract())
       m_pipeline.build(m_options);
     auto intv = GetOption<Milliseconds>(options, configuration::ReconnectInterval);
@@ -113,9 +124,9 @@ namespace mtconnect::source::adapter::shdr {
     }
   }
 
-  void ShdrAdapter::processData(const string &data)
+  void ShdrAdapter::processData(string_view data)
   {
-    NAMED_SCOPE("ShdrAdapter::processData");
+    HOT_NAMED_SCOPE("ShdrAdapter::processData");
 
     try
     {
@@ -136,11 +147,11 @@ namespace mtconnect::source::adapter::shdr {
       {
         m_body.str("");
         m_body << data.substr(0, multi);
-        m_terminator = data.substr(multi);
+        m_terminator = string(data.substr(multi));
       }
       else
       {
-        forwardData(data);
+        forwardData(string(data));
       }
     }
     catch (std::exception &e)
@@ -76,7 +76,7 @@ namespace mtconnect {
 
       /// @name Source interface
       ///@{
-      void processData(const std::string &data) override;
+      void processData(std::string_view data) override;
       void protocolCommand(const std::string &data) override;
 
       // Method called when connection is lost.
@@ -27,6 +27,8 @@
 #include <cstring>
 #include <ctime>
 #include <date/date.h>
+#include <exception>
+#include <functional>
 #include <list>
 #include <map>
 #include <mutex>
@@ -141,6 +143,41 @@ namespace mtconnect {
     return newPath;
   }
 
+  AGENT_LIB_API void ParallelFor(size_t threads, size_t count,
+                                 const std::function<void(size_t)> &func)
+  {
+    if (threads < 2 || count < 2)
+    {
+      for (size_t i = 0; i < count; i++)
+        func(i);
+      return;
+    }
+
+    vector<exception_ptr> errors(count);
+    boost::asio::thread_pool pool(std::min(threads, count));
+    for (size_t i = 0; i < count; i++)
+    {
+      boost::asio::post(pool, [&func, &errors, i]() {
+        try
+        {
+          func(i);
+        }
+        catch (...)
+        {
+          errors[i] = current_exception();
+        }
+      });
+    }
+    pool.join();
+
+    for (auto &e : errors)
+    {
+      if (e)
+        rethrow_exception(e);
+    }
+  }
+
+
   std::string GetBestHostAddress(boost::asio::io_context &context, bool onlyV4)
   {
     using namespace boost;
@@ -33,6 +33,7 @@
 #include <date/date.h>
 #include <filesystem>
 #include <format>
+#include <functional>
 #include <map>
 #include <mtconnect/version.h>
 #include <optional>
@@ -369,6 +370,17 @@ namespace mtconnect {
   /// @return the modified path prefixed
   AGENT_LIB_API std::string addNamespace(const std::string aPath, const std::string aPrefix);
 
+  /// @brief call a function for each index in a range on a pool of threads
+  ///
+  /// Returns when all the calls are complete. If calls throw, the exception for the lowest index
+  /// is rethrown.
+  ///
+  /// @param[in] threads the number of threads, the calls are made on this thread if less than 2
+  /// @param[in] count the number of indexes
+  /// @param[in] func called with each index from `0` to `count - 1`
+  AGENT_LIB_API void ParallelFor(size_t threads, size_t count,
+                                 const std::function<void(size_t)> &func);
+
   /// @brief removes white space at the beginning of a string
   /// @param[in,out] s the string
   /// @return string with spaces removed
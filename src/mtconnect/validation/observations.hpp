@@ -44,6 +44,24 @@ namespace mtconnect {
       ///       * 0 if not deprecated
       ///       * SCHEMA_VERSION if deprecated
       extern Validation ControlledVocabularies;
+
+      /// @brief The valid values of a controlled vocabulary
+      using Vocabulary = Validation::mapped_type;
+
+      /// @brief Find the controlled vocabulary for an event
+      ///
+      /// Data items resolve their vocabulary once so the observations are validated without
+      /// looking up the event name.
+      /// @param[in] name the observation name
+      /// @return the vocabulary, empty if the values are not controlled, or `nullptr` if the event
+      /// is not known
+      inline const Vocabulary *FindVocabulary(const std::string &name)
+      {
+        auto vocab = ControlledVocabularies.find(name);
+        if (vocab == ControlledVocabularies.end())
+          return nullptr;
+        return &vocab->second;
+      }
     }  // namespace observations
   }    // namespace validation
 }  // namespace mtconnect
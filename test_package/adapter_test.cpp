@@ -24,6 +24,7 @@
 
 #include <boost/asio.hpp>
 
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -32,6 +33,7 @@
 
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/pipeline/pipeline_context.hpp"
+#include "mtconnect/source/adapter/adapter_capture.hpp"
 #include "mtconnect/source/adapter/shdr/shdr_adapter.hpp"
 
 using namespace std;
@@ -147,3 +149,43 @@ TEST(AdapterTest, should_set_heartbeat_override_from_configuration)
   ASSERT_TRUE(over);
   ASSERT_EQ(123ms, *over);
 }
+
+/// @test check that the adapter input is captured and can be read back
+TEST(AdapterTest, should_capture_adapter_input)
+{
+  auto path = std::filesystem::temp_directory_path() / "adapter_capture_test.cap";
+  asio::io_context ioc;
+  ConfigOptions options {{configuration::Host, "localhost"s},
+                         {configuration::Port, 7878},
+                         {configuration::CaptureFile, path.string()}};
+  boost::property_tree::ptree tree;
+  pipeline::PipelineContextPtr context = make_shared<pipeline::PipelineContext>();
+  auto adapter = make_unique<ShdrAdapter>(ioc, context, options, tree);
+
+  adapter->processData("2021-02-01T12:00:00Z|x|100");
+  adapter->processData("* manufacturer: Acme");
+  adapter->processData("2021-02-01T12:00:00Z|@ASSET@|A1|Part|--multiline--XYZ");
+  adapter->processData("<Part assetId='A1'/>");
+  adapter->processData("--multiline--XYZ");
+  adapter.reset();
+
+  CaptureReader reader(path);
+  CaptureRecord record;
+  ASSERT_TRUE(reader.next(record));
+  ASSERT_EQ(CaptureRecord::DATA, record.m_kind);
+  ASSERT_EQ("2021-02-01T12:00:00Z|x|100", record.m_payload);
+
+  ASSERT_TRUE(reader.next(record));
+  ASSERT_EQ(CaptureRecord::COMMAND, record.m_kind);
+  ASSERT_EQ("manufacturer", record.m_topic);
+  ASSERT_EQ("Acme", record.m_payload);
+  auto offset = record.m_offset;
+
+  ASSERT_TRUE(reader.next(record));
+  ASSERT_EQ(CaptureRecord::DATA, record.m_kind);
+  ASSERT_EQ("2021-02-01T12:00:00Z|@ASSET@|A1|Part|\n<Part assetId='A1'/>", record.m_payload);
+  ASSERT_LE(offset, record.m_offset);
+
+  ASSERT_FALSE(reader.next(record));
+  std::filesystem::remove(path);
+}
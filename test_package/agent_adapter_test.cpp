@@ -26,6 +26,10 @@
 #include <stdexcept>
 #include <thread>
 
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <zlib.h>
+
 #include "agent_test_helper.hpp"
 #include "mtconnect/agent.hpp"
 #include "mtconnect/device_model/reference.hpp"
@@ -34,6 +38,7 @@
 #include "mtconnect/printer//xml_printer.hpp"
 #include "mtconnect/source/adapter/adapter.hpp"
 #include "mtconnect/source/adapter/agent_adapter/agent_adapter.hpp"
+#include "mtconnect/source/adapter/agent_adapter/inflater.hpp"
 #include "test_utilities.hpp"
 
 // Registers the fixture into the 'registry'
@@ -759,3 +764,254 @@ TEST_F(AgentAdapterTest, should_create_device_when_option_supplied)
   }
   ASSERT_GE(2, rc);
 }
+
+// Compress data with the gzip wrapper, as a server does for Content-Encoding: gzip
+static string gzip(const string &data)
+{
+  z_stream stream {};
+  deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  string out(deflateBound(&stream, uLong(data.size())), '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = uInt(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(out.data());
+  stream.avail_out = uInt(out.size());
+  deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+// A streams document large enough to span several deflate symbols
+static string streamsDocument(const string &name, int count)
+{
+  string doc = "<MTConnectStreams name=\"" + name + "\">";
+  for (int i = 0; i < count; i++)
+    doc += "<Position dataItemId=\"x" + to_string(i) + "\">" + to_string(i * 7919 % 1000) +
+           "</Position>";
+  doc += "</MTConnectStreams>";
+  return doc;
+}
+
+TEST(InflaterTest, should_inflate_a_body_split_at_every_byte)
+{
+  auto doc = streamsDocument("split", 100);
+  auto compressed = gzip(doc);
+  ASSERT_LT(compressed.size(), doc.size());
+
+  Inflater inflater;
+  string body;
+  for (auto c : compressed)
+  {
+    ASSERT_TRUE(inflater.inflate(string_view(&c, 1), [&body](const char *data, size_t size) {
+      body.append(data, size);
+    }));
+  }
+
+  ASSERT_EQ(doc, body);
+}
+
+TEST(InflaterTest, should_inflate_concatenated_gzip_members)
+{
+  auto first = streamsDocument("first", 20);
+  auto second = streamsDocument("second", 20);
+  auto compressed = gzip(first) + gzip(second);
+
+  Inflater inflater;
+  string body;
+  for (size_t i = 0; i < compressed.size(); i += 5)
+  {
+    ASSERT_TRUE(inflater.inflate(string_view(compressed).substr(i, 5),
+                                 [&body](const char *data, size_t size) {
+                                   body.append(data, size);
+                                 }));
+  }
+
+  ASSERT_EQ(first + second, body);
+}
+
+TEST(InflaterTest, should_fail_if_the_data_is_not_gzip)
+{
+  Inflater inflater;
+  string body;
+  ASSERT_FALSE(inflater.inflate("<MTConnectStreams/>", [&body](const char *data, size_t size) {
+    body.append(data, size);
+  }));
+  ASSERT_TRUE(body.empty());
+}
+
+// Upstream agent that answers every request with a gzip encoded body. The sample request gets a
+// chunked multipart stream where the compressed data is cut into small HTTP chunks, so the
+// chunks split deflate blocks and the compressed multipart boundaries.
+class GzipUpstream
+{
+public:
+  GzipUpstream(asio::io_context &context, list<string> parts, size_t chunkSize)
+    : m_acceptor(context, asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0)),
+      m_parts(std::move(parts)),
+      m_chunkSize(chunkSize)
+  {
+    accept();
+  }
+
+  ~GzipUpstream() { stop(); }
+
+  uint16_t getPort() const { return m_acceptor.local_endpoint().port(); }
+
+  void stop()
+  {
+    boost::system::error_code ec;
+    m_acceptor.close(ec);
+    for (auto &connection : m_connections)
+      connection->m_socket.close(ec);
+  }
+
+  list<string> m_targets;
+  list<string> m_acceptEncodings;
+
+protected:
+  struct Connection
+  {
+    Connection(asio::ip::tcp::socket socket) : m_socket(std::move(socket)) {}
+
+    asio::ip::tcp::socket m_socket;
+    boost::beast::flat_buffer m_buffer;
+    boost::beast::http::request<boost::beast::http::string_body> m_request;
+    string m_response;
+  };
+  using ConnectionPtr = shared_ptr<Connection>;
+
+  void accept()
+  {
+    m_acceptor.async_accept([this](boost::system::error_code ec, asio::ip::tcp::socket socket) {
+      if (ec)
+        return;
+
+      auto connection = make_shared<Connection>(std::move(socket));
+      m_connections.push_back(connection);
+      read(connection);
+      accept();
+    });
+  }
+
+  void read(ConnectionPtr connection)
+  {
+    namespace http = boost::beast::http;
+
+    connection->m_request = {};
+    http::async_read(connection->m_socket, connection->m_buffer, connection->m_request,
+                     [this, connection](boost::system::error_code ec, size_t) {
+                       if (ec)
+                         return;
+
+                       auto &request = connection->m_request;
+                       m_targets.emplace_back(request.target());
+                       m_acceptEncodings.emplace_back(request[http::field::accept_encoding]);
+                       respond(connection);
+                     });
+  }
+
+  void respond(ConnectionPtr connection)
+  {
+    string target(connection->m_request.target());
+    auto &response = connection->m_response;
+    bool stream = target.find("/sample") != string::npos;
+    if (stream)
+    {
+      string body;
+      for (auto &part : m_parts)
+      {
+        body += "--BOUNDARY\r\nContent-type: text/xml\r\nContent-length: " +
+                to_string(part.size()) + "\r\n\r\n" + part + "\r\n";
+      }
+      auto compressed = gzip(body);
+
+      response =
+          "HTTP/1.1 200 OK\r\n"
+          "Content-Type: multipart/x-mixed-replace;boundary=BOUNDARY\r\n"
+          "Content-Encoding: gzip\r\n"
+          "Transfer-Encoding: chunked\r\n\r\n";
+      for (size_t i = 0; i < compressed.size(); i += m_chunkSize)
+      {
+        auto chunk = compressed.substr(i, m_chunkSize);
+        stringstream size;
+        size << hex << chunk.size();
+        response += size.str() + "\r\n" + chunk + "\r\n";
+      }
+    }
+    else
+    {
+      auto doc = target.find("asset") != string::npos ? "<MTConnectAssets/>"s
+                                                      : streamsDocument("current", 10);
+      auto compressed = gzip(doc);
+      response =
+          "HTTP/1.1 200 OK\r\n"
+          "Content-Type: text/xml\r\n"
+          "Content-Encoding: gzip\r\n"
+          "Content-Length: " +
+          to_string(compressed.size()) + "\r\n\r\n" + compressed;
+    }
+
+    asio::async_write(connection->m_socket, asio::buffer(response),
+                      [this, connection, stream](boost::system::error_code ec, size_t) {
+                        // The stream stays open without a final chunk
+                        if (!ec && !stream)
+                          read(connection);
+                      });
+  }
+
+protected:
+  asio::ip::tcp::acceptor m_acceptor;
+  list<string> m_parts;
+  size_t m_chunkSize;
+  list<ConnectionPtr> m_connections;
+};
+
+TEST_F(AgentAdapterTest, should_inflate_a_gzip_chunked_multipart_stream)
+{
+  createAgent();
+
+  list<string> parts {streamsDocument("part1", 30), streamsDocument("part2", 5),
+                      streamsDocument("part3", 60)};
+  GzipUpstream upstream(m_agentTestHelper->m_ioContext, parts, 7);
+  auto adapter = createAdapter(upstream.getPort(), {{configuration::EnableCompression, true}});
+
+  unique_ptr<source::adapter::Handler> handler = make_unique<Handler>();
+
+  bool current = false;
+  list<string> received;
+  handler->m_processData = [&](const string &d, const string &s) {
+    if (d.find("name=\"current\"") != string::npos)
+      current = true;
+    else if (d.find("name=\"part") != string::npos)
+      received.push_back(d);
+  };
+  handler->m_connecting = [&](const string id) {};
+  handler->m_connected = [&](const string id) {};
+
+  adapter->setHandler(handler);
+  adapter->start();
+
+  boost::asio::steady_timer timeout(m_agentTestHelper->m_ioContext, 2s);
+  timeout.async_wait([](boost::system::error_code ec) {
+    if (!ec)
+    {
+      throw runtime_error("test timed out");
+    }
+  });
+
+  while (received.size() < parts.size())
+  {
+    m_agentTestHelper->m_ioContext.run_one();
+  }
+  timeout.cancel();
+
+  ASSERT_TRUE(current);
+  ASSERT_EQ(parts, received);
+
+  ASSERT_FALSE(upstream.m_targets.empty());
+  for (auto &encoding : upstream.m_acceptEncodings)
+    ASSERT_EQ("gzip", encoding);
+
+  upstream.stop();
+  m_agentTestHelper->m_ioContext.run_for(100ms);
+}
@@ -23,6 +23,7 @@
 // Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
 
 #include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -33,6 +34,8 @@
 #include "mtconnect/agent.hpp"
 #include "mtconnect/asset/file_asset.hpp"
 #include "mtconnect/device_model/reference.hpp"
+#include "mtconnect/metrics/metrics.hpp"
+#include "mtconnect/parser/device_cache.hpp"
 #include "mtconnect/printer//xml_printer.hpp"
 #include "mtconnect/source/adapter/adapter.hpp"
 #include "test_utilities.hpp"
@@ -2658,3 +2661,119 @@ TEST_F(AgentTest, should_handle_japanese_characters)
     ASSERT_EQ("ｽﾄﾛｰｸｴﾝﾄﾞ軸あり", fault.at("/value"_json_pointer).get<string>());
   }
 }
+
+TEST_F(AgentTest, should_add_devices_in_file_order_when_loaded_on_multiple_threads)
+{
+  using namespace configuration;
+  ConfigOptions options {{WorkerThreads, 4}};
+  auto agent = m_agentTestHelper->createAgent("/samples/two_devices.xml", 8, 4, "2.2", 25, false,
+                                              true, options);
+
+  list<string> names;
+  for (auto &device : agent->getDevices())
+    names.emplace_back(*device->getComponentName());
+  ASSERT_EQ((list<string> {"Agent", "Device1", "Device2"}), names);
+
+  auto device = agent->findDeviceByUUIDorName("Device2");
+  ASSERT_TRUE(device);
+  ASSERT_TRUE(device->getAssetChanged());
+  ASSERT_TRUE(device->hasProperty("hash"));
+}
+
+TEST_F(AgentTest, should_recreate_devices_from_the_device_cache)
+{
+  using namespace configuration;
+  namespace fs = std::filesystem;
+
+  auto dir = fs::temp_directory_path() / "agent_device_cache_test";
+  fs::remove_all(dir);
+  ConfigOptions options {{DeviceCachePath, dir.string()}, {WorkerThreads, 2}};
+
+  auto load = [&]() {
+    auto agent = m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.2", 25, false,
+                                                true, options);
+    auto printer = dynamic_cast<printer::XmlPrinter *>(agent->getPrinter("xml"));
+    list<string> devices;
+    for (auto &device : agent->getDevices())
+      devices.emplace_back(printer->printDevice(device) + device->get<string>("hash"));
+    return devices;
+  };
+
+  auto parsed = load();
+  ASSERT_TRUE(fs::exists(dir / "test_config.xml.mtdc"));
+
+  // The cache holds the devices from the file, without the agent device
+  auto model = parser::DeviceCache(dir).load(TEST_RESOURCE_DIR "/samples/test_config.xml");
+  ASSERT_TRUE(model);
+  ASSERT_EQ(1, model->m_devices.size());
+  ASSERT_EQ("LinuxCNC", *model->m_devices.front()->getComponentName());
+
+  auto cached = load();
+  ASSERT_EQ(parsed, cached);
+
+  fs::remove_all(dir);
+}
+
+TEST_F(AgentTest, should_parse_the_devices_file_if_the_device_cache_is_corrupt)
+{
+  using namespace configuration;
+  namespace fs = std::filesystem;
+
+  auto dir = fs::temp_directory_path() / "agent_corrupt_device_cache_test";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  {
+    ofstream out(dir / "test_config.xml.mtdc", ios::binary);
+    out << "garbage";
+  }
+
+  ConfigOptions options {{DeviceCachePath, dir.string()}};
+  auto agent = m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.2", 25, false,
+                                              true, options);
+  ASSERT_TRUE(agent->findDeviceByUUIDorName("LinuxCNC"));
+
+  // The cache is rewritten from the parsed devices
+  ASSERT_TRUE(parser::DeviceCache(dir).load(TEST_RESOURCE_DIR "/samples/test_config.xml"));
+
+  fs::remove_all(dir);
+}
+
+TEST_F(AgentTest, should_report_render_times_on_the_metrics_route)
+{
+  using namespace configuration;
+  m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, false, true,
+                                 {{EnableMetrics, true}, {JsonVersion, 2}});
+
+  // Render a document in each format
+  {
+    PARSE_XML_RESPONSE("/probe");
+  }
+  {
+    PARSE_JSON_RESPONSE("/probe");
+  }
+
+  {
+    PARSE_TEXT_RESPONSE("/metrics");
+    auto session = m_agentTestHelper->session();
+    ASSERT_EQ(status::ok, session->m_code);
+    ASSERT_EQ("text/plain; version=0.0.4; charset=utf-8", session->m_mimeType);
+
+    const auto &body = session->m_body;
+    const string count = "mtconnect_render_seconds_count{document=\"MTConnectDevices\",format=";
+    ASSERT_NE(string::npos, body.find("# TYPE mtconnect_render_seconds summary\n"));
+    ASSERT_NE(string::npos, body.find(count + "\"xml\"} "));
+    ASSERT_NE(string::npos, body.find(count + "\"json\"} "));
+  }
+
+  metrics::Registry::setEnabled(false);
+}
+
+TEST_F(AgentTest, should_not_have_a_metrics_route_when_metrics_are_disabled)
+{
+  ASSERT_FALSE(metrics::Registry::isEnabled());
+
+  {
+    PARSE_TEXT_RESPONSE("/metrics");
+    ASSERT_EQ(status::not_found, m_agentTestHelper->session()->m_code);
+  }
+}
@@ -332,3 +332,33 @@ TEST_F(AssetBufferTest, verify_asset_counts_with_removal)
   ASSERT_EQ(6, counts10["Asset2"]);
   ASSERT_EQ(2, counts10["Asset3"]);
 }
+
+TEST_F(AssetBufferTest, should_keep_counts_when_assets_change_type_and_device)
+{
+  ErrorList errors;
+  m_assetBuffer->addAsset(makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z", errors));
+  m_assetBuffer->addAsset(makeAsset("Asset1", "A2", "D1", "2020-12-01T12:00:00Z", errors));
+  m_assetBuffer->removeAsset("A1");
+  ASSERT_EQ(0, errors.size());
+
+  m_assetBuffer->addAsset(makeAsset("Asset2", "A1", "D2", "2020-12-01T12:00:00Z", errors));
+  ASSERT_EQ(2, m_assetBuffer->getCount());
+  ASSERT_EQ(1, m_assetBuffer->getCountForDeviceAndType("D1", "Asset1"));
+  ASSERT_EQ(1, m_assetBuffer->getCountForDeviceAndType("D2", "Asset2"));
+  ASSERT_EQ(1, m_assetBuffer->getCountsByTypeForDevice("D1").size());
+
+  m_assetBuffer->removeAsset("A2");
+  for (int i = 3; i <= 11; i++)
+    m_assetBuffer->addAsset(
+        makeAsset("Asset3", "A" + to_string(i), "D3", "2020-12-01T12:00:00Z", errors));
+
+  ASSERT_EQ(10, m_assetBuffer->getCount());
+  ASSERT_EQ(10, m_assetBuffer->getCount(false));
+  ASSERT_EQ(0, m_assetBuffer->getCountForDevice("D1", false));
+  ASSERT_TRUE(m_assetBuffer->getCountsByTypeForDevice("D1", false).empty());
+
+  auto counts = m_assetBuffer->getCountsByType();
+  ASSERT_EQ(2, counts.size());
+  ASSERT_EQ(1, counts["Asset2"]);
+  ASSERT_EQ(9, counts["Asset3"]);
+}
@@ -196,3 +196,42 @@ TEST_F(AssetHashTest, hash_should_change_when_doc_changes)
     ASSERT_XML_PATH_EQUAL(doc, "//m:DeviceStream//m:AssetChanged@hash", hash2.c_str());
   }
 }
+
+TEST_F(AssetHashTest, should_not_publish_unchanged_assets)
+{
+  addAdapter();
+  auto agent = m_agentTestHelper->getAgent();
+  auto &buffer = agent->getCircularBuffer();
+  auto changed = m_device->getAssetChanged();
+
+  const auto body = R"(|@ASSET@|P1|FakeAsset|--multiline--AAAA
+<FakeAsset assetId='P1'>
+  <PartXXX>TEST 1</PartXXX>
+</FakeAsset>
+--multiline--AAAA
+)";
+
+  m_agentTestHelper->m_adapter->parseBuffer("2021-02-01T12:00:00Z"s + body);
+  auto first = buffer.getLatest().getObservation(changed->getId());
+  ASSERT_TRUE(first);
+  auto sequence = buffer.getSequence();
+
+  m_agentTestHelper->m_adapter->parseBuffer("2023-02-01T12:00:00Z"s + body);
+  ASSERT_EQ(sequence, buffer.getSequence());
+  ASSERT_EQ(first, buffer.getLatest().getObservation(changed->getId()));
+
+  {
+    PARSE_XML_RESPONSE("/asset/P1");
+    ASSERT_XML_PATH_EQUAL(doc, "//m:FakeAsset@timestamp", "2023-02-01T12:00:00Z");
+  }
+
+  m_agentTestHelper->m_adapter->parseBuffer(
+      R"(2023-02-02T12:00:00Z|@ASSET@|P1|FakeAsset|--multiline--AAAA
+<FakeAsset assetId='P1'>
+  <PartXXX>TEST 2</PartXXX>
+</FakeAsset>
+--multiline--AAAA
+)");
+  ASSERT_LT(sequence, buffer.getSequence());
+  ASSERT_NE(first, buffer.getLatest().getObservation(changed->getId()));
+}
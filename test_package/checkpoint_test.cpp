@@ -424,10 +424,13 @@ TEST_F(CheckpointTest, ConditionChaining)
   auto p3 = observation::Observation::make(m_dataItem1, warning3, time, errors);
   m_checkpoint->addObservation(p3);
   ASSERT_EQ(2, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
+  ASSERT_EQ(1, p2.use_count());
   ASSERT_EQ(2, p1.use_count());
 
-  ASSERT_EQ(p2, dynamic_pointer_cast<Condition>(p3)->getPrev());
+  // p2 has its own active conditions, so a copy without them is shared
+  ASSERT_NE(p2, Cond(p3)->getPrev());
+  ASSERT_EQ(Cond(p2)->getCode(), Cond(p3)->getPrev()->getCode());
+  ASSERT_TRUE(Cond(p3)->getPrev()->getActive().empty());
   ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
   ASSERT_FALSE(dynamic_pointer_cast<Condition>(p1)->getPrev());
 
@@ -441,18 +444,25 @@ TEST_F(CheckpointTest, ConditionChaining)
   m_checkpoint->addObservation(p4);
   ASSERT_EQ(2, p4.use_count());
   ASSERT_EQ(1, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
+  ASSERT_EQ(1, p2.use_count());
   ASSERT_EQ(2, p1.use_count());
 
-  // Should have been deep copyied
+  // The other active conditions do not carry their own state
   ASSERT_NE(p3, Cond(p4)->getPrev());
-
-  // Codes should still match
   ASSERT_EQ(Cond(p3)->getCode(), Cond(p4)->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev().use_count());
-  ASSERT_EQ(Cond(p1)->getCode(), Cond(p4)->getPrev()->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev()->getPrev().use_count());
-  ASSERT_FALSE(Cond(p4)->getPrev()->getPrev()->getPrev());
+
+  {
+    ConditionList active;
+    Cond(p4)->getConditionList(active);
+    ASSERT_EQ(3, active.size());
+    auto it = active.begin();
+    ASSERT_EQ(p1, *it++);
+    ASSERT_EQ("CODE3", (*it++)->getCode());
+    ASSERT_EQ(p4, *it++);
+    for (auto &c : active)
+      if (c != p4)
+        ASSERT_TRUE(c->getActive().empty());
+  }
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -469,8 +479,8 @@ TEST_F(CheckpointTest, ConditionChaining)
   ASSERT_EQ(2, p7.use_count());
   ASSERT_NE(p5, p7);
   ASSERT_EQ(std::string("CODE3"), Cond(p7)->getCode());
-  ASSERT_EQ(std::string("CODE1"), Cond(p7)->getPrev()->getCode());
-  ASSERT_FALSE(Cond(p7)->getPrev()->getPrev());
+  ASSERT_EQ(p1, Cond(p7)->getPrev());
+  ASSERT_EQ(1, Cond(p7)->getActive().size());
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -641,10 +651,13 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   auto p3 = observation::Observation::make(m_dataItem1, warning3, time, errors);
   m_checkpoint->addObservation(p3);
   ASSERT_EQ(2, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
+  ASSERT_EQ(1, p2.use_count());
   ASSERT_EQ(2, p1.use_count());
 
-  ASSERT_EQ(p2, dynamic_pointer_cast<Condition>(p3)->getPrev());
+  // p2 has its own active conditions, so a copy without them is shared
+  ASSERT_NE(p2, Cond(p3)->getPrev());
+  ASSERT_EQ(Cond(p2)->getCode(), Cond(p3)->getPrev()->getCode());
+  ASSERT_TRUE(Cond(p3)->getPrev()->getActive().empty());
   ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
   ASSERT_FALSE(dynamic_pointer_cast<Condition>(p1)->getPrev());
 
@@ -658,18 +671,25 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   m_checkpoint->addObservation(p4);
   ASSERT_EQ(2, p4.use_count());
   ASSERT_EQ(1, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
+  ASSERT_EQ(1, p2.use_count());
   ASSERT_EQ(2, p1.use_count());
 
-  // Should have been deep copyied
+  // The other active conditions do not carry their own state
   ASSERT_NE(p3, Cond(p4)->getPrev());
-
-  // Codes should still match
   ASSERT_EQ(Cond(p3)->getCode(), Cond(p4)->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev().use_count());
-  ASSERT_EQ(Cond(p1)->getCode(), Cond(p4)->getPrev()->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev()->getPrev().use_count());
-  ASSERT_FALSE(Cond(p4)->getPrev()->getPrev()->getPrev());
+
+  {
+    ConditionList active;
+    Cond(p4)->getConditionList(active);
+    ASSERT_EQ(3, active.size());
+    auto it = active.begin();
+    ASSERT_EQ(p1, *it++);
+    ASSERT_EQ("CODE3", (*it++)->getCode());
+    ASSERT_EQ(p4, *it++);
+    for (auto &c : active)
+      if (c != p4)
+        ASSERT_TRUE(c->getActive().empty());
+  }
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -686,8 +706,8 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   ASSERT_EQ(2, p7.use_count());
   ASSERT_NE(p5, p7);
   ASSERT_EQ(std::string("CODE3"), Cond(p7)->getCode());
-  ASSERT_EQ(std::string("CODE1"), Cond(p7)->getPrev()->getCode());
-  ASSERT_FALSE(Cond(p7)->getPrev()->getPrev());
+  ASSERT_EQ(p1, Cond(p7)->getPrev());
+  ASSERT_EQ(1, Cond(p7)->getActive().size());
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -703,3 +723,61 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   m_checkpoint->getObservations(list);
   ASSERT_EQ(1, (int)list.size());
 }
+
+TEST_F(CheckpointTest, should_share_active_conditions_between_checkpoints)
+{
+  entity::ErrorList errors;
+  Timestamp time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h + 1min;
+  auto condition = [&](const string &level, const string &code) {
+    return observation::Observation::make(m_dataItem1, {{"level", level}, {"nativeCode", code}},
+                                          time, errors);
+  };
+
+  vector<ObservationPtr> faults;
+  for (int i = 0; i < 40; i++)
+  {
+    faults.push_back(condition("FAULT"s, "CODE" + to_string(i)));
+    m_checkpoint->addObservation(faults.back());
+  }
+
+  Checkpoint copy(*m_checkpoint);
+
+  // Replace one active condition and clear another
+  auto warning = condition("WARNING"s, "CODE5");
+  m_checkpoint->addObservation(warning);
+  m_checkpoint->addObservation(condition("NORMAL"s, "CODE20"));
+
+  // The other active conditions are shared with the copy, only the replaced and cleared
+  // conditions and the most recent condition differ
+  ObservationList list, copied;
+  m_checkpoint->getObservations(list);
+  copy.getObservations(copied);
+  map<string, ObservationPtr> shared;
+  for (auto &obs : copied)
+    shared[Cond(obs)->getCode()] = obs;
+
+  // The most recent first, in the order they were activated
+  ASSERT_EQ(39, list.size());
+  auto it = list.begin();
+  auto first = Cond(*it++);
+  ASSERT_EQ("CODE5", first->getCode());
+  ASSERT_EQ(Condition::WARNING, first->getLevel());
+  for (int i = 39; i >= 0; i--)
+  {
+    if (i == 5 || i == 20)
+      continue;
+    auto code = "CODE" + to_string(i);
+    auto cond = Cond(*it++);
+    ASSERT_EQ(code, cond->getCode());
+    ASSERT_TRUE(cond->getActive().empty()) << code;
+    if (i < 39)
+      ASSERT_EQ(shared[code], cond) << code;
+  }
+
+  // The copy still has the original conditions
+  list.clear();
+  copy.getObservations(list);
+  ASSERT_EQ(40, list.size());
+  ASSERT_EQ(faults[39], list.front());
+  ASSERT_EQ(faults[0], list.back());
+}
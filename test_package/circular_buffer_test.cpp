@@ -19,9 +19,15 @@
 #include <gtest/gtest.h>
 // Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
 #include "agent_test_helper.hpp"
 #include "mtconnect/buffer/checkpoint.hpp"
 #include "mtconnect/buffer/circular_buffer.hpp"
+#include "mtconnect/buffer/observation_journal.hpp"
 
 using namespace std;
 using namespace mtconnect;
@@ -125,6 +131,71 @@ protected:
     m_circularBuffer->addToBuffer(p6);
   }
 
+  // Write the observations from addSomeObservations() to a journal in a new directory
+  void writeJournal(const std::filesystem::path &dir)
+  {
+    std::filesystem::remove_all(dir);
+    auto journal =
+        make_shared<ObservationJournal>(dir, 64 * 1024, 10ms, m_circularBuffer->getBufferSize());
+    journal->start(12345);
+    m_circularBuffer->setJournal(journal);
+    addSomeObservations();
+    journal->stop();
+    m_circularBuffer->setJournal(nullptr);
+  }
+
+  optional<ObservationJournal::Recovery> recoverJournal(const std::filesystem::path &dir)
+  {
+    ObservationJournal journal(dir, 64 * 1024, 10ms, m_circularBuffer->getBufferSize());
+    return journal.recover([this](const string &id) -> DataItemPtr {
+      if (id == m_dataItem1->getId())
+        return m_dataItem1;
+      else if (id == m_dataItem2->getId())
+        return m_dataItem2;
+      return nullptr;
+    });
+  }
+
+  static vector<std::filesystem::path> journalSegments(const std::filesystem::path &dir)
+  {
+    vector<std::filesystem::path> segments;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+      if (entry.path().extension() == ".mtj")
+        segments.push_back(entry.path());
+    sort(segments.begin(), segments.end());
+    return segments;
+  }
+
+  static string readFile(const std::filesystem::path &path)
+  {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+
+  static void writeFile(const std::filesystem::path &path, const string &data)
+  {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(data.data(), data.size());
+  }
+
+  // Find the offset of the last record in a segment. Records are a 32 bit length and CRC
+  // followed by the payload, and a zero length ends the segment.
+  static size_t lastRecord(const string &data)
+  {
+    uint32_t offset, length;
+    memcpy(&offset, data.data() + 12, sizeof(offset));
+    size_t last = 0;
+    while (offset + 8 <= data.size())
+    {
+      memcpy(&length, data.data() + offset, sizeof(length));
+      if (length == 0)
+        break;
+      last = offset;
+      offset += 8 + length;
+    }
+    return last;
+  }
+
   std::unique_ptr<CircularBuffer> m_circularBuffer;
   DataItemPtr m_dataItem1;
   DataItemPtr m_dataItem2;
@@ -191,3 +262,215 @@ TEST_F(CircularBufferTest, should_skip_orphaned_observations)
   ASSERT_EQ(7, end);
   ASSERT_TRUE(eob);
 }
+
+TEST_F(CircularBufferTest, should_restore_observations_from_journal)
+{
+  auto dir = std::filesystem::temp_directory_path() / "circular_buffer_journal_test";
+  std::filesystem::remove_all(dir);
+
+  {
+    auto journal =
+        make_shared<ObservationJournal>(dir, 64 * 1024, 10ms, m_circularBuffer->getBufferSize());
+    journal->start(12345);
+    m_circularBuffer->setJournal(journal);
+    addSomeObservations();
+    journal->stop();
+  }
+
+  ObservationJournal journal(dir, 64 * 1024, 10ms, m_circularBuffer->getBufferSize());
+  auto recovery = journal.recover([this](const string &id) -> DataItemPtr {
+    if (id == m_dataItem1->getId())
+      return m_dataItem1;
+    else if (id == m_dataItem2->getId())
+      return m_dataItem2;
+    return nullptr;
+  });
+
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(12345, recovery->m_instanceId);
+  ASSERT_EQ(0, recovery->m_checkpointSequence);
+  ASSERT_EQ(6, recovery->m_observations.size());
+
+  CircularBuffer restored(4, 4);
+  restored.restore(*recovery);
+
+  ASSERT_EQ(7, restored.getSequence());
+  ASSERT_EQ(1, restored.getFirstSequence());
+
+  auto cond = dynamic_pointer_cast<Condition>(restored.getLatest().getObservation("1"));
+  ASSERT_TRUE(cond);
+  ASSERT_EQ(4, cond->getSequence());
+  ASSERT_EQ(Condition::WARNING, cond->getLevel());
+  ASSERT_EQ("CODE1", cond->getCode());
+  ASSERT_FALSE(cond->getPrev());
+
+  auto sample = restored.getFromBuffer(6);
+  ASSERT_TRUE(sample);
+  ASSERT_EQ(m_dataItem2, sample->getDataItem());
+  ASSERT_EQ(123.0, sample->getValue<double>());
+  ASSERT_EQ(6, m_dataItem2->getLatestSequence());
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_F(CircularBufferTest, should_stop_recovery_at_a_torn_journal_record)
+{
+  auto dir = std::filesystem::temp_directory_path() / "circular_buffer_torn_journal_test";
+  writeJournal(dir);
+
+  auto segments = journalSegments(dir);
+  ASSERT_EQ(1, segments.size());
+  auto data = readFile(segments.front());
+  auto last = lastRecord(data);
+  ASSERT_LT(0, last);
+
+  // The file ends in the middle of the last observation
+  std::filesystem::resize_file(segments.front(), last + 8 + 4);
+
+  auto recovery = recoverJournal(dir);
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(5, recovery->m_observations.size());
+  ASSERT_EQ(5, recovery->m_observations.back()->getSequence());
+
+  CircularBuffer restored(4, 4);
+  restored.restore(*recovery);
+  ASSERT_EQ(6, restored.getSequence());
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_F(CircularBufferTest, should_stop_recovery_at_a_journal_record_with_a_bad_crc)
+{
+  auto dir = std::filesystem::temp_directory_path() / "circular_buffer_crc_journal_test";
+  writeJournal(dir);
+
+  auto segments = journalSegments(dir);
+  ASSERT_EQ(1, segments.size());
+  auto data = readFile(segments.front());
+  auto last = lastRecord(data);
+  ASSERT_LT(0, last);
+
+  // Damage the payload of the last observation, the length is still valid
+  data[last + 8 + 2] ^= 0x55;
+  writeFile(segments.front(), data);
+
+  auto recovery = recoverJournal(dir);
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(5, recovery->m_observations.size());
+  ASSERT_EQ(5, recovery->m_observations.back()->getSequence());
+
+  // Damage the fourth observation, only the three before it are recovered
+  auto fourth = lastRecord(data.substr(0, lastRecord(data.substr(0, last))));
+  data[fourth + 8 + 2] ^= 0x55;
+  writeFile(segments.front(), data);
+
+  recovery = recoverJournal(dir);
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(3, recovery->m_observations.size());
+  ASSERT_EQ(3, recovery->m_observations.back()->getSequence());
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_F(CircularBufferTest, should_recover_a_journal_with_several_segments)
+{
+  auto dir = std::filesystem::temp_directory_path() / "circular_buffer_segment_journal_test";
+  std::filesystem::remove_all(dir);
+
+  // Retain all the observations so none of the segments are removed
+  constexpr int count = 4000;
+  CircularBuffer buffer(13, 1000);
+  auto journal = make_shared<ObservationJournal>(dir, 64 * 1024, 10ms, count);
+  journal->start(12345);
+  buffer.setJournal(journal);
+
+  entity::ErrorList errors;
+  auto time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h;
+  for (int i = 1; i <= count; i++)
+  {
+    auto obs = Observation::make(m_dataItem2, {{"VALUE", double(i)}}, time + i * 1ms, errors);
+    buffer.addToBuffer(obs);
+
+    // Let the writer catch up so it asks for checkpoints as the segments fill
+    if (i % 100 == 0)
+      this_thread::sleep_for(20ms);
+  }
+  journal->stop();
+  buffer.setJournal(nullptr);
+
+  auto segments = journalSegments(dir);
+  ASSERT_LE(3, segments.size());
+
+  auto recovery = recoverJournal(dir);
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(12345, recovery->m_instanceId);
+  ASSERT_EQ(0, recovery->m_checkpointSequence);
+  ASSERT_EQ(count, recovery->m_observations.size());
+
+  SequenceNumber_t expected = 1;
+  for (const auto &obs : recovery->m_observations)
+  {
+    ASSERT_EQ(expected, obs->getSequence());
+    ASSERT_EQ(double(expected), obs->getValue<double>());
+    expected++;
+  }
+
+  // A torn record in the last segment only loses that record. If the last segment only has
+  // its checkpoint, the segment is ignored and the previous segment still has every observation.
+  auto data = readFile(segments.back());
+  auto last = lastRecord(data);
+  int lost = data[last + 8] == 1 ? 1 : 0;
+  std::filesystem::resize_file(segments.back(), last + 8 + 4);
+
+  recovery = recoverJournal(dir);
+  ASSERT_TRUE(recovery);
+  ASSERT_EQ(count - lost, recovery->m_observations.size());
+  ASSERT_EQ(count - lost, recovery->m_observations.back()->getSequence());
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_F(CircularBufferTest, should_release_cleared_conditions)
+{
+  entity::ErrorList errors;
+  Timestamp time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h;
+  auto condition = [&](const string &level, int code) {
+    auto obs = Observation::make(
+        m_dataItem1, {{"level", level}, {"nativeCode", "CODE" + to_string(code)}}, time, errors);
+    m_circularBuffer->addToBuffer(obs);
+    return obs;
+  };
+
+  // Overlapping alarms where the oldest is cleared and a new one is added
+  auto first = condition("FAULT"s, 0);
+  condition("FAULT"s, 1);
+  condition("FAULT"s, 2);
+  ObservationPtr cleared;
+  for (int i = 0; i < 20; i++)
+  {
+    condition("NORMAL"s, i);
+    auto obs = condition("FAULT"s, i + 3);
+    if (i == 10)
+      cleared = obs;
+  }
+
+  // Move all the conditions out of the buffer and its checkpoints
+  for (int i = 0; i < 40; i++)
+  {
+    auto obs = Observation::make(m_dataItem2, {{"VALUE", "123"s}}, time, errors);
+    m_circularBuffer->addToBuffer(obs);
+  }
+
+  ASSERT_EQ(1, first.use_count());
+  ASSERT_EQ(1, cleared.use_count());
+
+  auto cond = dynamic_pointer_cast<Condition>(m_circularBuffer->getLatest().getObservation("1"));
+  ASSERT_TRUE(cond);
+  ConditionList active;
+  cond->getConditionList(active);
+  ASSERT_EQ(3, active.size());
+  auto it = active.begin();
+  ASSERT_EQ("CODE20", (*it++)->getCode());
+  ASSERT_EQ("CODE21", (*it++)->getCode());
+  ASSERT_EQ("CODE22", (*it++)->getCode());
+}
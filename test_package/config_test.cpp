@@ -998,6 +998,48 @@ logger_config {
     EXPECT_EQ(severity_level::fatal, m_config->getLogLevel());
   }
 
+  TEST_F(ConfigTest, log_should_configure_hot_path_scopes_and_trace_sampling)
+  {
+    using namespace boost::log::trivial;
+
+    auto root {createTempDirectory("log_hot")};
+    m_config->setConfigPath(root);
+    m_config->setDebug(false);
+
+    string str = "Devices = " TEST_RESOURCE_DIR
+                 "/samples/min_config.xml"
+                 R"(
+logger_config {
+   level = warning
+   hot_path_scopes = false
+   trace_sampling = 100
+}
+)";
+
+    m_config->loadConfig(str);
+
+    EXPECT_EQ(severity_level::warning, logging::MinimumLevel.load());
+    EXPECT_FALSE(logging::HotPathScopes.load());
+    EXPECT_EQ(100u, logging::SampleInterval.load());
+
+    EXPECT_FALSE(logging::Enabled(severity_level::info));
+    EXPECT_TRUE(logging::Enabled(severity_level::error));
+
+    logging::Sampler sampler;
+    EXPECT_TRUE(sampler(severity_level::trace));
+    for (int i = 1; i < 100; i++)
+      EXPECT_FALSE(sampler(severity_level::trace));
+    EXPECT_TRUE(sampler(severity_level::trace));
+    EXPECT_TRUE(sampler(severity_level::warning));
+
+    m_config->setLoggingLevel("info");
+    EXPECT_TRUE(logging::Enabled(severity_level::info));
+
+    logging::MinimumLevel = severity_level::trace;
+    logging::HotPathScopes = true;
+    logging::SampleInterval = 0;
+  }
+
   TEST_F(ConfigTest, log_should_rotate_log_file_when_it_reaches_limit)
   {
     auto root {createTempDirectory("log_7")};
@@ -76,10 +76,10 @@ public:
     return Connector::start();
   }
 
-  void processData(const std::string &data) override
+  void processData(std::string_view data) override
   {
     if (data[0] == '*')
-      protocolCommand(data);
+      protocolCommand(std::string(data));
     else
     {
       m_data = data;
@@ -593,3 +593,65 @@ TEST_F(ConnectorTest, should_override_adapter_heartbeat_in_pong)
   ASSERT_TRUE(m_connector->heartbeats());
   ASSERT_EQ(std::chrono::milliseconds {123}, m_connector->heartbeatFrequency());
 }
+
+/// @test the receive timeouts of all the connections are checked with one timer
+TEST_F(ConnectorTest, should_check_the_receive_timeouts_of_all_connections_with_one_service)
+{
+  auto &service = asio::use_service<ReceiveTimeoutService>(m_context);
+
+  int fast = 0, slow = 0;
+  auto fastWatch = service.watch(100ms, [&]() { fast++; });
+  auto slowWatch = service.watch(300ms, [&]() { slow++; });
+  auto released = service.watch(100ms, []() { FAIL() << "A released watch expired"; });
+  released.reset();
+
+  m_context.run_for(200ms);
+  ASSERT_EQ(1, fast);
+  ASSERT_EQ(0, slow);
+  ASSERT_EQ(1, service.size());
+
+  // Receiving data extends the deadline without touching the timer
+  for (int i = 0; i < 4; i++)
+  {
+    slowWatch->touch();
+    m_context.run_for(100ms);
+  }
+  ASSERT_EQ(0, slow);
+
+  m_context.run_for(400ms);
+  ASSERT_EQ(1, slow);
+  ASSERT_EQ(1, fast);
+  ASSERT_EQ(0, service.size());
+}
+
+/// @test lines that wrap around the end of the receive buffer are returned whole
+TEST_F(ConnectorTest, should_split_lines_that_wrap_around_the_receive_buffer)
+{
+  m_connector->setReceiveBufferSize(16);
+  m_connector->m_list.clear();
+
+  m_connector->parseBuffer("abcdefghij\nklm");
+  m_connector->parseBuffer("nopqrst\nuvw\n");
+
+  ASSERT_EQ((size_t)3, m_connector->m_list.size());
+  ASSERT_EQ((string) "abcdefghij", m_connector->m_list[0]);
+  ASSERT_EQ((string) "klmnopqrst", m_connector->m_list[1]);
+  ASSERT_EQ((string) "uvw", m_connector->m_list[2]);
+}
+
+/// @test a line longer than the receive buffer is discarded and the following lines are kept
+TEST_F(ConnectorTest, should_discard_lines_longer_than_the_receive_buffer)
+{
+  m_connector->setReceiveBufferSize(16);
+  m_connector->m_list.clear();
+
+  m_connector->parseBuffer("first\nthis line is much longer than the buffer");
+  m_connector->parseBuffer(" and continues in the next read\nsecond\n");
+  m_connector->parseBuffer("fifteen bytes!!\nthird\n");
+
+  ASSERT_EQ((size_t)4, m_connector->m_list.size());
+  ASSERT_EQ((string) "first", m_connector->m_list[0]);
+  ASSERT_EQ((string) "second", m_connector->m_list[1]);
+  ASSERT_EQ((string) "fifteen bytes!!", m_connector->m_list[2]);
+  ASSERT_EQ((string) "third", m_connector->m_list[3]);
+}
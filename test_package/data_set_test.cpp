@@ -816,3 +816,71 @@ TEST_F(DataSetTest, JsonCurrent)
     ASSERT_EQ(string("cow"), offsets.at("/VariableDataSet/value/d"_json_pointer).get<string>());
   }
 }
+
+TEST_F(DataSetTest, should_share_unchanged_entries_when_merging)
+{
+  ErrorList errors;
+  auto time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h + 1min;
+
+  string value;
+  for (int i = 0; i < 1000; i++)
+    value.append("k" + to_string(i) + "=" + to_string(i) + " ");
+
+  auto ce = Observation::make(m_dataItem1, Properties {{"VALUE", value}}, time, errors);
+  ASSERT_EQ(0, errors.size());
+  m_checkpoint->addObservation(ce);
+  auto first = m_checkpoint->getObservation("v1");
+
+  auto ce2 = Observation::make(m_dataItem1, Properties {{"VALUE", "k500=-1 k10"s}}, time, errors);
+  ASSERT_EQ(0, errors.size());
+  m_checkpoint->addObservation(ce2);
+  auto second = m_checkpoint->getObservation("v1");
+
+  const auto &set1 = first->getValue<DataSet>();
+  const auto &set2 = second->getValue<DataSet>();
+  ASSERT_EQ(1000, set1.size());
+  ASSERT_EQ(999, set2.size());
+  ASSERT_EQ(999, second->get<int64_t>("count"));
+
+  // The earlier observation is not changed by the merge
+  ASSERT_EQ(500, get<int64_t>(set1.find("k500"_E)->m_value));
+  ASSERT_NE(set1.end(), set1.find("k10"_E));
+  ASSERT_EQ(-1, get<int64_t>(set2.find("k500"_E)->m_value));
+  ASSERT_EQ(set2.end(), set2.find("k10"_E));
+
+  // Unchanged entries are the same objects in both data sets
+  ASSERT_EQ(&*set1.find("k42"_E), &*set2.find("k42"_E));
+  ASSERT_EQ(&*set1.find("k999"_E), &*set2.find("k999"_E));
+
+  // Both are in key order
+  ASSERT_TRUE(is_sorted(set1.begin(), set1.end()));
+  ASSERT_TRUE(is_sorted(set2.begin(), set2.end()));
+}
+
+TEST_F(DataSetTest, should_not_change_copies_of_a_data_set)
+{
+  DataSet set {{"a", int64_t(1)}, {"c", int64_t(3)}, {"b", int64_t(2)}};
+  DataSet copy = set;
+
+  copy.insert_or_assign({"b", int64_t(20)});
+  copy.erase("a"_E);
+  copy.emplace("d", int64_t(4));
+  ASSERT_FALSE(copy.insert({"c", int64_t(30)}).second);
+
+  ASSERT_EQ(3, set.size());
+  ASSERT_EQ(2, set.get<int64_t>("b"));
+  ASSERT_EQ(1, set.get<int64_t>("a"));
+  ASSERT_FALSE(set.maybeGet<int64_t>("d"));
+
+  vector<string> keys;
+  for (const auto &e : copy)
+    keys.push_back(e.m_key);
+  ASSERT_EQ((vector<string> {"b", "c", "d"}), keys);
+  ASSERT_EQ(20, copy.get<int64_t>("b"));
+  ASSERT_EQ(3, copy.get<int64_t>("c"));
+
+  for (auto it = copy.begin(); it != copy.end();)
+    it = copy.erase(it);
+  ASSERT_TRUE(copy.empty());
+  ASSERT_EQ(3, set.size());
+}
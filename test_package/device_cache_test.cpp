@@ -0,0 +1,211 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <string>
+
+#include "mtconnect/entity/binary_codec.hpp"
+#include "mtconnect/parser/device_cache.hpp"
+#include "mtconnect/parser/xml_parser.hpp"
+#include "mtconnect/printer/xml_printer.hpp"
+#include "test_utilities.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::parser;
+using namespace device_model;
+
+namespace fs = std::filesystem;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class DeviceCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = fs::temp_directory_path() / "device_cache_test";
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir);
+
+    // Copy the devices file so the tests can change it
+    m_file = m_dir / "test_config.xml";
+    fs::copy_file(TEST_RESOURCE_DIR "/samples/test_config.xml", m_file);
+
+    XmlParser parser;
+    m_model.m_devices = parser.parseFile(m_file.string(), &m_printer);
+    m_model.m_schemaVersion = parser.getSchemaVersion();
+    m_model.m_namespaces = parser.getDevicesNamespaces();
+  }
+
+  void TearDown() override { fs::remove_all(m_dir); }
+
+  list<string> print(const list<DevicePtr> &devices)
+  {
+    list<string> printed;
+    for (auto &device : devices)
+      printed.emplace_back(m_printer.printDevice(device));
+    return printed;
+  }
+
+  fs::path m_dir;
+  fs::path m_file;
+  printer::XmlPrinter m_printer;
+  DeviceCache::Model m_model;
+};
+
+TEST_F(DeviceCacheTest, should_load_the_devices_saved_for_a_file)
+{
+  DeviceCache cache(m_dir / "cache");
+  ASSERT_TRUE(cache.isEnabled());
+  ASSERT_FALSE(cache.load(m_file));
+
+  ASSERT_TRUE(cache.save(m_file, m_model));
+  ASSERT_TRUE(fs::exists(m_dir / "cache" / "test_config.xml.mtdc"));
+
+  auto model = cache.load(m_file);
+  ASSERT_TRUE(model);
+  ASSERT_EQ(m_model.m_devices.size(), model->m_devices.size());
+  ASSERT_EQ("LinuxCNC", *model->m_devices.front()->getComponentName());
+  ASSERT_EQ(m_model.m_schemaVersion, model->m_schemaVersion);
+  ASSERT_EQ(m_model.m_namespaces.size(), model->m_namespaces.size());
+  ASSERT_EQ(print(m_model.m_devices), print(model->m_devices));
+}
+
+TEST_F(DeviceCacheTest, should_not_load_the_cache_if_the_file_changed)
+{
+  DeviceCache cache(m_dir);
+  ASSERT_TRUE(cache.save(m_file, m_model));
+  ASSERT_TRUE(cache.load(m_file));
+
+  {
+    ofstream out(m_file, ios::app);
+    out << "<!-- changed -->" << endl;
+  }
+
+  ASSERT_FALSE(cache.load(m_file));
+}
+
+TEST_F(DeviceCacheTest, should_not_load_a_corrupt_cache)
+{
+  DeviceCache cache(m_dir);
+  ASSERT_TRUE(cache.save(m_file, m_model));
+  auto path = cache.getCachePath(m_file);
+
+  // Truncated in the middle of the devices
+  fs::resize_file(path, fs::file_size(path) / 2);
+  ASSERT_FALSE(cache.load(m_file));
+
+  // Not a cache at all
+  {
+    ofstream out(path, ios::binary | ios::trunc);
+    out << "<MTConnectDevices/>";
+  }
+  ASSERT_FALSE(cache.load(m_file));
+}
+
+TEST_F(DeviceCacheTest, should_not_load_a_cache_with_a_bad_count)
+{
+  DeviceCache cache(m_dir);
+  ASSERT_TRUE(cache.save(m_file, m_model));
+  auto path = cache.getCachePath(m_file);
+
+  string contents;
+  {
+    ifstream in(path, ios::binary);
+    contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+
+  // Read the valid header up to the devices
+  struct Decoder : entity::BinaryDecoder
+  {
+    using BinaryDecoder::BinaryDecoder;
+    size_t position() const { return m_pos; }
+  } decoder(contents.data() + 8, contents.size() - 8);
+  decoder.get<uint32_t>();
+  decoder.getString();
+  decoder.getString();
+  if (decoder.get<uint8_t>() != 0)
+    decoder.getString();
+  auto nsCount = decoder.get<uint32_t>();
+  for (uint32_t i = 0; i < nsCount; i++)
+  {
+    decoder.getString();
+    decoder.getString();
+    decoder.getString();
+  }
+  auto header = contents.substr(0, 8 + decoder.position());
+
+  auto replaceDevices = [&](auto &&device) {
+    string data = header;
+    entity::BinaryEncoder encoder(data);
+    encoder.put<uint32_t>(1);
+    encoder.putString("Device");
+    encoder.put<uint32_t>(0);
+    encoder.put<uint32_t>(0);
+    device(encoder);
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(data.data(), data.size());
+  };
+
+  // A property count far larger than the file
+  optional<DeviceCache::Model> model;
+  replaceDevices([](entity::BinaryEncoder &encoder) { encoder.put<uint32_t>(0xFFFFFFF0); });
+  ASSERT_NO_THROW(model = cache.load(m_file));
+  ASSERT_FALSE(model);
+
+  // A vector length far larger than the file
+  replaceDevices([](entity::BinaryEncoder &encoder) {
+    encoder.put<uint32_t>(1);
+    encoder.putString("Values");
+    encoder.put<uint8_t>(0);
+    encoder.put<uint8_t>(uint8_t(entity::ValueType::VECTOR));
+    encoder.put<uint32_t>(0xFFFFFFF0);
+  });
+  ASSERT_NO_THROW(model = cache.load(m_file));
+  ASSERT_FALSE(model);
+}
+
+TEST_F(DeviceCacheTest, should_be_disabled_if_the_directory_cannot_be_created)
+{
+  // A file is in the way of the directory
+  auto blocked = m_dir / "blocked";
+  {
+    ofstream out(blocked);
+    out << "not a directory";
+  }
+
+  unique_ptr<DeviceCache> cache;
+  ASSERT_NO_THROW(cache = make_unique<DeviceCache>(blocked / "cache"));
+  ASSERT_FALSE(cache->isEnabled());
+  ASSERT_FALSE(cache->save(m_file, m_model));
+  ASSERT_FALSE(cache->load(m_file));
+}
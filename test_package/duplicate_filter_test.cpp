@@ -60,6 +60,9 @@ public:
   void eachDataItem(EachDataItem fun) override {}
   void deliverObservation(observation::ObservationPtr obs) override
   {
+    obs->setSequence(m_sequence);
+    obs->getDataItem()->setLatestSequence(m_sequence);
+    m_sequence++;
     m_checkpoint.addObservation(obs);
   }
   void deliverAsset(AssetPtr) override {}
@@ -72,12 +75,23 @@ public:
   void sourceFailed(const std::string &id) override {}
   const ObservationPtr checkDuplicate(const ObservationPtr &obs) const override
   {
+    m_bufferChecks++;
     return m_checkpoint.checkDuplicate(obs);
   }
+  ObservationPtr getLatest(const std::string &id, uint64_t &sequence) const override
+  {
+    m_bufferChecks++;
+    auto obs = m_checkpoint.getObservation(id);
+    if (obs)
+      sequence = obs->getDataItem()->getLatestSequence();
+    return obs;
+  }
   bool isValidating() const override { return false; }
 
   std::map<string, DataItemPtr> &m_dataItems;
   buffer::Checkpoint m_checkpoint;
+  SequenceNumber_t m_sequence {1};
+  mutable int m_bufferChecks {0};
 };
 
 class DuplicateFilterTest : public testing::Test
@@ -270,7 +284,7 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     auto prev = cond->getPrev();
     ASSERT_TRUE(prev);
     ASSERT_EQ("YYY", prev->get<string>("nativeCode"));
-    ASSERT_FALSE(prev->getPrev());
+    ASSERT_EQ(1, cond->getActive().size());
   }
 
   {
@@ -311,3 +325,33 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     ASSERT_EQ(0, list.size());
   }
 }
+
+TEST_F(DuplicateFilterTest, should_filter_duplicates_without_checking_the_buffer)
+{
+  auto di = makeDataItem({{"id", "a"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}});
+
+  auto filter = make_shared<DuplicateFilter>(m_context);
+  m_mapper->bind(filter);
+  filter->bind(make_shared<DeliverObservation>(m_context));
+
+  auto *contract = dynamic_cast<MockPipelineContract *>(m_context->m_contract.get());
+
+  // Nothing in the buffer yet, so the filter falls back to the buffer check
+  ASSERT_EQ(1, observe({"a", "READY"})->getValue<EntityList>().size());
+  ASSERT_EQ(2, contract->m_bufferChecks);
+
+  for (int i = 0; i < 10; i++)
+    ASSERT_EQ(0, observe({"a", "READY"})->getValue<EntityList>().size());
+  ASSERT_EQ(2, contract->m_bufferChecks);
+
+  // Another source changes the value, the shadow must be primed from the buffer
+  ErrorList errors;
+  auto obs = Observation::make(di, {{"VALUE", "ACTIVE"s}}, chrono::system_clock::now(), errors);
+  contract->deliverObservation(obs);
+
+  ASSERT_EQ(1, observe({"a", "READY"})->getValue<EntityList>().size());
+  ASSERT_EQ(3, contract->m_bufferChecks);
+
+  ASSERT_EQ(0, observe({"a", "READY"})->getValue<EntityList>().size());
+  ASSERT_EQ(3, contract->m_bufferChecks);
+}
@@ -117,14 +117,13 @@ namespace {
       m_context->m_contract = make_unique<MockPipelineContract>(m_config->getAgent());
     }
 
-    void load(const char *file)
+    void load(const char *file, const char *options = "")
     {
       string str("Devices = " TEST_RESOURCE_DIR
                  "/samples/test_config.xml\n"
                  "Ruby {\n"
                  "  module = " TEST_RESOURCE_DIR "/ruby/" +
-                 string(file) +
-                 "\n"
+                 string(file) + "\n" + options +
                  "}\n");
       m_config->loadConfig(str);
     }
@@ -164,6 +163,21 @@ namespace {
     }
   }
 
+  TEST_F(EmbeddedRubyTest, should_bind_sources_to_virtual_machines)
+  {
+    load("should_initialize.rb", "  VirtualMachines = 2\n");
+
+    ASSERT_TRUE(RubyVM::hasVM());
+    auto mrb = RubyVM::rubyVM().state();
+    ASSERT_NE(nullptr, mrb);
+    ASSERT_EQ(&RubyVM::rubyVM(), &RubyVM::of(mrb));
+
+    // The two sources are split between the virtual machines
+    mrb_value pipelines = mrb_gv_get(mrb, mrb_intern_lit(mrb, "$pipelines"));
+    ASSERT_TRUE(mrb_array_p(pipelines));
+    ASSERT_EQ(1, ARY_LEN(mrb_ary_ptr(pipelines)));
+  }
+
   TEST_F(EmbeddedRubyTest, should_support_entities)
   {
     using namespace std::chrono;
@@ -471,6 +471,38 @@ TEST_F(EntityTest, TestRequirementVectorConversions)
   EXPECT_THROW(r6.convertType(v), PropertyError);
 }
 
+TEST_F(EntityTest, vector_conversion_should_match_strtod_rules)
+{
+  Requirement r1("vector", ValueType::VECTOR);
+
+  Value v("+1.5 -2 0x10 1e3"s);
+  ASSERT_TRUE(r1.convertType(v, false, 4));
+  ASSERT_TRUE(holds_alternative<Vector>(v));
+  auto &vec = get<Vector>(v);
+  ASSERT_EQ(4, vec.size());
+  EXPECT_EQ(1.5, vec[0]);
+  EXPECT_EQ(-2.0, vec[1]);
+  EXPECT_EQ(16.0, vec[2]);
+  EXPECT_EQ(1000.0, vec[3]);
+
+  v = "1.5 2.5abc"s;
+  EXPECT_THROW(r1.convertType(v, false, 2), PropertyError);
+
+  v = "1.5 +-2"s;
+  EXPECT_THROW(r1.convertType(v), PropertyError);
+
+  v = "1,2"s;
+  EXPECT_THROW(r1.convertType(v), PropertyError);
+
+  v = "    "s;
+  EXPECT_THROW(r1.convertType(v), PropertyError);
+
+  // An over stated capacity must not be trusted
+  v = "1 2 3"s;
+  ASSERT_TRUE(r1.convertType(v, false, 1000000000));
+  EXPECT_EQ(3, get<Vector>(v).size());
+}
+
 TEST_F(EntityTest, TestRequirementUpperCaseStringConversion)
 {
   Value v("hello kitty"s);
@@ -1082,3 +1114,33 @@ TEST_F(EntityTest, should_ignore_certain_entities_with_changes_and_removals)
 }
 
 TEST_F(EntityTest, entities_should_merge_entity_lists_without_identity) { GTEST_SKIP(); }
+
+TEST_F(EntityTest, properties_should_be_ordered_by_key_and_keep_the_first_value)
+{
+  Properties props {{"name", "first"s}, {"id", "abc"s}, {"x:size", 10_i64}, {"name", "second"s}};
+  ASSERT_EQ(3, props.size());
+  ASSERT_EQ("first", get<string>(props.at("name")));
+
+  props.insert_or_assign("VALUE", "value"s);
+  props["count"] = 2_i64;
+  ASSERT_FALSE(props.insert({"id", "def"s}).second);
+  ASSERT_EQ("abc", get<string>(props["id"]));
+
+  vector<string> keys;
+  for (const auto &[key, value] : props)
+    keys.push_back(key);
+  ASSERT_EQ((vector<string> {"VALUE", "count", "id", "name", "x:size"}), keys);
+
+  auto ns = props.find("x:size");
+  ASSERT_NE(props.end(), ns);
+  ASSERT_EQ("x", ns->first.getNs());
+  ASSERT_EQ("size", ns->first.getName());
+
+  Properties copy(props);
+  ASSERT_EQ(props, copy);
+
+  ASSERT_EQ(1, copy.erase("count"));
+  ASSERT_EQ(0, copy.erase("count"));
+  ASSERT_FALSE(copy.contains("count"));
+  ASSERT_TRUE(props.contains("count"));
+}
@@ -0,0 +1,277 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+/// @file
+/// Replays adapter captures through the adapter pipelines into an agent and reports the ingest
+/// throughput, allocations, and latency.
+///
+/// Usage: ingest_benchmark [--pipeline shdr|mqtt] [--devices <file>] [--device <name>]
+///                         [--repeat <n>] [--paced] <capture>...
+///
+/// Captures are recorded by an adapter with the `CaptureFile` option.
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "mtconnect/agent.hpp"
+#include "mtconnect/configuration/async_context.hpp"
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/metrics.hpp"
+#include "mtconnect/pipeline/pipeline_context.hpp"
+#include "mtconnect/source/adapter/adapter_capture.hpp"
+#include "mtconnect/source/adapter/mqtt/mqtt_adapter.hpp"
+#include "mtconnect/source/adapter/shdr/shdr_pipeline.hpp"
+
+using namespace std;
+using namespace std::literals;
+using namespace mtconnect;
+using namespace mtconnect::source::adapter;
+
+// Count every allocation made while replaying
+static std::atomic<uint64_t> s_allocations {0};
+
+void *operator new(size_t size)
+{
+  s_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+  struct Arguments
+  {
+    string m_pipeline {"shdr"};
+    string m_devices {TEST_RESOURCE_DIR "/samples/test_config.xml"};
+    optional<string> m_device;
+    int m_repeat {1};
+    bool m_paced {false};
+    list<string> m_captures;
+  };
+
+  void usage()
+  {
+    cerr << "Usage: ingest_benchmark [--pipeline shdr|mqtt] [--devices <file>] [--device <name>]"
+         << endl
+         << "                        [--repeat <n>] [--paced] <capture>..." << endl;
+  }
+
+  optional<Arguments> parse(int argc, char *argv[])
+  {
+    Arguments args;
+    for (int i = 1; i < argc; i++)
+    {
+      string arg = argv[i];
+      bool hasValue = i + 1 < argc;
+      if (arg == "--pipeline" && hasValue)
+        args.m_pipeline = argv[++i];
+      else if (arg == "--devices" && hasValue)
+        args.m_devices = argv[++i];
+      else if (arg == "--device" && hasValue)
+        args.m_device = argv[++i];
+      else if (arg == "--repeat" && hasValue)
+        args.m_repeat = max(1, atoi(argv[++i]));
+      else if (arg == "--paced")
+        args.m_paced = true;
+      else if (arg.starts_with("--"))
+        return nullopt;
+      else
+        args.m_captures.push_back(arg);
+    }
+
+    if (args.m_captures.empty() || (args.m_pipeline != "shdr" && args.m_pipeline != "mqtt"))
+      return nullopt;
+
+    return args;
+  }
+
+  void report(const string &title, uint64_t records, uint64_t observations, uint64_t allocations,
+              chrono::nanoseconds elapsed, const metrics::Histogram &latency)
+  {
+    auto seconds = chrono::duration<double>(elapsed).count();
+    auto snap = latency.snapshot();
+    auto us = [](uint64_t ns) { return double(ns) / 1000.0; };
+
+    cout << fixed << setprecision(2);
+    cout << title << endl;
+    cout << "  Records:                  " << records << endl;
+    cout << "  Observations:             " << observations << endl;
+    cout << "  Elapsed:                  " << seconds << "s" << endl;
+    cout << "  Lines/s:                  " << double(records) / seconds << endl;
+    cout << "  Observations/s:           " << double(observations) / seconds << endl;
+    cout << "  Allocations/observation:  "
+         << (observations > 0 ? double(allocations) / double(observations) : 0.0) << endl;
+    cout << "  Latency (us) p50: " << us(snap.quantile(0.5)) << " p90: " << us(snap.quantile(0.9))
+         << " p99: " << us(snap.quantile(0.99)) << " p99.9: " << us(snap.quantile(0.999))
+         << " max: " << us(snap.m_max) << endl;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  auto args = parse(argc, argv);
+  if (!args)
+  {
+    usage();
+    return 1;
+  }
+
+  configuration::AsyncContext context;
+  boost::asio::io_context::strand strand(context);
+
+  ConfigOptions options {{configuration::BufferSize, 17},
+                         {configuration::MaxAssets, 1024},
+                         {configuration::CheckpointFrequency, 1000},
+                         {configuration::SchemaVersion, "2.5"s}};
+
+  auto agent = make_unique<Agent>(context, args->m_devices, options);
+  auto pipelineContext = make_shared<pipeline::PipelineContext>();
+  pipelineContext->m_contract = agent->makePipelineContract();
+  agent->initialize(pipelineContext);
+  agent->initialDataItemObservations();
+
+  auto device = args->m_device ? agent->getDeviceByName(*args->m_device)
+                               : agent->getDefaultDevice();
+  if (!device)
+  {
+    cerr << "Cannot find device" << endl;
+    return 1;
+  }
+
+  ConfigOptions adapterOptions {{configuration::Device, *device->getComponentName()},
+                                {configuration::AdapterIdentity, "benchmark"s}};
+
+  // Build the pipeline the same way the adapters do
+  unique_ptr<AdapterPipeline> pipeline;
+  unique_ptr<Handler> handler;
+  if (args->m_pipeline == "mqtt")
+  {
+    auto mqtt = make_unique<mqtt_adapter::MqttPipeline>(pipelineContext, strand);
+    handler = mqtt->makeHandler();
+    mqtt->m_handler = handler.get();
+    pipeline = std::move(mqtt);
+  }
+  else
+  {
+    pipeline = make_unique<shdr::ShdrPipeline>(pipelineContext, strand);
+    handler = pipeline->makeHandler();
+  }
+  pipeline->build(adapterOptions);
+
+  auto &buffer = agent->getCircularBuffer();
+  for (const auto &file : args->m_captures)
+  {
+    // Load the capture so reading the file is not measured
+    vector<CaptureRecord> records;
+    try
+    {
+      CaptureReader reader(file);
+      CaptureRecord record;
+      while (reader.next(record))
+        records.push_back(record);
+    }
+    catch (std::exception &e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+
+    // Every kind of record in the capture must have a handler in the pipeline
+    for (const auto &record : records)
+    {
+      const char *missing = nullptr;
+      switch (record.m_kind)
+      {
+        case CaptureRecord::DATA:
+          if (!handler->m_processData)
+            missing = "data";
+          break;
+
+        case CaptureRecord::COMMAND:
+          if (!handler->m_command)
+            missing = "command";
+          break;
+
+        case CaptureRecord::MESSAGE:
+          if (!handler->m_processMessage)
+            missing = "message";
+          break;
+      }
+
+      if (missing)
+      {
+        cerr << file << ": the " << args->m_pipeline << " pipeline cannot replay " << missing
+             << " records" << endl;
+        return 1;
+      }
+    }
+
+    metrics::Histogram latency;
+    auto firstSequence = buffer.getSequence();
+    auto allocations = s_allocations.load();
+    auto start = chrono::steady_clock::now();
+
+    for (int i = 0; i < args->m_repeat; i++)
+    {
+      auto pass = chrono::steady_clock::now();
+      for (const auto &record : records)
+      {
+        if (args->m_paced)
+          this_thread::sleep_until(pass + record.m_offset);
+
+        auto begin = chrono::steady_clock::now();
+        switch (record.m_kind)
+        {
+          case CaptureRecord::DATA:
+            handler->m_processData(record.m_payload, "benchmark");
+            break;
+
+          case CaptureRecord::COMMAND:
+            handler->m_command(record.m_topic, record.m_payload, "benchmark");
+            break;
+
+          case CaptureRecord::MESSAGE:
+            handler->m_processMessage(record.m_topic, record.m_payload, "benchmark");
+            break;
+        }
+        latency.record(uint64_t(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin)
+                .count()));
+      }
+    }
+
+    auto elapsed = chrono::steady_clock::now() - start;
+    report(file, records.size() * args->m_repeat, buffer.getSequence() - firstSequence,
+           s_allocations.load() - allocations, elapsed, latency);
+  }
+
+  pipeline->clear();
+  agent->stop();
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <thread>
+
+#include "mtconnect/metrics/metrics.hpp"
+
+using namespace std;
+using namespace mtconnect::metrics;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class MetricsTest : public testing::Test
+{
+protected:
+  void SetUp() override { Registry::setEnabled(true); }
+  void TearDown() override { Registry::setEnabled(false); }
+};
+
+TEST_F(MetricsTest, should_bucket_values_with_bounded_error)
+{
+  for (uint64_t v = 0; v < 8; v++)
+  {
+    ASSERT_EQ(v, Histogram::bucketIndex(v));
+    ASSERT_EQ(v, Histogram::bucketUpperBound(v));
+  }
+
+  for (uint64_t v : {8ull, 9ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull})
+  {
+    auto index = Histogram::bucketIndex(v);
+    ASSERT_LT(index, Histogram::Buckets);
+    auto upper = Histogram::bucketUpperBound(index);
+    ASSERT_GE(upper, v);
+    ASSERT_LE(double(upper - v), double(v) / Histogram::SubBuckets);
+    if (index > 0)
+      ASSERT_LT(Histogram::bucketUpperBound(index - 1), v);
+  }
+}
+
+TEST_F(MetricsTest, should_compute_quantiles)
+{
+  Histogram histogram;
+  for (uint64_t v = 1; v <= 1000; v++)
+    histogram.record(v);
+
+  auto snap = histogram.snapshot();
+  ASSERT_EQ(1000, snap.m_count);
+  ASSERT_EQ(500500, snap.m_sum);
+  ASSERT_EQ(1000, snap.m_max);
+
+  auto p50 = snap.quantile(0.5);
+  ASSERT_GE(p50, 500);
+  ASSERT_LE(p50, 500 + 500 / Histogram::SubBuckets);
+  auto p99 = snap.quantile(0.99);
+  ASSERT_GE(p99, 990);
+  ASSERT_LE(p99, 1000);
+  ASSERT_EQ(1000, snap.quantile(1.0));
+}
+
+TEST_F(MetricsTest, should_merge_shards_from_threads)
+{
+  auto &counter = Registry::instance().counter("test_merge_total");
+  auto &histogram = Registry::instance().histogram("test_merge_seconds");
+
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++)
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; j++)
+      {
+        counter.add();
+        histogram.record(j);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+
+  ASSERT_EQ(8000, counter.value());
+  ASSERT_EQ(8000, histogram.snapshot().m_count);
+  ASSERT_EQ(999, histogram.snapshot().m_max);
+}
+
+TEST_F(MetricsTest, should_print_prometheus_text)
+{
+  auto &registry = Registry::instance();
+  registry.counter("test_print_total", {{"kind", "a\"b"}}).add(3);
+  registry.gauge("test_print_depth").set(-2);
+  registry.histogram("test_print_seconds", {{"transform", "Validator"}}).record(2000);
+
+  auto text = registry.print();
+  ASSERT_NE(string::npos, text.find("# TYPE test_print_total counter\n"));
+  ASSERT_NE(string::npos, text.find("test_print_total{kind=\"a\\\"b\"} 3\n"));
+  ASSERT_NE(string::npos, text.find("test_print_depth -2\n"));
+  ASSERT_NE(string::npos, text.find("# TYPE test_print_seconds summary\n"));
+  ASSERT_NE(string::npos,
+            text.find("test_print_seconds{transform=\"Validator\",quantile=\"0.5\"} 2e-06\n"));
+  ASSERT_NE(string::npos, text.find("test_print_seconds_sum{transform=\"Validator\"} 2e-06\n"));
+  ASSERT_NE(string::npos, text.find("test_print_seconds_count{transform=\"Validator\"} 1\n"));
+}
+
+TEST_F(MetricsTest, should_not_record_when_disabled)
+{
+  auto &histogram = Registry::instance().histogram("test_disabled_seconds");
+  Registry::setEnabled(false);
+  {
+    ScopedTimer timer(&histogram);
+    ExclusiveTimer exclusive(&histogram);
+  }
+  ASSERT_EQ(0, histogram.snapshot().m_count);
+
+  Registry::setEnabled(true);
+  {
+    ScopedTimer timer(&histogram);
+  }
+  ASSERT_EQ(1, histogram.snapshot().m_count);
+}
+
+TEST_F(MetricsTest, should_exclude_nested_time)
+{
+  auto &outer = Registry::instance().histogram("test_outer_seconds");
+  auto &inner = Registry::instance().histogram("test_inner_seconds");
+
+  {
+    ExclusiveTimer timer(&outer);
+    {
+      ExclusiveTimer timer(&inner);
+      this_thread::sleep_for(20ms);
+    }
+  }
+
+  auto o = outer.snapshot();
+  auto i = inner.snapshot();
+  ASSERT_EQ(1, o.m_count);
+  ASSERT_EQ(1, i.m_count);
+  ASSERT_GE(i.m_max, 20'000'000);
+  ASSERT_LT(o.m_max, 10'000'000);
+}
@@ -95,7 +95,7 @@ protected:
             {configuration::AssetTopicPrefix, "MTConnect/Asset/[device]"s},
             {configuration::MqttLastWillTopic, "MTConnect/Probe/[device]/Availability"s},
         });
-    m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, false, true, opts);
+    m_agentTestHelper->createAgent(testFile, 8, 4, "2.0", 25, false, true, opts);
     addAdapter();
     m_agentTestHelper->getAgent()->start();
   }
@@ -791,3 +791,127 @@ TEST_F(MqttEntitySinkTest, mqtt_entity_sink_should_publish_last_will)
 
   stopClient();
 }
+
+TEST_F(MqttEntitySinkTest, mqtt_entity_sink_should_write_null_for_non_finite_data_set_values)
+{
+  ConfigOptions options;
+
+  createServer({});
+  startServer();
+
+  auto handler = make_unique<ClientHandler>();
+  bool gotDataSet = false;
+  json result;
+
+  handler->m_receive = [&gotDataSet, &result](std::shared_ptr<MqttClient> client,
+                                              const std::string& topic,
+                                              const std::string& payload) {
+    auto doc = json::parse(payload);
+    if (doc["dataItemId"] == "v1" && doc["result"] != "UNAVAILABLE")
+    {
+      result = json::parse(doc["result"].get<std::string>());
+      gotDataSet = true;
+    }
+  };
+
+  createClient(options, std::move(handler));
+  ASSERT_TRUE(startClient());
+  m_client->subscribe("MTConnect/Devices/#");
+
+  createAgent("/samples/data_set.xml");
+
+  auto sink = m_agentTestHelper->getAgent()->findSink("MqttEntitySink");
+  auto mqttSink = dynamic_pointer_cast<MqttEntitySink>(sink);
+  ASSERT_TRUE(waitFor(10s, [&mqttSink]() { return mqttSink->isConnected(); }));
+
+  m_agentTestHelper->m_ioContext.run_for(200ms);
+  m_agentTestHelper->m_adapter->processData(
+      "2021-02-01T12:00:00Z|vars|a=1.5 b=nan c=inf d=2 e=xxx");
+  ASSERT_TRUE(waitFor(10s, [&gotDataSet]() { return gotDataSet; }));
+
+  ASSERT_TRUE(result.is_object());
+  EXPECT_EQ(5, result.size());
+  EXPECT_EQ(1.5, result["a"].get<double>());
+  EXPECT_TRUE(result["b"].is_null());
+  EXPECT_TRUE(result["c"].is_null());
+  EXPECT_EQ(2, result["d"].get<int64_t>());
+  EXPECT_EQ("xxx", result["e"].get<std::string>());
+
+  stopClient();
+}
+
+TEST_F(MqttEntitySinkTest, mqtt_entity_sink_should_publish_queued_observations_on_reconnect)
+{
+  ConfigOptions options;
+
+  createServer({});
+  startServer();
+
+  auto handler = make_unique<ClientHandler>();
+  bool collect = false;
+  vector<string> results;
+
+  handler->m_receive = [&collect, &results](std::shared_ptr<MqttClient> client,
+                                            const std::string& topic, const std::string& payload) {
+    auto doc = json::parse(payload);
+    if (collect && doc["dataItemId"] == "p3")
+      results.emplace_back(doc["result"].get<std::string>());
+  };
+
+  createClient(options, std::move(handler));
+  ASSERT_TRUE(startClient());
+  m_client->subscribe("MTConnect/Devices/#");
+
+  createAgent();
+
+  auto sink = m_agentTestHelper->getAgent()->findSink("MqttEntitySink");
+  auto mqttSink = dynamic_pointer_cast<MqttEntitySink>(sink);
+  ASSERT_TRUE(waitFor(10s, [&mqttSink]() { return mqttSink->isConnected(); }));
+  m_agentTestHelper->m_ioContext.run_for(500ms);
+
+  mqttSink->stop();
+  m_agentTestHelper->m_ioContext.run_for(500ms);
+  ASSERT_FALSE(mqttSink->isConnected());
+
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|1");
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:01Z|line|2");
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:02Z|line|3");
+
+  auto queued = mqttSink->getQueuedObservations();
+  ASSERT_EQ(3, queued.size());
+  EXPECT_EQ("1", get<string>(queued[0]->getValue()));
+  EXPECT_EQ("3", get<string>(queued[2]->getValue()));
+
+  collect = true;
+  mqttSink->start();
+  ASSERT_TRUE(waitFor(10s, [&results]() { return results.size() >= 4; }));
+
+  // The queued observations are sent before the current value from the initial content
+  EXPECT_EQ("1", results[0]);
+  EXPECT_EQ("2", results[1]);
+  EXPECT_EQ("3", results[2]);
+  EXPECT_EQ("3", results[3]);
+  EXPECT_TRUE(mqttSink->getQueuedObservations().empty());
+
+  stopClient();
+}
+
+TEST_F(MqttEntitySinkTest, mqtt_entity_sink_should_drop_the_oldest_queued_observations_when_full)
+{
+  // No server, the sink never connects and queues everything
+  createAgent();
+
+  auto sink = m_agentTestHelper->getAgent()->findSink("MqttEntitySink");
+  auto mqttSink = dynamic_pointer_cast<MqttEntitySink>(sink);
+  ASSERT_FALSE(mqttSink->isConnected());
+
+  const size_t extra = 5;
+  for (size_t i = 0; i < MqttEntitySink::MAX_QUEUE_SIZE + extra; i++)
+    m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|" + to_string(i));
+
+  auto queued = mqttSink->getQueuedObservations();
+  ASSERT_EQ(MqttEntitySink::MAX_QUEUE_SIZE, queued.size());
+  EXPECT_EQ(to_string(extra), get<string>(queued.front()->getValue()));
+  EXPECT_EQ(to_string(MqttEntitySink::MAX_QUEUE_SIZE + extra - 1),
+            get<string>(queued.back()->getValue()));
+}
@@ -26,6 +26,7 @@
 #include "mtconnect/buffer/checkpoint.hpp"
 #include "mtconnect/device_model/data_item/data_item.hpp"
 #include "mtconnect/entity/json_parser.hpp"
+#include "mtconnect/metrics/metrics.hpp"
 #include "mtconnect/mqtt/mqtt_authorization.hpp"
 #include "mtconnect/mqtt/mqtt_client_impl.hpp"
 #include "mtconnect/mqtt/mqtt_server_impl.hpp"
@@ -57,6 +58,26 @@ int main(int argc, char *argv[])
   return RUN_ALL_TESTS();
 }
 
+// Exposes the broker publish so a test can send a burst of messages without running the io
+// context. The subscriber cannot read any of them until the burst is finished.
+class TestMqttServer : public mtconnect::mqtt_server::MqttTcpServer
+{
+public:
+  using MqttTcpServer::MqttTcpServer;
+  using MqttTcpServer::publish;
+
+  size_t maxQueued() const { return m_maxQueued; }
+
+  size_t queued()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (auto &outbound : m_outbound)
+      count += outbound.second.m_queue.size();
+    return count;
+  }
+};
+
 class MqttIsolatedUnitTest : public testing::Test
 {
 protected:
@@ -178,6 +199,62 @@ protected:
     return started;
   }
 
+  // Publish a burst of messages to one subscriber on a broker that queues at most 4 messages
+  // for each connection, and return the payloads the subscriber received
+  list<string> publishToSlowSubscriber(MQTT_NS::qos subscription,
+                                       const vector<MQTT_NS::qos> &messages, size_t expected)
+  {
+    auto server = make_shared<TestMqttServer>(m_agentTestHelper->m_ioContext,
+                                              ConfigOptions {{ServerIp, "127.0.0.1"s},
+                                                             {MqttPort, 0},
+                                                             {MqttTls, false},
+                                                             {AutoAvailable, false},
+                                                             {RealTime, false},
+                                                             {MqttMaxQueuedMessages, 4}});
+    m_server = server;
+    startServer();
+
+    auto client =
+        mqtt::make_async_client(m_agentTestHelper->m_ioContext.get(), "localhost", m_port);
+    client->set_client_id("slow_subscriber");
+    client->set_clean_session(true);
+
+    bool subscribed = false;
+    list<string> received;
+    client->set_connack_handler([&client, subscription](bool sp, mqtt::connect_return_code rc) {
+      if (rc == mqtt::connect_return_code::accepted)
+        client->async_subscribe(client->acquire_unique_packet_id(), "burst/#", subscription);
+      return true;
+    });
+    client->set_suback_handler(
+        [&subscribed](std::uint16_t packet_id, std::vector<mqtt::suback_return_code> results) {
+          subscribed = true;
+          return true;
+        });
+    client->set_publish_handler([&received](mqtt::optional<std::uint16_t> packet_id,
+                                            mqtt::publish_options pubopts, mqtt::buffer topic,
+                                            mqtt::buffer contents) {
+      received.emplace_back(contents);
+      return true;
+    });
+    client->async_connect([](mqtt::error_code ec) { EXPECT_FALSE(ec); });
+    EXPECT_TRUE(waitFor(5s, [&subscribed]() { return subscribed; }));
+
+    for (size_t i = 0; i < messages.size(); i++)
+      server->publish(MQTT_NS::allocate_buffer("burst/data"s),
+                      MQTT_NS::allocate_buffer(to_string(i)), messages[i]);
+    EXPECT_EQ(4, server->queued());
+
+    EXPECT_TRUE(waitFor(5s, [&received, expected]() { return received.size() >= expected; }));
+    m_agentTestHelper->m_ioContext.run_for(200ms);
+    EXPECT_EQ(0, server->queued());
+
+    client->async_disconnect();
+    m_agentTestHelper->m_ioContext.run_for(200ms);
+
+    return received;
+  }
+
   std::unique_ptr<printer::JsonPrinter> m_jsonPrinter;
   std::shared_ptr<mtconnect::mqtt_server::MqttServer> m_server;
   std::shared_ptr<MqttClient> m_client;
@@ -595,3 +672,58 @@ TEST_F(MqttIsolatedUnitTest, mqtt_client_should_publish_last_will)
   waitFor(5s, [&closed]() { return closed; });
   client.reset();
 }
+
+TEST_F(MqttIsolatedUnitTest, broker_should_drop_the_oldest_qos_0_messages_for_a_slow_subscriber)
+{
+  using namespace mtconnect::metrics;
+  using qos = MQTT_NS::qos;
+
+  Registry::setEnabled(true);
+  auto &dropped =
+      Registry::instance().counter("mtconnect_mqtt_server_dropped_total", {{"qos", "0"}});
+  auto before = dropped.value();
+
+  // The first message is being written, the rest wait in a queue of 4
+  auto received = publishToSlowSubscriber(qos::at_most_once, vector<qos>(10, qos::at_most_once), 5);
+  ASSERT_EQ((list<string> {"0", "6", "7", "8", "9"}), received);
+  ASSERT_EQ(5, dropped.value() - before);
+
+  Registry::setEnabled(false);
+}
+
+TEST_F(MqttIsolatedUnitTest, broker_should_hold_qos_1_messages_and_drop_new_ones_when_full)
+{
+  using qos = MQTT_NS::qos;
+
+  auto received =
+      publishToSlowSubscriber(qos::at_least_once, vector<qos>(10, qos::at_least_once), 5);
+  ASSERT_EQ((list<string> {"0", "1", "2", "3", "4"}), received);
+}
+
+TEST_F(MqttIsolatedUnitTest, broker_should_drop_qos_0_messages_before_qos_1_messages)
+{
+  using qos = MQTT_NS::qos;
+  auto q0 = qos::at_most_once, q1 = qos::at_least_once;
+
+  // 5 replaces 1 and 6 replaces 3, the oldest QoS 0 messages. 7 replaces 6. 8 is dropped because
+  // all the queued messages are QoS 1.
+  auto received = publishToSlowSubscriber(q1, {q1, q0, q1, q0, q1, q1, q0, q1, q1}, 5);
+  ASSERT_EQ((list<string> {"0", "2", "4", "5", "7"}), received);
+}
+
+TEST_F(MqttIsolatedUnitTest, broker_should_queue_at_least_one_message)
+{
+  for (auto configured : {0, -5})
+  {
+    TestMqttServer server(m_agentTestHelper->m_ioContext,
+                          ConfigOptions {{ServerIp, "127.0.0.1"s},
+                                         {MqttPort, 0},
+                                         {MqttTls, false},
+                                         {MqttMaxQueuedMessages, configured}});
+    ASSERT_EQ(1u, server.maxQueued());
+  }
+
+  TestMqttServer server(m_agentTestHelper->m_ioContext,
+                        ConfigOptions {{ServerIp, "127.0.0.1"s}, {MqttPort, 0}, {MqttTls, false}});
+  ASSERT_EQ(1000u, server.maxQueued());
+}
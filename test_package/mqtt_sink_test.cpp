@@ -316,9 +316,88 @@ TEST_F(MqttSinkTest, mqtt_sink_should_publish_Current)
   ASSERT_TRUE(gotCurrent);
 
   gotCurrent = false;
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|204");
   ASSERT_TRUE(waitFor(1s, [&gotCurrent]() { return gotCurrent; }));
 }
 
+TEST_F(MqttSinkTest, mqtt_sink_should_not_publish_unchanged_Current)
+{
+  ConfigOptions options;
+  createServer(options);
+  startServer();
+  ASSERT_NE(0, m_port);
+
+  auto handler = make_unique<ClientHandler>();
+  int currents = 0;
+  handler->m_receive = [&currents](std::shared_ptr<MqttClient> client, const std::string &topic,
+                                   const std::string &payload) {
+    EXPECT_EQ("MTConnect/Current/000", topic);
+    currents++;
+  };
+
+  createClient(options, std::move(handler));
+  ASSERT_TRUE(startClient());
+  m_client->subscribe("MTConnect/Current/000");
+
+  createAgent();
+
+  auto service = m_agentTestHelper->getMqttService();
+
+  ASSERT_TRUE(waitFor(60s, [&service]() { return service->isConnected(); }));
+  ASSERT_TRUE(waitFor(1s, [&currents]() { return currents > 0; }));
+
+  // Nothing changed for the device over several intervals
+  auto published = currents;
+  m_agentTestHelper->m_ioContext.run_for(700ms);
+  ASSERT_EQ(published, currents);
+
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|204");
+  ASSERT_TRUE(waitFor(1s, [&currents, published]() { return currents > published; }));
+}
+
+TEST_F(MqttSinkTest, mqtt_sink_should_publish_Current_deltas_for_data_items)
+{
+  ConfigOptions options;
+  createServer(options);
+  startServer();
+  ASSERT_NE(0, m_port);
+
+  auto handler = make_unique<ClientHandler>();
+  bool gotCurrent = false;
+  bool gotDelta = false;
+  handler->m_receive = [&gotCurrent, &gotDelta](std::shared_ptr<MqttClient> client,
+                                                const std::string &topic,
+                                                const std::string &payload) {
+    if (topic == "MTConnect/Current/000")
+    {
+      gotCurrent = true;
+    }
+    else if (topic == "MTConnect/Current/000/p3")
+    {
+      auto jdoc = json::parse(payload);
+      auto streams = jdoc.at("/MTConnectStreams/Streams/0/DeviceStream"_json_pointer);
+      EXPECT_EQ(string("LinuxCNC"), streams.at("/name"_json_pointer).get<string>());
+      EXPECT_NE(string::npos, payload.find("\"204\""));
+
+      gotDelta = true;
+    }
+  };
+
+  createClient(options, std::move(handler));
+  ASSERT_TRUE(startClient());
+  m_client->subscribe("MTConnect/Current/000/#");
+
+  createAgent({}, {{configuration::MqttCurrentDelta, "DataItem"s}});
+
+  auto service = m_agentTestHelper->getMqttService();
+
+  ASSERT_TRUE(waitFor(60s, [&service]() { return service->isConnected(); }));
+  ASSERT_TRUE(waitFor(1s, [&gotCurrent]() { return gotCurrent; }));
+
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|204");
+  ASSERT_TRUE(waitFor(1s, [&gotDelta]() { return gotDelta; }));
+}
+
 TEST_F(MqttSinkTest, mqtt_sink_should_publish_Probe_with_uuid_first)
 {
   ConfigOptions options;
@@ -65,6 +65,19 @@ public:
   DevicePtr m_device;
 };
 
+class CaptureTransform : public Transform
+{
+public:
+  CaptureTransform() : Transform("CaptureTransform") { m_guard = TypeGuard<Entity>(RUN); }
+  EntityPtr operator()(EntityPtr &&entity) override
+  {
+    m_entities.emplace_back(entity);
+    return entity;
+  }
+
+  EntityList m_entities;
+};
+
 class MTConnectXmlTransformTest : public testing::Test
 {
 protected:
@@ -79,7 +92,8 @@ protected:
     m_context = make_shared<PipelineContext>();
     m_context->m_contract = make_unique<MockPipelineContract>(m_device);
     m_xform = make_shared<MTConnectXmlTransform>(m_context, m_feedback);
-    m_xform->bind(make_shared<NullTransform>(TypeGuard<Entity>(RUN)));
+    m_capture = make_shared<CaptureTransform>();
+    m_xform->bind(m_capture);
   }
 
   void TearDown() override { m_xform.reset(); }
@@ -87,6 +101,7 @@ protected:
   pipeline::XmlTransformFeedback m_feedback;
   DevicePtr m_device;
   shared_ptr<MTConnectXmlTransform> m_xform;
+  shared_ptr<CaptureTransform> m_capture;
   shared_ptr<PipelineContext> m_context;
 };
 
@@ -156,3 +171,63 @@ TEST_F(MTConnectXmlTransformTest, should_throw_when_instances_change)
   ASSERT_EQ(1649989201, m_feedback.m_instanceId);
   ASSERT_EQ(4992049, m_feedback.m_next);
 }
+
+TEST_F(MTConnectXmlTransformTest, should_not_deliver_or_advance_for_a_truncated_document)
+{
+  string first {R"(<?xml version="1.0" encoding="UTF-8"?>
+<MTConnectStreams xmlns:m="urn:mtconnect.org:MTConnectStreams:1.7" xmlns="urn:mtconnect.org:MTConnectStreams:1.7" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xsi:schemaLocation="urn:mtconnect.org:MTConnectStreams:1.7 /schemas/MTConnectStreams_1.7.xsd">
+  <Header creationTime="2022-04-21T05:54:56Z" sender="IntelAgent" instanceId="1649989201" version="2.0.0.1" deviceModelChangeTime="2022-04-21T03:21:32.630619Z" bufferSize="131072" nextSequence="4992049" firstSequence="4860977" lastSequence="4992048"/>
+  <Streams>
+    <DeviceStream name="LinuxCNC" uuid="000">
+      <ComponentStream component="Rotary" componentId="c">
+        <Samples>
+          <SpindleSpeed dataItemId="c1" timestamp="2022-04-21T05:54:55Z" name="Sspeed" sequence="4992048" subType="ACTUAL">100</SpindleSpeed>
+        </Samples>
+      </ComponentStream>
+    </DeviceStream>
+  </Streams>
+</MTConnectStreams>
+)"};
+
+  auto entity = make_shared<Entity>("Data", Properties {{"VALUE", first}, {"source", "adapter"s}});
+  (*m_xform)(std::move(entity));
+  ASSERT_EQ(4992049, m_feedback.m_next);
+  ASSERT_EQ(1, m_capture->m_entities.size());
+  m_capture->m_entities.clear();
+
+  // The second document ends after two complete observations
+  string truncated {R"(<?xml version="1.0" encoding="UTF-8"?>
+<MTConnectStreams xmlns:m="urn:mtconnect.org:MTConnectStreams:1.7" xmlns="urn:mtconnect.org:MTConnectStreams:1.7" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xsi:schemaLocation="urn:mtconnect.org:MTConnectStreams:1.7 /schemas/MTConnectStreams_1.7.xsd">
+  <Header creationTime="2022-04-21T05:54:57Z" sender="IntelAgent" instanceId="1649989201" version="2.0.0.1" deviceModelChangeTime="2022-04-21T03:21:32.630619Z" bufferSize="131072" nextSequence="4992052" firstSequence="4860980" lastSequence="4992051"/>
+  <Streams>
+    <DeviceStream name="LinuxCNC" uuid="000">
+      <ComponentStream component="Rotary" componentId="c">
+        <Samples>
+          <SpindleSpeed dataItemId="c1" timestamp="2022-04-21T05:54:56Z" name="Sspeed" sequence="4992049" subType="ACTUAL">200</SpindleSpeed>
+          <SpindleSpeed dataItemId="c1" timestamp="2022-04-21T05:54:56Z" name="Sspeed" sequence="4992050" subType="ACTUAL">300</SpindleSpeed>
+          <SpindleSpeed dataItemId="c1" timestamp="2022-04-21T05:54:56Z" name="Sspeed" sequence="4992051" subT)"};
+
+  entity = make_shared<Entity>("Data", Properties {{"VALUE", truncated}, {"source", "adapter"s}});
+  EXPECT_THROW((*m_xform)(std::move(entity)), std::system_error);
+  ASSERT_EQ(4992049, m_feedback.m_next);
+  ASSERT_EQ(1649989201, m_feedback.m_instanceId);
+  ASSERT_TRUE(m_capture->m_entities.empty());
+
+  // The same for a JSON document that is not valid
+  string json {R"({"MTConnectStreams":{"jsonVersion":2,"schemaVersion":"2.0",
+  "Header":{"creationTime":"2022-04-21T05:54:57Z","sender":"IntelAgent","instanceId":1649989201,
+    "version":"2.0.0.1","bufferSize":131072,"nextSequence":4992052,"firstSequence":4860980,
+    "lastSequence":4992051},
+  "Streams":{"DeviceStream":[{"name":"LinuxCNC","uuid":"000","ComponentStream":[
+    {"component":"Rotary","componentId":"c","Samples":{
+      "SpindleSpeed":[{"value":200,"dataItemId":"c1","sequence":4992049,
+        "timestamp":"2022-04-21T05:54:56Z"},
+        {"value":300,"dataItemId":"c1","sequence":4992050,
+        "timestamp":"2022-04-21T05:54:56Z"},
+        {"value":400,"dataItemId":"c1",,)"};
+
+  entity = make_shared<Entity>("Data", Properties {{"VALUE", json}, {"source", "adapter"s}});
+  EXPECT_THROW((*m_xform)(std::move(entity)), std::system_error);
+  ASSERT_EQ(4992049, m_feedback.m_next);
+  ASSERT_TRUE(m_capture->m_entities.empty());
+}
@@ -203,35 +203,89 @@ TEST_F(ObservationTest, ConditionEventChaining)
   auto dataItem =
       DataItem::make({{"id", "c1"s}, {"category", "CONDITION"s}, {"type", "TEMPERATURE"s}}, errors);
 
-  ConditionPtr event1 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
-  ConditionPtr event2 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
-  ConditionPtr event3 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
+  ConditionPtr event1 = Cond(Observation::make(
+      dataItem, {{"level", "FAULT"s}, {"nativeCode", "A"s}}, m_time, errors));
+  ConditionPtr event2 = Cond(Observation::make(
+      dataItem, {{"level", "FAULT"s}, {"nativeCode", "B"s}}, m_time, errors));
+  ConditionPtr event3 = Cond(Observation::make(
+      dataItem, {{"level", "FAULT"s}, {"nativeCode", "C"s}}, m_time, errors));
 
   ASSERT_TRUE(event1 == event1->getFirst());
 
-  event1->appendTo(event2);
-  ASSERT_TRUE(event1->getFirst() == event2);
+  event2->appendTo(event1);
+  ASSERT_TRUE(event2->getFirst() == event1);
+  ASSERT_TRUE(event2->getPrev() == event1);
 
-  event2->appendTo(event3);
-  ASSERT_TRUE(event1->getFirst() == event3);
+  event3->appendTo(event2);
+  ASSERT_TRUE(event3->getFirst() == event1);
 
-  ASSERT_EQ(1, event1.use_count());
-  ASSERT_EQ(2, event2.use_count());
-  ASSERT_EQ(2, event3.use_count());
+  // event2 has its own active conditions, so event3 holds a copy of event2 without them and
+  // the conditions never form a chain
+  ASSERT_NE(event2, event3->getPrev());
+  ASSERT_EQ("B", event3->getPrev()->getCode());
+  ASSERT_TRUE(event3->getPrev()->getActive().empty());
+  ASSERT_EQ(2, event1.use_count());
+  ASSERT_EQ(1, event2.use_count());
+  ASSERT_EQ(1, event3.use_count());
+
+  ASSERT_EQ(event3->getPrev(), event3->find("B"));
+  ASSERT_EQ(event3, event3->find("C"));
+  ASSERT_FALSE(event3->find("D"));
 
   ConditionList list;
-  event1->getConditionList(list);
+  event3->getConditionList(list);
   ASSERT_EQ(3, list.size());
-  ASSERT_TRUE(list.front() == event3);
-  ASSERT_TRUE(list.back() == event1);
+  ASSERT_TRUE(list.front() == event1);
+  ASSERT_TRUE(list.back() == event3);
 
   ConditionList list2;
   event2->getConditionList(list2);
   ASSERT_EQ(2, list2.size());
-  ASSERT_TRUE(list2.front() == event3);
+  ASSERT_TRUE(list2.front() == event1);
   ASSERT_TRUE(list2.back() == event2);
 }
 
+TEST_F(ObservationTest, condition_state_should_keep_activation_order_when_replacing)
+{
+  ErrorList errors;
+  auto dataItem =
+      DataItem::make({{"id", "c1"s}, {"category", "CONDITION"s}, {"type", "TEMPERATURE"s}}, errors);
+  auto condition = [&](const string &code, const string &level) {
+    return Cond(Observation::make(dataItem, {{"level", level}, {"nativeCode", code}}, m_time,
+                                  errors));
+  };
+
+  ConditionState state;
+  for (int i = 0; i < 50; i++)
+    state.add(condition("C" + to_string(i), "WARNING"s));
+  ASSERT_EQ(50, state.size());
+
+  auto copy = state;
+  auto fault = condition("C10", "FAULT"s);
+  state.add(fault);
+  ASSERT_TRUE(state.erase("C20"));
+  ASSERT_FALSE(state.erase("C20"));
+
+  ASSERT_EQ(49, state.size());
+  ASSERT_EQ(fault, state.find("C10"));
+  ASSERT_EQ(fault, state.last());
+  ASSERT_FALSE(state.find("C20"));
+  ASSERT_EQ("C0", state.first()->getCode());
+
+  ConditionList list;
+  state.getConditionList(list);
+  ASSERT_EQ(49, list.size());
+  ASSERT_EQ("C9", (*next(list.begin(), 9))->getCode());
+  ASSERT_EQ("C11", (*next(list.begin(), 10))->getCode());
+  ASSERT_EQ("C21", (*next(list.begin(), 19))->getCode());
+
+  // The copy is not changed
+  ASSERT_EQ(50, copy.size());
+  ASSERT_EQ(Condition::WARNING, copy.find("C10")->getLevel());
+  ASSERT_TRUE(copy.find("C20"));
+  ASSERT_EQ("C49", copy.last()->getCode());
+}
+
 TEST_F(ObservationTest, subType_prefix_should_be_passed_through)
 {
   ErrorList errors;
@@ -22,11 +22,19 @@
 #include <gtest/gtest.h>
 // Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
 
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
 #include <chrono>
+#include <sstream>
 
 #include "mtconnect/asset/asset.hpp"
 #include "mtconnect/device_model/data_item/data_item.hpp"
 #include "mtconnect/entity/entity.hpp"
+#include "mtconnect/logging.hpp"
 #include "mtconnect/observation/observation.hpp"
 #include "mtconnect/pipeline/json_mapper.hpp"
 #include "mtconnect/pipeline/shdr_token_mapper.hpp"
@@ -141,6 +149,36 @@ TEST_F(ObservationValidationTest, should_detect_invalid_value)
   ASSERT_EQ("INVALID", quality);
 }
 
+/// @test The invalid value is logged from the observation after the value has been checked
+TEST_F(ObservationValidationTest, should_log_the_invalid_value)
+{
+  namespace logr = boost::log;
+  using Backend = logr::sinks::text_ostream_backend;
+
+  auto stream = boost::make_shared<std::ostringstream>();
+  auto backend = boost::make_shared<Backend>();
+  backend->add_stream(stream);
+  auto sink = boost::make_shared<logr::sinks::synchronous_sink<Backend>>(backend);
+  sink->set_formatter(logr::expressions::stream << logr::expressions::smessage);
+
+  auto level = logging::MinimumLevel.load();
+  logging::MinimumLevel = logr::trivial::warning;
+  logr::core::get()->add_sink(sink);
+
+  ErrorList errors;
+  auto event = Observation::make(m_dataItem, {{"VALUE", "FLABOR"s}}, m_time, errors);
+  auto evt = (*m_validator)(std::move(event));
+
+  logr::core::get()->remove_sink(sink);
+  sink->flush();
+  logging::MinimumLevel = level;
+
+  ASSERT_EQ("INVALID", evt->get<string>("quality"));
+  auto log = stream->str();
+  ASSERT_NE(string::npos, log.find("DataItem 'exec': Invalid value for")) << log;
+  ASSERT_NE(string::npos, log.find(": 'FLABOR'")) << log;
+}
+
 /// @test Unknown types should be unverifiable
 TEST_F(ObservationValidationTest, should_not_validate_unknown_type)
 {
@@ -155,6 +193,24 @@ TEST_F(ObservationValidationTest, should_not_validate_unknown_type)
   ASSERT_EQ("UNVERIFIABLE", quality);
 }
 
+/// @test Data items should resolve their controlled vocabulary when they are created
+TEST_F(ObservationValidationTest, should_resolve_controlled_vocabulary_for_data_item)
+{
+  auto vocab = m_dataItem->getControlledVocabulary();
+  ASSERT_NE(nullptr, vocab);
+  ASSERT_EQ(1, vocab->count("READY"));
+  ASSERT_EQ(0, vocab->count("FLABOR"));
+
+  ErrorList errors;
+  auto unknown =
+      DataItem::make({{"id", "flab"s}, {"category", "EVENT"s}, {"type", "x:FLABOR"s}}, errors);
+  ASSERT_EQ(nullptr, unknown->getControlledVocabulary());
+
+  auto sample =
+      DataItem::make({{"id", "pos"s}, {"category", "SAMPLE"s}, {"type", "POSITION"s}}, errors);
+  ASSERT_EQ(nullptr, sample->getControlledVocabulary());
+}
+
 /// @test Tag deprecated values
 TEST_F(ObservationValidationTest, should_set_deprecated_flag_when_deprecated)
 {
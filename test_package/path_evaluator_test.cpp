@@ -0,0 +1,120 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include "mtconnect/device_model/path_evaluator.hpp"
+#include "mtconnect/parser/xml_parser.hpp"
+#include "mtconnect/printer/xml_printer.hpp"
+#include "test_utilities.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace device_model;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class PathEvaluatorTest : public testing::Test
+{
+protected:
+  void SetUp() override { load("test_config.xml"); }
+
+  void load(const string &file)
+  {
+    printer::XmlPrinter printer;
+    m_xmlParser = make_unique<parser::XmlParser>();
+    m_devices = m_xmlParser->parseFile(TEST_RESOURCE_DIR "/samples/" + file, &printer);
+    m_xmlParser->loadDocument(printer.printProbe(0, 0, 0, 0, 0, m_devices));
+  }
+
+  FilterSet evaluate(const string &path)
+  {
+    auto evaluator = PathEvaluator::compile(path);
+    EXPECT_TRUE(evaluator) << "Could not compile: " << path;
+    FilterSet filter;
+    if (evaluator)
+      evaluator->evaluate(m_devices, filter);
+    return filter;
+  }
+
+  FilterSet xpath(const string &path)
+  {
+    FilterSet filter;
+    m_xmlParser->getDataItems(filter, path);
+    return filter;
+  }
+
+  unique_ptr<parser::XmlParser> m_xmlParser;
+  list<DevicePtr> m_devices;
+};
+
+TEST_F(PathEvaluatorTest, should_select_data_items_like_xpath)
+{
+  ASSERT_EQ((size_t)13, evaluate("//Linear").size());
+  ASSERT_EQ((size_t)3, evaluate("//Linear//DataItem[@category='CONDITION']").size());
+  ASSERT_EQ((size_t)0, evaluate("//Controller/electric/*").size());
+  ASSERT_EQ((size_t)2, evaluate("//Device/DataItems").size());
+  ASSERT_EQ((size_t)2, evaluate(R"(//Rotary[@name="C"]//DataItem[@type="LOAD"])").size());
+  ASSERT_EQ(
+      (size_t)5,
+      evaluate(R"(//Rotary[@name="C"]//DataItem[@category="CONDITION" or @category="SAMPLE"])")
+          .size());
+
+  for (const auto &path :
+       {"//Linear"s, "//Devices/Device"s, "//Devices/Device|//Devices/Agent"s,
+        "//Devices/Device[@uuid=\"000\"]//Axes"s, "//Devices/Device//DataItem[@type='EXECUTION']"s,
+        "//m:Rotary[@name='C' and @id!='c']/DataItems"s, "Devices/Device/Components/*"s,
+        "//DataItem[@type='POSITION'][@subType='ACTUAL']|//Controller"s})
+  {
+    ASSERT_EQ(xpath(path), evaluate(path)) << "Path: " << path;
+  }
+
+  ASSERT_EQ(evaluate("//Linear//DataItem"), evaluate("//Linear/descendant::DataItem"));
+  ASSERT_EQ(evaluate("//Linear"), evaluate("//Linear/."));
+  ASSERT_EQ(evaluate("//Device/DataItems"), evaluate("//Device/DataItems/child::DataItem"));
+}
+
+TEST_F(PathEvaluatorTest, should_follow_component_and_data_item_references)
+{
+  load("reference_example.xml");
+
+  auto filter = evaluate("//BarFeederInterface");
+  ASSERT_EQ((size_t)5, filter.size());
+  ASSERT_EQ((size_t)1, filter.count("mf"));
+  ASSERT_EQ((size_t)1, filter.count("c4"));
+  ASSERT_EQ((size_t)1, filter.count("bfc"));
+  ASSERT_EQ((size_t)1, filter.count("d2"));
+  ASSERT_EQ((size_t)1, filter.count("eps"));
+}
+
+TEST_F(PathEvaluatorTest, should_not_compile_unsupported_expressions)
+{
+  ASSERT_FALSE(PathEvaluator::compile("//Device/DataItems/"));
+  ASSERT_FALSE(PathEvaluator::compile("//Device//x:Pump"));
+  ASSERT_FALSE(PathEvaluator::compile("//DataItem[1]"));
+  ASSERT_FALSE(PathEvaluator::compile("//DataItem/.."));
+  ASSERT_FALSE(PathEvaluator::compile("//DataItem[contains(@type, 'POS')]"));
+  ASSERT_FALSE(PathEvaluator::compile("//DataItem/@id"));
+  ASSERT_FALSE(PathEvaluator::compile("//parent::Device"));
+}
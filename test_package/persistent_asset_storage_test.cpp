@@ -0,0 +1,149 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <filesystem>
+
+#include "mtconnect/asset/persistent_asset_storage.hpp"
+#include "mtconnect/entity/entity.hpp"
+#include "test_utilities.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::entity;
+using namespace mtconnect::asset;
+namespace fs = std::filesystem;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class PersistentAssetStorageTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = fs::temp_directory_path() / "mtc_asset_storage_test";
+    fs::remove_all(m_directory);
+  }
+
+  void TearDown() override
+  {
+    m_storage.reset();
+    fs::remove_all(m_directory);
+  }
+
+  void open(size_t max = 10, size_t resident = 16 * 1024)
+  {
+    m_storage.reset();
+    m_storage = make_unique<PersistentAssetStorage>(m_directory, max, resident);
+  }
+
+  AssetPtr makeAsset(const string &type, const string &uuid, const string &device)
+  {
+    ErrorList errors;
+    Properties props {
+        {"assetId", uuid}, {"deviceUuid", device}, {"timestamp", "2020-12-01T12:00:00Z"s}};
+    auto asset = dynamic_pointer_cast<Asset>(Asset::getFactory()->make(type, props, errors));
+    EXPECT_EQ(0, errors.size());
+    return asset;
+  }
+
+  fs::path m_directory;
+  unique_ptr<PersistentAssetStorage> m_storage;
+};
+
+TEST_F(PersistentAssetStorageTest, should_restore_assets_after_reopening)
+{
+  open();
+  for (int i = 0; i < 5; i++)
+    m_storage->addAsset(makeAsset(i < 3 ? "Asset1" : "Asset2", "A" + to_string(i),
+                                  "D" + to_string(i % 2)));
+  m_storage->removeAsset("A1");
+  m_storage->addAsset(makeAsset("Asset1", "A0", "D0"));
+
+  open();
+  ASSERT_EQ(5, m_storage->getCount(false));
+  ASSERT_EQ(4, m_storage->getCount());
+  ASSERT_EQ(2, m_storage->getCountForType("Asset1"));
+  ASSERT_EQ(2, m_storage->getCountForType("Asset2"));
+  ASSERT_EQ(2, m_storage->getCountForDeviceAndType("D0", "Asset1"));
+  ASSERT_EQ(1, m_storage->getCountForDevice("D1"));
+
+  auto a1 = m_storage->getAsset("A1");
+  ASSERT_TRUE(a1);
+  ASSERT_TRUE(a1->isRemoved());
+
+  AssetList list;
+  m_storage->getAssets(list, 10);
+  ASSERT_EQ(4, list.size());
+  ASSERT_EQ("A0", list.front()->getAssetId());
+  ASSERT_EQ("A2", list.back()->getAssetId());
+}
+
+TEST_F(PersistentAssetStorageTest, should_page_large_assets_from_the_log)
+{
+  open(3, 0);
+  m_storage->addAsset(makeAsset("Asset1", "A1", "D1"));
+  m_storage->addAsset(makeAsset("Asset1", "A2", "D1"));
+  m_storage->removeAsset("A2");
+
+  auto a1 = m_storage->getAsset("A1");
+  ASSERT_TRUE(a1);
+  ASSERT_EQ("D1", *a1->getDeviceUuid());
+  ASSERT_EQ("Asset1", a1->getType());
+  ASSERT_EQ(a1, m_storage->getAsset("A1"));
+
+  auto a2 = m_storage->getAsset("A2");
+  ASSERT_TRUE(a2->isRemoved());
+
+  m_storage->addAsset(makeAsset("Asset1", "A3", "D1"));
+  auto old = m_storage->addAsset(makeAsset("Asset1", "A4", "D1"));
+  ASSERT_TRUE(old);
+  ASSERT_EQ("A1", old->getAssetId());
+  ASSERT_FALSE(m_storage->getAsset("A1"));
+  ASSERT_EQ(3, m_storage->getCount(false));
+}
+
+TEST_F(PersistentAssetStorageTest, should_compact_the_log)
+{
+  open();
+  for (int i = 0; i < 20; i++)
+    m_storage->addAsset(makeAsset("Asset1", "A" + to_string(i % 4), "D1"));
+  m_storage->removeAsset("A3");
+
+  auto size = m_storage->getLogSize();
+  m_storage->compact();
+  ASSERT_GT(size, m_storage->getLogSize());
+  ASSERT_EQ(fs::file_size(m_storage->getPath()), m_storage->getLogSize());
+
+  open();
+  ASSERT_EQ(4, m_storage->getCount(false));
+  ASSERT_EQ(3, m_storage->getCount());
+  ASSERT_TRUE(m_storage->getAsset("A3")->isRemoved());
+
+  AssetList list;
+  m_storage->getAssets(list, 10, false);
+  ASSERT_EQ("A3", list.front()->getAssetId());
+  ASSERT_EQ("A0", list.back()->getAssetId());
+}
@@ -156,6 +156,75 @@ TEST_F(ResponseDocumentTest, should_parse_observations)
   ASSERT_EQ("d_asset_chg", (*aent)->get<string>("dataItemId"));
 }
 
+TEST_F(ResponseDocumentTest, should_stream_observations_to_handler)
+{
+  string data {R"(<?xml version="1.0" encoding="UTF-8"?>
+<MTConnectStreams xmlns:m="urn:mtconnect.org:MTConnectStreams:1.8"
+    xmlns="urn:mtconnect.org:MTConnectStreams:1.8"
+    xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance"
+    xsi:schemaLocation="urn:mtconnect.org:MTConnectStreams:1.8 https://schemas.mtconnect.org/schemas/MTConnectStreams_1.8.xsd">
+    <Header creationTime="2022-04-22T04:06:21Z" sender="IntelAgent" instanceId="1649989201" version="2.0.0.1" deviceModelChangeTime="2022-04-21T21:32:38.042794Z" bufferSize="131072" nextSequence="5741581" firstSequence="5610509" lastSequence="5741580"/>
+    <Streams>
+        <DeviceStream name="LinuxCNC" uuid="000">
+            <ComponentStream componentId="d" component="Device">
+                <Events>
+                    <AssetChanged sequence="5741550" assetType="CuttingTool"
+                        timestamp="2022-04-22T04:06:21Z" dataItemId="d_asset_chg">TOOLABC</AssetChanged>
+                    <AssetRemoved sequence="5741551" assetType="CuttingTool"
+                        timestamp="2022-04-22T04:06:21Z" dataItemId="d_asset_rem">TOOLDEF</AssetRemoved>
+                </Events>
+            </ComponentStream>
+            <ComponentStream componentId="path1" component="Path">
+                <Events>
+                    <ControllerMode name="mode" sequence="5741552" timestamp="2022-04-22T04:06:21Z" dataItemId="px">AUTOMATIC</ControllerMode>
+                </Events>
+            </ComponentStream>
+            <ComponentStream componentId="c" component="Rotary">
+                <Samples>
+                    <RotaryVelocity sequence="5741553" timestamp="2022-04-22T04:06:21Z" dataItemId="c1">1556.33</RotaryVelocity>
+                </Samples>
+            </ComponentStream>
+        </DeviceStream>
+    </Streams>
+</MTConnectStreams>
+)"};
+
+  int headers = 0;
+  EntityList entities;
+  ResponseDocument::Handler handler;
+  handler.m_header = [&](const ResponseDocument &doc) {
+    headers++;
+    ASSERT_EQ(5741581, doc.m_next);
+    ASSERT_EQ(1649989201, doc.m_instanceId);
+    ASSERT_TRUE(entities.empty());
+  };
+  handler.m_entity = [&](EntityPtr &&entity) { entities.emplace_back(std::move(entity)); };
+
+  m_doc.emplace();
+  ASSERT_TRUE(ResponseDocument::parse(data, *m_doc, m_context, handler));
+
+  ASSERT_EQ(1, headers);
+  ASSERT_EQ(ResponseDocument::OBSERVATION, m_doc->m_enityType);
+  ASSERT_TRUE(m_doc->m_entities.empty());
+
+  ASSERT_EQ(3, entities.size());
+  auto ent = entities.begin();
+
+  ASSERT_EQ("AssetCommand", (*ent)->getName());
+  ASSERT_EQ("TOOLDEF", (*ent)->get<string>("assetId"));
+
+  ent++;
+  ASSERT_EQ("ControllerMode", (*ent)->getName());
+  ASSERT_EQ("AUTOMATIC", (*ent)->getValue<string>());
+
+  ent++;
+  ASSERT_EQ("RotaryVelocity", (*ent)->getName());
+  ASSERT_EQ(1556.33, (*ent)->getValue<double>());
+
+  ASSERT_EQ(1, m_doc->m_assetEvents.size());
+  ASSERT_EQ("TOOLABC", m_doc->m_assetEvents.front()->getValue<string>());
+}
+
 TEST_F(ResponseDocumentTest, should_parse_data_sets)
 {
   string data {R"(<?xml version="1.0" encoding="UTF-8"?>
@@ -408,3 +477,78 @@ TEST_F(ResponseDocumentTest, should_parse_legacy_error)
   ASSERT_EQ("OUT_OF_RANGE", error.m_code);
   ASSERT_EQ("'at' must be greater than 4871368", error.m_message);
 }
+
+TEST_F(ResponseDocumentTest, should_parse_json_version_2_observations)
+{
+  string data {R"({"MTConnectStreams":{"jsonVersion":2,"schemaVersion":"2.0",
+  "Header":{"creationTime":"2022-04-22T04:06:21Z","sender":"IntelAgent","instanceId":1649989201,
+    "version":"2.0.0.1","bufferSize":131072,"nextSequence":5741581,"firstSequence":5610509,
+    "lastSequence":5741580},
+  "Streams":{"DeviceStream":[{"name":"LinuxCNC","uuid":"000","ComponentStream":[
+    {"component":"Path","componentId":"path1","Events":{
+      "ControllerMode":[{"dataItemId":"px","name":"mode","sequence":5741552,
+        "timestamp":"2022-04-22T04:06:21Z","value":"AUTOMATIC"}],
+      "VariableDataSet":[{"count":3,"dataItemId":"v1","name":"vars","sequence":5741553,
+        "timestamp":"2022-04-22T04:06:21Z","value":{"X100":66,"X101":"ABC","X103":{"removed":true}}}]}},
+    {"component":"Rotary","componentId":"c","Samples":{
+      "RotaryVelocity":[{"value":1556.33,"dataItemId":"c1","sequence":5741554,
+        "timestamp":"2022-04-22T04:06:21Z"}]}}]}]}}})"};
+
+  int headers = 0;
+  EntityList entities;
+  ResponseDocument::Handler handler;
+  handler.m_header = [&](const ResponseDocument &doc) {
+    headers++;
+    ASSERT_EQ(5741581, doc.m_next);
+    ASSERT_EQ(1649989201, doc.m_instanceId);
+  };
+  handler.m_entity = [&](EntityPtr &&entity) { entities.emplace_back(std::move(entity)); };
+
+  m_doc.emplace();
+  ASSERT_TRUE(ResponseDocument::parseJson(data, *m_doc, m_context, handler));
+
+  ASSERT_EQ(1, headers);
+  ASSERT_EQ(ResponseDocument::OBSERVATION, m_doc->m_enityType);
+  ASSERT_EQ(3, entities.size());
+
+  auto ent = entities.begin();
+  ASSERT_EQ("ControllerMode", (*ent)->getName());
+  ASSERT_EQ("AUTOMATIC", (*ent)->getValue<string>());
+
+  ent++;
+  ASSERT_EQ("VariableDataSet", (*ent)->getName());
+  const auto &ds = (*ent)->getValue<DataSet>();
+  ASSERT_EQ(3, ds.size());
+
+  auto dse = ds.begin();
+  ASSERT_EQ("X100", dse->m_key);
+  ASSERT_EQ(66, get<int64_t>(dse->m_value));
+
+  dse++;
+  ASSERT_EQ("X101", dse->m_key);
+  ASSERT_EQ("ABC", get<string>(dse->m_value));
+
+  dse++;
+  ASSERT_EQ("X103", dse->m_key);
+  ASSERT_TRUE(dse->m_removed);
+
+  ent++;
+  ASSERT_EQ("RotaryVelocity", (*ent)->getName());
+  ASSERT_EQ(1556.33, (*ent)->getValue<double>());
+}
+
+TEST_F(ResponseDocumentTest, should_parse_json_version_2_errors)
+{
+  string data {R"({"MTConnectError":{"jsonVersion":2,"Header":{"instanceId":1649989201,
+    "version":"2.0.0.1","bufferSize":131072},
+    "Errors":{"Error":[{"errorCode":"OUT_OF_RANGE","value":"'at' must be greater than 4871368"}]}}})"};
+
+  m_doc.emplace();
+  ASSERT_TRUE(ResponseDocument::parseJson(data, *m_doc, m_context, ResponseDocument::Handler {}));
+
+  ASSERT_EQ(ResponseDocument::ERRORS, m_doc->m_enityType);
+  ASSERT_EQ(1, m_doc->m_errors.size());
+  auto &error = m_doc->m_errors.front();
+  ASSERT_EQ("OUT_OF_RANGE", error.m_code);
+  ASSERT_EQ("'at' must be greater than 4871368", error.m_message);
+}
@@ -0,0 +1,478 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+/// @file
+/// Micro-benchmarks for the buffer queries, the printers, and the REST service.
+///
+/// Usage: rest_benchmark [--filter <text>] [--min-time <seconds>] [--sizes <n,...>]
+///                       [--buffers <exp,...>] [--csv]
+///
+/// Each benchmark is run for at least the minimum time and reports the iterations, the mean and
+/// p50/p99 latency, and the operations per second. Device models with the given number of data
+/// items are generated for each size. `--csv` prints the results as CSV so runs can be compared
+/// and gated.
+
+#include <boost/asio.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mtconnect/agent.hpp"
+#include "mtconnect/buffer/checkpoint.hpp"
+#include "mtconnect/configuration/async_context.hpp"
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/metrics.hpp"
+#include "mtconnect/pipeline/pipeline_context.hpp"
+#include "mtconnect/printer/json_printer.hpp"
+#include "mtconnect/printer/xml_printer.hpp"
+#include "mtconnect/sink/rest_sink/rest_service.hpp"
+#include "mtconnect/sink/rest_sink/server.hpp"
+#include "mtconnect/sink/rest_sink/session.hpp"
+
+using namespace std;
+using namespace std::literals;
+using namespace mtconnect;
+using namespace mtconnect::observation;
+using namespace mtconnect::sink::rest_sink;
+namespace fs = std::filesystem;
+
+namespace {
+  struct Arguments
+  {
+    string m_filter;
+    double m_minTime {0.5};
+    vector<int> m_sizes {1, 100, 1000, 10000, 50000};
+    vector<int> m_buffers {10, 17};
+    bool m_csv {false};
+  };
+
+  vector<int> parseList(const string &text)
+  {
+    vector<int> list;
+    stringstream str(text);
+    string item;
+    while (getline(str, item, ','))
+      list.push_back(atoi(item.c_str()));
+    return list;
+  }
+
+  // Benchmark harness -----------------------------------------------------------------------
+
+  class Runner
+  {
+  public:
+    Runner(const Arguments &args) : m_args(args)
+    {
+      if (m_args.m_csv)
+        cout << "name,iterations,mean_ns,p50_ns,p99_ns,ops_per_sec,bytes_per_op" << endl;
+      else
+        cout << left << setw(64) << "Benchmark" << right << setw(10) << "Iter" << setw(14)
+             << "Mean(ns)" << setw(14) << "p50(ns)" << setw(14) << "p99(ns)" << setw(14)
+             << "ops/s" << setw(12) << "bytes/op" << endl;
+    }
+
+    /// @brief run a benchmark. The body returns the number of bytes produced.
+    void run(const string &name, const function<size_t()> &body)
+    {
+      if (!m_args.m_filter.empty() && name.find(m_args.m_filter) == string::npos)
+        return;
+
+      // Warm up the caches and any lazily created state
+      for (int i = 0; i < 2; i++)
+        body();
+
+      metrics::Histogram latency;
+      uint64_t iterations = 0;
+      size_t bytes = 0;
+      auto minTime = chrono::duration<double>(m_args.m_minTime);
+      auto start = chrono::steady_clock::now();
+      chrono::steady_clock::duration elapsed {};
+      while (elapsed < minTime || iterations < 10)
+      {
+        auto begin = chrono::steady_clock::now();
+        bytes = body();
+        auto end = chrono::steady_clock::now();
+        latency.record(uint64_t(chrono::duration_cast<chrono::nanoseconds>(end - begin).count()));
+        iterations++;
+        elapsed = end - start;
+      }
+
+      report(name, iterations, latency, elapsed, bytes);
+    }
+
+    /// @brief run a benchmark where the body measures its own latency
+    void runTimed(const string &name, const function<optional<chrono::nanoseconds>()> &body)
+    {
+      if (!m_args.m_filter.empty() && name.find(m_args.m_filter) == string::npos)
+        return;
+
+      metrics::Histogram latency;
+      uint64_t iterations = 0;
+      auto minTime = chrono::duration<double>(m_args.m_minTime);
+      auto start = chrono::steady_clock::now();
+      chrono::steady_clock::duration elapsed {};
+      while (elapsed < minTime || iterations < 10)
+      {
+        auto time = body();
+        if (!time)
+        {
+          cerr << name << ": timed out" << endl;
+          return;
+        }
+        latency.record(uint64_t(time->count()));
+        iterations++;
+        elapsed = chrono::steady_clock::now() - start;
+      }
+
+      report(name, iterations, latency, elapsed, 0);
+    }
+
+  protected:
+    void report(const string &name, uint64_t iterations, const metrics::Histogram &latency,
+                chrono::steady_clock::duration elapsed, size_t bytes)
+    {
+      auto snap = latency.snapshot();
+      auto mean = snap.m_count > 0 ? snap.m_sum / snap.m_count : 0;
+      auto ops = double(iterations) / chrono::duration<double>(elapsed).count();
+
+      if (m_args.m_csv)
+        cout << name << ',' << iterations << ',' << mean << ',' << snap.quantile(0.5) << ','
+             << snap.quantile(0.99) << ',' << fixed << setprecision(1) << ops << ',' << bytes
+             << endl;
+      else
+        cout << left << setw(64) << name << right << setw(10) << iterations << setw(14) << mean
+             << setw(14) << snap.quantile(0.5) << setw(14) << snap.quantile(0.99) << setw(14)
+             << fixed << setprecision(1) << ops << setw(12) << bytes << endl;
+    }
+
+    const Arguments &m_args;
+  };
+
+  // Device model generation -----------------------------------------------------------------
+
+  /// @brief write a device file with `count` data items and return the data item ids
+  vector<string> writeDevices(const fs::path &path, int count)
+  {
+    vector<string> ids;
+    ofstream out(path);
+    out << R"(<?xml version="1.0" encoding="UTF-8"?>
+<MTConnectDevices xmlns="urn:mtconnect.org:MTConnectDevices:2.0">
+  <Header creationTime="2024-01-01T00:00:00Z" sender="localhost" instanceId="1" bufferSize="1024" version="2.0"/>
+  <Devices>
+    <Device uuid="bench" name="bench" id="d">
+      <DataItems>
+        <DataItem type="AVAILABILITY" category="EVENT" id="avail"/>
+      </DataItems>
+      <Components>
+        <Controller id="cont">
+          <DataItems>
+)";
+    for (int i = 0; i < count; i++)
+    {
+      auto id = "di" + to_string(i);
+      out << "            <DataItem id=\"" << id << "\" ";
+      if (i % 2 == 0)
+        out << R"(type="POSITION" category="SAMPLE" units="MILLIMETER"/>)" << '\n';
+      else
+        out << R"(type="PROGRAM" category="EVENT"/>)" << '\n';
+      ids.push_back(id);
+    }
+    out << R"(          </DataItems>
+        </Controller>
+      </Components>
+    </Device>
+  </Devices>
+</MTConnectDevices>
+)";
+    return ids;
+  }
+
+  // In-process REST session -----------------------------------------------------------------
+
+  class BenchSession : public Session
+  {
+  public:
+    using Session::Session;
+
+    void run() override {}
+    void writeResponse(ResponsePtr &&response, Complete complete = nullptr) override
+    {
+      m_status = response->m_status;
+      m_bytes = response->m_body.size();
+      if (complete)
+        complete();
+    }
+    void writeFailureResponse(ResponsePtr &&response, Complete complete = nullptr) override
+    {
+      writeResponse(std::move(response), complete);
+    }
+    void beginStreaming(const std::string &mimeType, Complete complete,
+                        std::optional<std::string> requestId = std::nullopt) override
+    {
+      m_streaming = true;
+      complete();
+    }
+    void writeChunk(const std::string &chunk, Complete complete,
+                    std::optional<std::string> requestId = std::nullopt) override
+    {
+      m_chunks++;
+      m_lastChunk = chrono::steady_clock::now();
+      if (m_streaming)
+        complete();
+    }
+    void close() override { m_streaming = false; }
+    void closeStream() override { m_streaming = false; }
+
+    status m_status {status::ok};
+    size_t m_bytes {0};
+    bool m_streaming {false};
+    uint64_t m_chunks {0};
+    chrono::steady_clock::time_point m_lastChunk;
+  };
+
+  // The agent under test --------------------------------------------------------------------
+
+  class Environment
+  {
+  public:
+    Environment(const fs::path &devices, const vector<string> &ids, int bufferExp)
+      : m_strand(m_context), m_ids(ids)
+    {
+      ConfigOptions options {{configuration::BufferSize, bufferExp},
+                             {configuration::MaxAssets, 1024},
+                             {configuration::CheckpointFrequency, 1000},
+                             {configuration::SchemaVersion, "2.5"s},
+                             {configuration::Port, 0},
+                             {configuration::ServerIp, "127.0.0.1"s},
+                             {configuration::JsonVersion, 2}};
+
+      m_agent = make_unique<Agent>(m_context, devices.string(), options);
+      m_pipelineContext = make_shared<pipeline::PipelineContext>();
+      m_pipelineContext->m_contract = m_agent->makePipelineContract();
+
+      auto contract = m_agent->makeSinkContract();
+      contract->m_pipelineContext = m_pipelineContext;
+      m_rest = make_shared<RestService>(m_context, std::move(contract), options,
+                                        boost::property_tree::ptree {});
+      m_agent->addSink(m_rest);
+      m_agent->initialize(m_pipelineContext);
+      m_agent->initialDataItemObservations();
+
+      m_session = make_shared<BenchSession>([](SessionPtr, RequestPtr) { return true; },
+                                            m_rest->getServer()->getErrorFunction());
+
+      // Fill the buffer, cycling through the data items so every item has a current value
+      size_t fill = max(size_t(1) << bufferExp, ids.size());
+      for (size_t i = 0; i < fill; i++)
+        addObservation(i);
+    }
+
+    ~Environment()
+    {
+      m_agent->stop();
+      m_context.get().poll();
+    }
+
+    void addObservation(size_t i)
+    {
+      const auto &id = m_ids[i % m_ids.size()];
+      auto di = m_agent->getDataItemById(id);
+      entity::ErrorList errors;
+      string value = (i % m_ids.size()) % 2 == 0 ? to_string(double(i) * 0.1) : "P" + to_string(i);
+      auto obs = Observation::make(di, {{"VALUE", value}}, chrono::system_clock::now(), errors);
+      m_agent->receiveObservation(obs);
+    }
+
+    /// @brief a filter with roughly `percent` of the data items
+    FilterSet filter(int percent) const
+    {
+      FilterSet set;
+      size_t step = max<size_t>(1, 100 / max(1, percent));
+      for (size_t i = 0; i < m_ids.size(); i += step)
+        set.insert(m_ids[i]);
+      return set;
+    }
+
+    size_t request(const string &path, const QueryMap &query, const string &accepts = "text/xml")
+    {
+      auto request = make_shared<Request>();
+      request->m_verb = boost::beast::http::verb::get;
+      request->m_path = path;
+      request->m_query = query;
+      request->m_accepts = accepts;
+      m_rest->getServer()->dispatch(m_session, request);
+      return m_session->m_bytes;
+    }
+
+    configuration::AsyncContext m_context;
+    boost::asio::io_context::strand m_strand;
+    vector<string> m_ids;
+    unique_ptr<Agent> m_agent;
+    pipeline::PipelineContextPtr m_pipelineContext;
+    shared_ptr<RestService> m_rest;
+    shared_ptr<BenchSession> m_session;
+  };
+
+  // Benchmarks ------------------------------------------------------------------------------
+
+  void bufferBenchmarks(Runner &runner, Environment &env, const string &suffix)
+  {
+    auto &buffer = env.m_agent->getCircularBuffer();
+    for (int percent : {1, 10, 100})
+    {
+      auto filter = env.filter(percent);
+      runner.run("buffer/getObservations/count=100/select=" + to_string(percent) + "%" + suffix,
+                 [&]() -> size_t {
+                   buffer::SequenceNumber_t end, first;
+                   bool endOfBuffer;
+                   auto list = buffer.getObservations(100, filter, buffer.getFirstSequence(),
+                                                      nullopt, end, first, endOfBuffer);
+                   return list->size();
+                 });
+    }
+  }
+
+  void modelBenchmarks(Runner &runner, Environment &env, const string &suffix)
+  {
+    auto &buffer = env.m_agent->getCircularBuffer();
+    const auto &latest = buffer.getLatest();
+
+    for (int percent : {1, 10, 100})
+    {
+      FilterSetOpt filter;
+      if (percent < 100)
+        filter = env.filter(percent);
+      runner.run("checkpoint/getObservations/select=" + to_string(percent) + "%" + suffix,
+                 [&]() -> size_t {
+                   ObservationList list;
+                   latest.getObservations(list, filter);
+                   return list.size();
+                 });
+    }
+
+    // Printers with each format and version
+    ObservationList observations;
+    latest.getObservations(observations);
+    auto devices = env.m_agent->getDevices();
+
+    vector<pair<string, unique_ptr<printer::Printer>>> printers;
+    printers.emplace_back("xml", make_unique<printer::XmlPrinter>(false, false));
+    printers.emplace_back("json1", make_unique<printer::JsonPrinter>(1, false, false));
+    printers.emplace_back("json2", make_unique<printer::JsonPrinter>(2, false, false));
+    for (auto &[name, printer] : printers)
+    {
+      printer->setSchemaVersion("2.5");
+      runner.run("printer/" + name + "/printSample" + suffix, [&]() -> size_t {
+        ObservationList list = observations;
+        return printer->printSample(1, 1024, buffer.getSequence(), buffer.getFirstSequence(),
+                                    buffer.getSequence() - 1, list)
+            .size();
+      });
+      runner.run("printer/" + name + "/printProbe" + suffix, [&]() -> size_t {
+        return printer->printProbe(1, 1024, buffer.getSequence(), 1024, 0, devices).size();
+      });
+    }
+
+    // In-process requests through the server routing
+    for (auto [name, accepts] : {pair {"xml"s, "text/xml"s}, pair {"json"s, "application/json"s}})
+    {
+      runner.run("rest/" + name + "/current" + suffix,
+                 [&]() -> size_t { return env.request("/current", {}, accepts); });
+      runner.run("rest/" + name + "/sample?count=100" + suffix,
+                 [&]() -> size_t { return env.request("/sample", {{"count", "100"}}, accepts); });
+      runner.run("rest/" + name + "/current?path=//Controller" + suffix, [&]() -> size_t {
+        return env.request("/current", {{"path", "//Controller"}}, accepts);
+      });
+    }
+
+    // Streaming: latency from adding an observation until the chunk containing it is written
+    env.request("/sample", {{"interval", "0"}, {"heartbeat", "10000"}});
+    size_t next = 0;
+    runner.runTimed("rest/xml/stream/latency" + suffix,
+                    [&]() -> optional<chrono::nanoseconds> {
+                      auto chunks = env.m_session->m_chunks;
+                      auto start = chrono::steady_clock::now();
+                      env.addObservation(next++);
+                      auto deadline = start + 1s;
+                      while (env.m_session->m_chunks == chunks)
+                      {
+                        if (chrono::steady_clock::now() > deadline)
+                          return nullopt;
+                        if (env.m_context.get().poll() == 0)
+                          this_thread::yield();
+                      }
+                      return env.m_session->m_lastChunk - start;
+                    });
+    env.m_session->closeStream();
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  Arguments args;
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--filter" && hasValue)
+      args.m_filter = argv[++i];
+    else if (arg == "--min-time" && hasValue)
+      args.m_minTime = atof(argv[++i]);
+    else if (arg == "--sizes" && hasValue)
+      args.m_sizes = parseList(argv[++i]);
+    else if (arg == "--buffers" && hasValue)
+      args.m_buffers = parseList(argv[++i]);
+    else if (arg == "--csv")
+      args.m_csv = true;
+    else
+    {
+      cerr << "Usage: rest_benchmark [--filter <text>] [--min-time <seconds>] [--sizes <n,...>]"
+           << endl
+           << "                      [--buffers <exp,...>] [--csv]" << endl;
+      return 1;
+    }
+  }
+
+  Runner runner(args);
+  auto devices = fs::temp_directory_path() / "rest_benchmark_devices.xml";
+  for (auto size : args.m_sizes)
+  {
+    auto ids = writeDevices(devices, max(1, size));
+    for (size_t b = 0; b < args.m_buffers.size(); b++)
+    {
+      auto exp = args.m_buffers[b];
+      Environment env(devices, ids, exp);
+      auto suffix = "/items=" + to_string(size) + "/buffer=2^" + to_string(exp);
+      bufferBenchmarks(runner, env, suffix);
+
+      // The model benchmarks do not depend on the buffer size
+      if (b == 0)
+        modelBenchmarks(runner, env, "/items=" + to_string(size));
+    }
+  }
+  fs::remove(devices);
+
+  return 0;
+}
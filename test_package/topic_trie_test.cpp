@@ -0,0 +1,123 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <set>
+#include <string>
+
+#include "mtconnect/mqtt/topic_trie.hpp"
+
+using namespace std;
+using namespace mtconnect::mqtt_server;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class TopicTrieTest : public testing::Test
+{
+protected:
+  set<string> matches(const string &topic)
+  {
+    set<string> result;
+    m_trie.match(topic, [&result](const string &sub, int) { result.insert(sub); });
+    return result;
+  }
+
+  TopicTrie<string, int> m_trie;
+};
+
+TEST_F(TopicTrieTest, should_validate_filters)
+{
+  ASSERT_TRUE(decltype(m_trie)::isValidFilter("MTConnect/Current/+"));
+  ASSERT_TRUE(decltype(m_trie)::isValidFilter("#"));
+  ASSERT_TRUE(decltype(m_trie)::isValidFilter("MTConnect/#"));
+  ASSERT_TRUE(decltype(m_trie)::isValidFilter("+/+/"));
+
+  ASSERT_FALSE(decltype(m_trie)::isValidFilter(""));
+  ASSERT_FALSE(decltype(m_trie)::isValidFilter("MTConnect/#/Current"));
+  ASSERT_FALSE(decltype(m_trie)::isValidFilter("MTConnect/Current+"));
+  ASSERT_FALSE(decltype(m_trie)::isValidFilter("MTConnect/#a"));
+}
+
+TEST_F(TopicTrieTest, should_match_exact_and_wildcard_filters)
+{
+  m_trie.insert("MTConnect/Current/000", "exact", 0);
+  m_trie.insert("MTConnect/Current/+", "single", 0);
+  m_trie.insert("MTConnect/+/000", "middle", 0);
+  m_trie.insert("MTConnect/#", "multi", 0);
+  m_trie.insert("#", "all", 0);
+  m_trie.insert("MTConnect/Sample/000", "other", 0);
+  ASSERT_EQ(6, m_trie.size());
+
+  ASSERT_EQ((set<string> {"exact", "single", "middle", "multi", "all"}),
+            matches("MTConnect/Current/000"));
+  ASSERT_EQ((set<string> {"single", "multi", "all"}), matches("MTConnect/Current/001"));
+  ASSERT_EQ((set<string> {"multi", "all"}), matches("MTConnect/Current/000/extra"));
+  ASSERT_EQ((set<string> {"all"}), matches("Other"));
+}
+
+TEST_F(TopicTrieTest, should_match_parent_level_with_multi_level_wildcard)
+{
+  m_trie.insert("MTConnect/Probe/#", "probe", 0);
+  m_trie.insert("MTConnect/Probe/+", "single", 0);
+
+  ASSERT_EQ((set<string> {"probe"}), matches("MTConnect/Probe"));
+  ASSERT_EQ((set<string> {"probe", "single"}), matches("MTConnect/Probe/"));
+  ASSERT_TRUE(matches("MTConnect").empty());
+}
+
+TEST_F(TopicTrieTest, should_not_match_system_topics_with_leading_wildcards)
+{
+  m_trie.insert("#", "all", 0);
+  m_trie.insert("+/broker", "single", 0);
+  m_trie.insert("$SYS/#", "sys", 0);
+
+  ASSERT_EQ((set<string> {"sys"}), matches("$SYS/broker"));
+  ASSERT_EQ((set<string> {"all", "single"}), matches("a/broker"));
+}
+
+TEST_F(TopicTrieTest, should_replace_and_remove_subscriptions)
+{
+  ASSERT_TRUE(m_trie.insert("a/+/c", "one", 0));
+  ASSERT_FALSE(m_trie.insert("a/+/c", "one", 2));
+  ASSERT_TRUE(m_trie.insert("a/b/#", "one", 1));
+  ASSERT_TRUE(m_trie.insert("a/b/c", "two", 1));
+  ASSERT_EQ(3, m_trie.size());
+
+  int qos = -1;
+  m_trie.match("a/x/c", [&qos](const string &, int value) { qos = value; });
+  ASSERT_EQ(2, qos);
+
+  ASSERT_FALSE(m_trie.erase("a/b/c", "one"));
+  ASSERT_TRUE(m_trie.erase("a/b/c", "two"));
+  ASSERT_EQ((set<string> {"one"}), matches("a/b/c"));
+
+  ASSERT_EQ(2, m_trie.erase("one"));
+  ASSERT_TRUE(m_trie.empty());
+  ASSERT_TRUE(matches("a/b/c").empty());
+  ASSERT_TRUE(m_trie.filters("one").empty());
+
+  ASSERT_TRUE(m_trie.insert("a/b/c", "two", 0));
+  ASSERT_EQ((set<string> {"two"}), matches("a/b/c"));
+}